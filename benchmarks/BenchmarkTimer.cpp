@@ -0,0 +1,38 @@
+#include "BenchmarkTimer.h"
+
+#include <QElapsedTimer>
+#include <QString>
+#include <QTextStream>
+
+qint64 BenchmarkTimer::measure(QTextStream &out, const QString &name, int iterations,
+                               const std::function<void()> &task)
+{
+   qint64 bestTime = -1;
+
+   out << name << '\n';
+
+   for (auto i = 0; i < iterations; ++i)
+   {
+      QElapsedTimer timer;
+      timer.start();
+
+      task();
+
+      const auto elapsed = timer.nsecsElapsed();
+
+      if (bestTime < 0 || elapsed < bestTime)
+         bestTime = elapsed;
+
+      out << QString("   Iteration %1: %2 ms").arg(i + 1).arg(toMs(elapsed)) << '\n';
+      out.flush();
+   }
+
+   out << QString("   Best time: %1 ms").arg(toMs(bestTime)) << '\n';
+
+   return bestTime;
+}
+
+QString BenchmarkTimer::toMs(qint64 nsecs)
+{
+   return QString::number(nsecs / 1000000.0, 'f', 2);
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+/****************************************************************************************
+ ** GitQlient is an application to manage and operate one or several Git repositories. With
+ ** GitQlient you will be able to add commits, branches and manage all the options Git provides.
+ ** Copyright (C) 2020  Francesc Martinez
+ **
+ ** LinkedIn: www.linkedin.com/in/cescmm/
+ ** Web: www.francescmm.com
+ **
+ ** This program is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public
+ ** License as published by the Free Software Foundation; either
+ ** version 2 of the License, or (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this library; if not, write to the Free Software
+ ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ***************************************************************************************/
+
+#include <QtGlobal>
+
+#include <functional>
+
+class QString;
+class QTextStream;
+
+/**
+ * @brief The BenchmarkTimer class runs a task several times and prints the time of each run in the standard output.
+ * The best time is the one reported, since the others only add the noise of the rest of the system.
+ *
+ * @class BenchmarkTimer BenchmarkTimer.h "BenchmarkTimer.h"
+ */
+class BenchmarkTimer
+{
+public:
+   /**
+    * @brief Runs @p task the given number of iterations.
+    *
+    * @param out The stream where the times are printed.
+    * @param name The title printed before the times.
+    * @param iterations The number of times @p task is run.
+    * @param task The code to measure.
+    * @return qint64 The best time in nanoseconds.
+    */
+   static qint64 measure(QTextStream &out, const QString &name, int iterations, const std::function<void()> &task);
+
+   /**
+    * @brief Formats a time in nanoseconds as milliseconds with two decimals.
+    */
+   static QString toMs(qint64 nsecs);
+};
@@ -0,0 +1,35 @@
+# Benchmarks of the Git and cache layers, built apart from GitQlient
+CONFIG += console warn_on c++17
+CONFIG -= app_bundle
+
+greaterThan(QT_MINOR_VERSION, 12) {
+!msvc:QMAKE_CXXFLAGS += -Werror
+}
+
+TARGET = GitQlientBenchmarks
+QT -= gui
+QT += core
+DEFINES += QT_DEPRECATED_WARNINGS
+
+INCLUDEPATH += $$PWD
+
+HEADERS += \
+    $$PWD/BenchmarkTimer.h \
+    $$PWD/CommitsMemoryBenchmark.h \
+    $$PWD/GitCatFileBenchmark.h \
+    $$PWD/LanesBenchmark.h \
+    $$PWD/RevisionFilesBenchmark.h
+
+SOURCES += \
+    $$PWD/BenchmarkTimer.cpp \
+    $$PWD/CommitsMemoryBenchmark.cpp \
+    $$PWD/GitCatFileBenchmark.cpp \
+    $$PWD/LanesBenchmark.cpp \
+    $$PWD/RevisionFilesBenchmark.cpp \
+    $$PWD/main.cpp
+
+include($$PWD/../src/git/Git.pri)
+include($$PWD/../src/cache/Cache.pri)
+include($$PWD/../QLogger/QLogger.pri)
+
+INCLUDEPATH += $$PWD/../QLogger
@@ -0,0 +1,277 @@
+#include "CommitsMemoryBenchmark.h"
+
+#include <CommitInfo.h>
+#include <CommitsTable.h>
+#include <LanesBuilder.h>
+#include <lanes.h>
+
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QList>
+#include <QTextStream>
+
+#if defined(__GLIBC__)
+#   include <malloc.h>
+#endif
+
+namespace
+{
+const auto IDENTITIES = 200;
+const auto MERGE_INTERVAL = 20;
+const auto LONG_LOG_INTERVAL = 3;
+const qint64 FIRST_COMMIT_DATE = 1600000000;
+
+#if defined(__GLIBC__)
+const auto HEAP_MEASURED = true;
+#else
+const auto HEAP_MEASURED = false;
+#endif
+
+/**
+ * @brief The fields of a commit as CommitInfo stored them before its layout was reduced.
+ */
+struct LegacyCommit
+{
+   QChar boundaryInfo;
+   QString sha;
+   QStringList parentsSha;
+   QString committer;
+   QString author;
+   QDateTime commitDate;
+   QString shortLog;
+   QString longLog;
+   QString diff;
+   QVector<int> lanes; // LaneType was an int sized enum.
+   References references;
+};
+
+/**
+ * @brief The commits as GitQlient keeps them: the table of commits and the checkpoints of the lanes.
+ */
+struct LoadedHistory
+{
+   CommitsTable commits;
+   QVector<Lanes> checkpoints;
+};
+
+/**
+ * @brief Returns the bytes of heap in use, or 0 if the allocator can't be queried.
+ */
+qint64 heapInUse()
+{
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+   return static_cast<qint64>(mallinfo2().uordblks);
+#elif defined(__GLIBC__)
+   return static_cast<qint64>(static_cast<unsigned int>(mallinfo().uordblks));
+#else
+   return 0;
+#endif
+}
+
+/**
+ * @brief Builds the output of git log -z --log-size for a linear history with a short-lived branch merged every
+ * MERGE_INTERVAL commits, IDENTITIES different authors and a long log in one of every LONG_LOG_INTERVAL commits.
+ */
+QByteArray syntheticLog(int commits)
+{
+   QVector<QByteArray> shas;
+   shas.reserve(commits);
+
+   for (auto i = 0; i < commits; ++i)
+      shas.append(QCryptographicHash::hash(QByteArray::number(i), QCryptographicHash::Sha1).toHex());
+
+   QByteArray log;
+
+   for (auto i = 0; i < commits; ++i)
+   {
+      auto parents = i + 1 < commits ? shas.at(i + 1) : QByteArray();
+
+      if (i % MERGE_INTERVAL == 0 && i + MERGE_INTERVAL / 2 < commits)
+         parents.append(' ').append(shas.at(i + MERGE_INTERVAL / 2));
+
+      const auto identity = QString("Developer %1 <developer%1@example.com>").arg(i % IDENTITIES).toUtf8();
+      const auto shortLog = QString("Fix the handling of case %1 in module %2").arg(i).arg(i % 97).toUtf8();
+      const auto longLog = i % LONG_LOG_INTERVAL == 0
+          ? QByteArray("The change needs a longer explanation, like the ones that describe the reasons of a fix.")
+          : QByteArray();
+
+      QByteArray record;
+      record.append('>').append(shas.at(i)).append('X').append(parents).append('\n');
+      record.append(identity).append('\n').append(identity).append('\n');
+      record.append(QByteArray::number(FIRST_COMMIT_DATE + i * 60)).append('\n');
+      record.append(shortLog).append('\n').append(longLog);
+
+      log.append("log size ").append(QByteArray::number(record.size())).append('\n').append(record);
+
+      if (i + 1 < commits)
+         log.append('\0');
+   }
+
+   return log;
+}
+
+/**
+ * @brief The parser that CommitInfo had before, kept as the baseline.
+ */
+LegacyCommit parseLegacyCommit(const QByteArray &record)
+{
+   LegacyCommit commit;
+   const auto fields = QString::fromUtf8(record).split('\n');
+
+   if (fields.count() > 6)
+   {
+      auto combinedShas = fields.at(1);
+      auto sha = combinedShas.split('X').first();
+      commit.boundaryInfo = sha.at(0);
+      sha.remove(0, 1);
+      commit.sha = sha;
+      combinedShas = combinedShas.remove(0, commit.sha.size() + 1 + 1);
+      commit.parentsSha = combinedShas.trimmed().split(' ', QString::SkipEmptyParts);
+      commit.committer = fields.at(2);
+      commit.author = fields.at(3);
+      commit.commitDate = QDateTime::fromSecsSinceEpoch(fields.at(4).toInt());
+      commit.shortLog = fields.at(5);
+
+      for (auto i = 6; i < fields.count(); ++i)
+         commit.longLog += fields.at(i);
+   }
+
+   return commit;
+}
+
+QVector<LegacyCommit> loadLegacyHistory(const QList<QByteArray> &records)
+{
+   QVector<LegacyCommit> commits;
+   commits.reserve(records.count());
+
+   Lanes lanes;
+
+   for (const auto &record : records)
+   {
+      auto commit = parseLegacyCommit(record);
+      const auto id = ObjectId(commit.sha);
+      QVector<ObjectId> parents;
+
+      for (const auto &parent : qAsConst(commit.parentsSha))
+         parents.append(ObjectId(parent));
+
+      if (lanes.isEmpty())
+         lanes.init(id);
+
+      commit.lanes.resize(lanes.processCommit(id, parents).count());
+      commits.append(std::move(commit));
+   }
+
+   return commits;
+}
+
+/**
+ * @brief Loads the commits in a CommitInfo each, with the identities shared, like the cache stored them before the
+ * table of commits.
+ */
+QVector<CommitInfo> loadCommitObjects(const QList<QByteArray> &records)
+{
+   QVector<CommitInfo> commits;
+   commits.reserve(records.count());
+
+   CommitStringsPool stringsPool;
+
+   for (const auto &record : records)
+   {
+      CommitInfo commit(record);
+      commit.shareStrings(stringsPool);
+      commits.append(std::move(commit));
+   }
+
+   return commits;
+}
+
+LoadedHistory loadHistory(const QList<QByteArray> &records)
+{
+   LoadedHistory history;
+   history.commits.reserve(records.count());
+   history.commits.resize(records.count());
+
+   Lanes lanes;
+   auto row = 0;
+
+   for (const auto &record : records)
+   {
+      const CommitInfo commit(record);
+
+      if (lanes.isEmpty())
+         lanes.init(commit.id());
+
+      if (row % LanesBuilder::CHECKPOINT_INTERVAL == 0)
+         history.checkpoints.append(lanes);
+
+      lanes.advance(commit.id(), commit.parentIds());
+      history.commits.setCommit(row++, commit);
+   }
+
+   history.commits.squeeze();
+
+   return history;
+}
+
+QString perCommit(qint64 bytes, int commits)
+{
+   return QString("%1 bytes per commit").arg(bytes / commits);
+}
+}
+
+int CommitsMemoryBenchmark::run(int commits)
+{
+   QTextStream out(stdout);
+
+   if (commits <= 0)
+   {
+      out << QString("The number of commits must be positive.") << '\n';
+      return 1;
+   }
+
+   const auto records = syntheticLog(commits).split('\0');
+
+   out << QString("Loading a synthetic history of {%1} commits.").arg(records.count()) << '\n';
+
+   if (!HEAP_MEASURED)
+      out << QString("The heap can only be measured with glibc, only the accounted usage is printed.") << '\n';
+
+   if (HEAP_MEASURED)
+   {
+      auto heapStart = heapInUse();
+      auto legacyCommits = loadLegacyHistory(records);
+      const auto legacyUsage = heapInUse() - heapStart;
+
+      legacyCommits.clear();
+      legacyCommits.squeeze();
+
+      heapStart = heapInUse();
+      auto commitObjects = loadCommitObjects(records);
+      const auto objectsUsage = heapInUse() - heapStart;
+
+      commitObjects.clear();
+      commitObjects.squeeze();
+
+      out << QString("Original layout (QString SHAs and logs, QDateTime, lanes of every row): %1")
+                 .arg(perCommit(legacyUsage, commits))
+          << '\n';
+      out << QString("One CommitInfo per commit with shared identities: %1").arg(perCommit(objectsUsage, commits))
+          << '\n';
+      out.flush();
+   }
+
+   const auto heapStart = heapInUse();
+   const auto history = loadHistory(records);
+   const auto usage = heapInUse() - heapStart;
+
+   if (HEAP_MEASURED)
+      out << QString("Table of commits and lanes checkpoints: %1").arg(perCommit(usage, commits)) << '\n';
+
+   out << QString("Accounted by RevisionsCache::memoryReport() for the table: %1")
+              .arg(perCommit(static_cast<qint64>(history.commits.memoryUsage()), commits))
+       << '\n';
+   out << QString("Lanes checkpoints: %1").arg(history.checkpoints.count()) << '\n';
+
+   return 0;
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+/****************************************************************************************
+ ** GitQlient is an application to manage and operate one or several Git repositories. With
+ ** GitQlient you will be able to add commits, branches and manage all the options Git provides.
+ ** Copyright (C) 2020  Francesc Martinez
+ **
+ ** LinkedIn: www.linkedin.com/in/cescmm/
+ ** Web: www.francescmm.com
+ **
+ ** This program is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public
+ ** License as published by the Free Software Foundation; either
+ ** version 2 of the License, or (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this library; if not, write to the Free Software
+ ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ***************************************************************************************/
+
+/**
+ * @brief The CommitsMemoryBenchmark class measures the heap that the loaded history takes. It builds the output of git
+ * log for a synthetic history and loads it three times:
+ *
+ * - With the layout that CommitInfo had originally: QString SHAs and logs, a QDateTime, an unused diff, a copy of the
+ * identities per commit and the lanes of every row stored in the commit.
+ * - With one CommitInfo per commit and the identities shared through the CommitStringsPool, as the cache stored them
+ * before the table of commits.
+ * - The way GitQlient loads it: the commits stored in a CommitsTable and the lanes kept as checkpoints every
+ * LanesBuilder::CHECKPOINT_INTERVAL rows.
+ *
+ * The heap is read from the allocator, so the numbers include its overhead. Where the allocator can't be queried
+ * (only glibc can) the benchmark prints what RevisionsCache::memoryReport() accounts for the table of commits.
+ *
+ * It's run with the -commitsMemory option of GitQlientBenchmarks and prints the results in the standard output.
+ *
+ * @class CommitsMemoryBenchmark CommitsMemoryBenchmark.h "CommitsMemoryBenchmark.h"
+ */
+class CommitsMemoryBenchmark
+{
+public:
+   /**
+    * @brief Runs the benchmark.
+    *
+    * @param commits The number of commits of the synthetic history.
+    * @return int The exit code: 0 if the benchmark was run, 1 if the number of commits is not valid.
+    */
+   static int run(int commits = 100000);
+};
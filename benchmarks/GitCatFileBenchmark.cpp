@@ -0,0 +1,67 @@
+#include "GitCatFileBenchmark.h"
+
+#include <BenchmarkTimer.h>
+#include <GitCatFile.h>
+#include <GitSyncProcess.h>
+
+#include <QElapsedTimer>
+#include <QTextStream>
+
+namespace
+{
+const auto ITERATIONS = 3;
+
+QString perQuery(qint64 nsecs, int queries)
+{
+   return QString("   %1 us/query").arg(nsecs / 1000.0 / queries, 0, 'f', 1);
+}
+}
+
+int GitCatFileBenchmark::run(const QString &repoPath, int queries)
+{
+   QTextStream out(stdout);
+   GitCatFile catFile(repoPath);
+   QElapsedTimer timer;
+
+   timer.start();
+   const auto head = catFile.info("HEAD");
+   const auto startTime = timer.nsecsElapsed();
+
+   if (!head.isValid())
+   {
+      out << QString("The HEAD of the repository {%1} could not be resolved.").arg(repoPath) << '\n';
+      return 1;
+   }
+
+   out << QString("Resolving HEAD {%1} times in {%2}.").arg(queries).arg(repoPath) << '\n';
+   out << QString("Helper start and first query: %1 ms").arg(BenchmarkTimer::toMs(startTime)) << '\n';
+
+   const auto spawnTime
+       = BenchmarkTimer::measure(out, QString("Process per query (git rev-parse HEAD):"), ITERATIONS, [&]() {
+            for (auto i = 0; i < queries; ++i)
+               GitSyncProcess(repoPath).run("git rev-parse HEAD");
+         });
+
+   out << perQuery(spawnTime, queries) << '\n';
+
+   const auto infoTime
+       = BenchmarkTimer::measure(out, QString("Helper (cat-file --batch-check HEAD):"), ITERATIONS, [&]() {
+            for (auto i = 0; i < queries; ++i)
+               catFile.info("HEAD");
+         });
+
+   out << perQuery(infoTime, queries) << '\n';
+
+   const auto contentsTime
+       = BenchmarkTimer::measure(out, QString("Helper (cat-file --batch of the HEAD commit):"), ITERATIONS, [&]() {
+            for (auto i = 0; i < queries; ++i)
+               catFile.contents(head.sha);
+         });
+
+   out << perQuery(contentsTime, queries) << '\n';
+   out << QString("Speed-up of the helper: %1x")
+              .arg(infoTime > 0 ? static_cast<double>(spawnTime) / infoTime : 0.0, 0, 'f', 1)
+       << '\n';
+
+   return 0;
+}
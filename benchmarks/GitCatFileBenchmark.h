@@ -0,0 +1,48 @@
+#pragma once
+
+#pragma once
+
+/****************************************************************************************
+ ** GitQlient is an application to manage and operate one or several Git repositories. With
+ ** GitQlient you will be able to add commits, branches and manage all the options Git provides.
+ ** Copyright (C) 2020  Francesc Martinez
+ **
+ ** LinkedIn: www.linkedin.com/in/cescmm/
+ ** Web: www.francescmm.com
+ **
+ ** This program is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public
+ ** License as published by the Free Software Foundation; either
+ ** version 2 of the License, or (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this library; if not, write to the Free Software
+ ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ***************************************************************************************/
+
+class QString;
+
+/**
+ * @brief The GitCatFileBenchmark class compares the latency of resolving a reference by starting a git process per
+ * query, the way GitBase::run does it, against the long-lived GitCatFile helper. It's run from the command line with
+ * the -catFile option of GitQlientBenchmarks and prints the results in the standard output.
+ *
+ * @class GitCatFileBenchmark GitCatFileBenchmark.h "GitCatFileBenchmark.h"
+ */
+class GitCatFileBenchmark
+{
+public:
+   /**
+    * @brief Runs the benchmark.
+    *
+    * @param repoPath The path of the repository to query.
+    * @param queries The number of queries of each kind.
+    * @return int The exit code: 0 if the benchmark was run, 1 if the repository HEAD could not be resolved.
+    */
+   static int run(const QString &repoPath, int queries = 200);
+};
@@ -0,0 +1,114 @@
+#include "LanesBenchmark.h"
+
+#include <BenchmarkTimer.h>
+#include <LanesBuilder.h>
+#include <lanes.h>
+#include <ObjectId.h>
+#include <PackedLanes.h>
+
+#include <QFile>
+#include <QPair>
+#include <QTextStream>
+#include <QVector>
+
+#include <algorithm>
+
+int LanesBenchmark::run(const QString &topologyFile, int iterations)
+{
+   QTextStream out(stdout);
+   QFile file(topologyFile);
+
+   if (!file.open(QIODevice::ReadOnly))
+   {
+      out << QString("The topology file {%1} could not be opened.").arg(topologyFile) << '\n';
+      return 1;
+   }
+
+   QVector<QPair<ObjectId, QVector<ObjectId>>> commits;
+
+   while (!file.atEnd())
+   {
+      const auto shas = file.readLine().trimmed().split(' ');
+      const auto sha = ObjectId::fromHex(shas.first().constData(), shas.first().length());
+
+      if (sha.isNull())
+         continue;
+
+      QVector<ObjectId> parents;
+
+      for (auto i = 1; i < shas.count(); ++i)
+         parents.append(ObjectId::fromHex(shas.at(i).constData(), shas.at(i).length()));
+
+      commits.append(qMakePair(sha, parents));
+   }
+
+   if (commits.isEmpty())
+   {
+      out << QString("The topology file {%1} has no commits.").arg(topologyFile) << '\n';
+      return 1;
+   }
+
+   out << QString("Replaying {%1} commits {%2} times.").arg(commits.count()).arg(iterations) << '\n';
+
+   auto maxLanes = 0;
+   qint64 totalLanes = 0;
+
+   const auto bestTime = BenchmarkTimer::measure(out, QString("Lanes calculation:"), iterations, [&]() {
+      Lanes lanes;
+      lanes.init(commits.first().first);
+
+      maxLanes = 0;
+      totalLanes = 0;
+
+      for (const auto &commit : qAsConst(commits))
+      {
+         const auto row = lanes.processCommit(commit.first, commit.second);
+
+         maxLanes = std::max(maxLanes, row.count());
+         totalLanes += row.count();
+      }
+   });
+
+   const auto commitsPerSecond = bestTime > 0 ? commits.count() * 1000000000.0 / bestTime : 0.0;
+
+   out << QString("%1 commits/s").arg(commitsPerSecond, 0, 'f', 0) << '\n';
+   out << QString("Lanes: %1 max, %2 average per row")
+              .arg(maxLanes)
+              .arg(static_cast<double>(totalLanes) / commits.count(), 0, 'f', 1)
+       << '\n';
+
+   // The rows as the cache kept them before they were packed: a vector per row, shared by consecutive equal rows.
+   qint64 vectorsSize = 0;
+   qint64 packedSize = 0;
+   QVector<Lane> previousRow;
+   PackedLanes chunk;
+   Lanes lanes;
+   lanes.init(commits.first().first);
+
+   for (auto i = 0; i < commits.count(); ++i)
+   {
+      const auto row = lanes.processCommit(commits.at(i).first, commits.at(i).second);
+
+      vectorsSize += sizeof(QVector<Lane>);
+
+      if (i == 0 || row != previousRow)
+         vectorsSize += sizeof(QArrayData) + row.count() * sizeof(Lane);
+
+      previousRow = row;
+      chunk.append(row);
+
+      if (chunk.count() == LanesBuilder::CHECKPOINT_INTERVAL || i + 1 == commits.count())
+      {
+         chunk.squeeze();
+         packedSize += chunk.memorySize();
+         chunk = PackedLanes();
+      }
+   }
+
+   out << QString("Lanes memory: %1 bytes per row as vectors, %2 bytes per row packed")
+              .arg(static_cast<double>(vectorsSize) / commits.count(), 0, 'f', 1)
+              .arg(static_cast<double>(packedSize) / commits.count(), 0, 'f', 1)
+       << '\n';
+
+   return 0;
+}
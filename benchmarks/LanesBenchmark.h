@@ -0,0 +1,52 @@
+#pragma once
+
+/****************************************************************************************
+ ** GitQlient is an application to manage and operate one or several Git repositories. With
+ ** GitQlient you will be able to add commits, branches and manage all the options Git provides.
+ ** Copyright (C) 2020  Francesc Martinez
+ **
+ ** LinkedIn: www.linkedin.com/in/cescmm/
+ ** Web: www.francescmm.com
+ **
+ ** This program is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public
+ ** License as published by the Free Software Foundation; either
+ ** version 2 of the License, or (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this library; if not, write to the Free Software
+ ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ***************************************************************************************/
+
+class QString;
+
+/**
+ * @brief The LanesBenchmark class measures the lanes calculation without Git or the UI involved. It replays the
+ * topology of a repository recorded with:
+ *
+ * git log --date-order --parents --format=%H > topology.txt
+ *
+ * Besides the commits per second, it prints the memory the lanes of every row take as one vector per row and packed
+ * in chunks of LanesBuilder::CHECKPOINT_INTERVAL rows as the cache stores them.
+ *
+ * It's run with the -lanes option of GitQlientBenchmarks and prints the results in the standard output.
+ *
+ * @class LanesBenchmark LanesBenchmark.h "LanesBenchmark.h"
+ */
+class LanesBenchmark
+{
+public:
+   /**
+    * @brief Runs the benchmark.
+    *
+    * @param topologyFile The file with one commit per line: its SHA followed by the SHAs of its parents.
+    * @param iterations The number of times the whole topology is replayed.
+    * @return int The exit code: 0 if the benchmark was run, 1 if the file could not be read.
+    */
+   static int run(const QString &topologyFile, int iterations = 5);
+};
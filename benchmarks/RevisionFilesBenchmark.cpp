@@ -0,0 +1,211 @@
+#include "RevisionFilesBenchmark.h"
+
+#include <BenchmarkTimer.h>
+#include <FilePathPool.h>
+#include <GitDiffTreeParser.h>
+#include <RevisionFiles.h>
+
+#include <QSet>
+#include <QString>
+#include <QTextStream>
+
+namespace
+{
+const auto FILES_PER_DIRECTORY = 50;
+const auto DIFFERENT_NAMES = 500;
+const auto RENAME_INTERVAL = 100;
+const auto SHA1_LENGTH = 40;
+const auto SHA256_LENGTH = 64;
+
+/**
+ * @brief Builds the output of git diff-tree for a commit that touches @p files files. With @p nulTerminated it's the
+ * -z format of git diff-tree --stdin, that starts with the SHA of the commit and ends with the end of the answer,
+ * otherwise the line based one.
+ */
+QByteArray syntheticDiff(int files, int hashLength, bool nulTerminated)
+{
+   const auto sha = QByteArray(hashLength, 'a');
+   const auto separator = nulTerminated ? '\0' : '\t';
+   const auto terminator = nulTerminated ? '\0' : '\n';
+   QByteArray diff;
+   diff.reserve(files * (2 * hashLength + 70));
+
+   if (nulTerminated)
+      diff.append(QByteArray(hashLength, 'c')).append('\0');
+
+   for (auto i = 0; i < files; ++i)
+   {
+      const auto directory = i / FILES_PER_DIRECTORY;
+      const auto path = QString("vendor/lib%1/src/module%2/file%3.cpp")
+                            .arg(directory / 20)
+                            .arg(directory)
+                            .arg(i % DIFFERENT_NAMES)
+                            .toUtf8();
+
+      diff.append(":100644 100644 " + sha + ' ' + sha + ' ');
+
+      if (i % RENAME_INTERVAL == 0)
+         diff.append("R090" + QByteArray(1, separator) + "old/" + path + separator + path + terminator);
+      else
+         diff.append("M" + QByteArray(1, separator) + path + terminator);
+   }
+
+   if (nulTerminated)
+      diff.append(GitDiffTreeParser::ANSWER_END);
+
+   return diff;
+}
+
+void appendLegacyFileName(RevisionFiles &rf, const QString &name, QSet<FilePathPool::PathId> &files)
+{
+   const auto id = FilePathPool::instance().intern(name);
+
+   if (!files.contains(id))
+   {
+      files.insert(id);
+      rf.appendFile(id);
+   }
+}
+
+void setLegacyExtStatus(RevisionFiles &rf, const QString &rowSt, int parNum, QSet<FilePathPool::PathId> &files)
+{
+   const QStringList sl(rowSt.split('\t', QString::SkipEmptyParts));
+   if (sl.count() != 3)
+      return;
+
+   QString type = sl[0];
+   type.remove(0, 1);
+   const QString &orig = sl[1];
+   const QString &dest = sl[2];
+   const QString extStatusInfo(orig + " --> " + dest + " (" + QString::number(type.toInt()) + "%)");
+
+   appendLegacyFileName(rf, dest, files);
+   rf.mergeParent.append(parNum);
+   rf.setStatus(RevisionFiles::NEW);
+   rf.appendExtStatus(extStatusInfo);
+
+   if (type.at(0) == 'R')
+   {
+      appendLegacyFileName(rf, orig, files);
+      rf.mergeParent.append(parNum);
+      rf.setStatus(RevisionFiles::DELETED);
+      rf.appendExtStatus(extStatusInfo);
+   }
+   rf.setOnlyModified(false);
+}
+
+/**
+ * @brief The parser that was used before the -z format, kept as the baseline. It splits the decoded output in lines
+ * and reads the status and the path at the columns they have with SHA-1 object names.
+ */
+RevisionFiles parseLegacyDiff(const QString &buf)
+{
+   RevisionFiles rf;
+   QSet<FilePathPool::PathId> files;
+   auto parNum = 1;
+   const auto lines = buf.split("\n", QString::SkipEmptyParts);
+
+   for (const auto &line : lines)
+   {
+      if (line[0] == ':')
+      {
+         if (line[1] == ':')
+         {
+            appendLegacyFileName(rf, line.section('\t', -1), files);
+            rf.setStatus("M");
+            rf.mergeParent.append(parNum);
+         }
+         else
+         {
+            if (line.at(98) == '\t')
+            {
+               appendLegacyFileName(rf, line.mid(99), files);
+               rf.setStatus(line.at(97).toLatin1());
+               rf.mergeParent.append(parNum);
+            }
+            else
+               setLegacyExtStatus(rf, line.mid(97), parNum, files);
+         }
+      }
+      else
+         ++parNum;
+   }
+
+   return rf;
+}
+
+/**
+ * @brief Lists the files of the -z output of a single commit the way GitDiffTreeService does it: the output starts
+ * with the SHA of the commit and the parser receives it as it would from git diff-tree --stdin.
+ */
+int parseRawDiff(const QByteArray &diff)
+{
+   GitDiffTreeParser parser;
+   parser.processChunk(diff);
+
+   const auto commits = parser.takeCommits();
+
+   return commits.isEmpty() ? 0 : commits.first().files.count();
+}
+
+/**
+ * @brief Prints the throughput of a parser once it has been measured.
+ */
+void printFilesPerSecond(QTextStream &out, qint64 bestTime, int parsedFiles)
+{
+   const auto filesPerSecond = bestTime > 0 ? parsedFiles * 1000000000.0 / bestTime : 0.0;
+
+   out << QString("   %1 files/s, %2 files listed").arg(filesPerSecond, 0, 'f', 0).arg(parsedFiles) << '\n';
+}
+}
+
+int RevisionFilesBenchmark::run(int files, int iterations)
+{
+   QTextStream out(stdout);
+
+   if (files <= 0)
+   {
+      out << QString("The number of files must be positive.") << '\n';
+      return 1;
+   }
+
+   // The line based output is decoded beforehand since that's how the old parser received it.
+   const auto textDiff = QString::fromUtf8(syntheticDiff(files, SHA1_LENGTH, false));
+   const auto rawDiff = syntheticDiff(files, SHA1_LENGTH, true);
+   const auto rawDiffSha256 = syntheticDiff(files, SHA256_LENGTH, true);
+
+   out << QString("Parsing a diff of {%1} files {%2} times.").arg(files).arg(iterations) << '\n';
+
+   // The paths are interned before measuring so the first parser doesn't pay for filling the pool.
+   parseRawDiff(rawDiff);
+
+   auto legacyFiles = 0;
+   auto rawFiles = 0;
+   auto rawFilesSha256 = 0;
+
+   const auto legacyTime = BenchmarkTimer::measure(out, QString("Line based parser (QString):"), iterations,
+                                                   [&]() { legacyFiles = parseLegacyDiff(textDiff).count(); });
+   printFilesPerSecond(out, legacyTime, legacyFiles);
+
+   const auto rawTime = BenchmarkTimer::measure(out, QString("Raw parser (-z, SHA-1):"), iterations,
+                                                [&]() { rawFiles = parseRawDiff(rawDiff); });
+   printFilesPerSecond(out, rawTime, rawFiles);
+
+   const auto rawTimeSha256 = BenchmarkTimer::measure(out, QString("Raw parser (-z, SHA-256):"), iterations,
+                                                      [&]() { rawFilesSha256 = parseRawDiff(rawDiffSha256); });
+   printFilesPerSecond(out, rawTimeSha256, rawFilesSha256);
+
+   const auto &pool = FilePathPool::instance();
+
+   out << QString("Speed-up of the raw parser: %1x").arg(rawTime > 0 ? 1.0 * legacyTime / rawTime : 0.0, 0, 'f', 2)
+       << '\n';
+   out << QString("Path pool: %1 directories, %2 names").arg(pool.dirsCount()).arg(pool.namesCount()) << '\n';
+
+   if (legacyFiles != rawFiles || rawFiles != rawFilesSha256)
+   {
+      out << QString("The parsers listed a different number of files.") << '\n';
+      return 1;
+   }
+
+   return 0;
+}
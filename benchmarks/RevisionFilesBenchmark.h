@@ -0,0 +1,50 @@
+#pragma once
+
+/****************************************************************************************
+ ** GitQlient is an application to manage and operate one or several Git repositories. With
+ ** GitQlient you will be able to add commits, branches and manage all the options Git provides.
+ ** Copyright (C) 2020  Francesc Martinez
+ **
+ ** LinkedIn: www.linkedin.com/in/cescmm/
+ ** Web: www.francescmm.com
+ **
+ ** This program is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public
+ ** License as published by the Free Software Foundation; either
+ ** version 2 of the License, or (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this library; if not, write to the Free Software
+ ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ***************************************************************************************/
+
+/**
+ * @brief The RevisionFilesBenchmark class measures how long it takes to build the list of files of a revision from the
+ * output of git diff-tree, without Git or the UI involved. It parses a synthetic output with the given number of files
+ * spread across many directories, with file names that repeat between directories and a few renames, like a big
+ * vendor import or a mass reformatting would produce.
+ *
+ * The same diff is parsed by the line based parser that GitQlient used before, kept here as the baseline, from the
+ * decoded output, and by the @ref GitDiffTreeParser from the raw -z output with SHA-1 and with SHA-256 object names.
+ *
+ * It's run with the -revisionFiles option of GitQlientBenchmarks and prints the results in the standard output.
+ *
+ * @class RevisionFilesBenchmark RevisionFilesBenchmark.h "RevisionFilesBenchmark.h"
+ */
+class RevisionFilesBenchmark
+{
+public:
+   /**
+    * @brief Runs the benchmark.
+    *
+    * @param files The number of files of the synthetic diff.
+    * @param iterations The number of times the diff is parsed.
+    * @return int The exit code: 0 if the benchmark was run, 1 if the number of files is not valid.
+    */
+   static int run(int files = 100000, int iterations = 5);
+};
@@ -0,0 +1,31 @@
+#include <QCoreApplication>
+#include <QTextStream>
+
+#include <CommitsMemoryBenchmark.h>
+#include <GitCatFileBenchmark.h>
+#include <LanesBenchmark.h>
+#include <RevisionFilesBenchmark.h>
+
+int main(int argc, char *argv[])
+{
+   // The Git helpers run QProcess, that needs the application to exist.
+   QCoreApplication app(argc, argv);
+   const auto arguments = QCoreApplication::arguments();
+
+   if (const auto benchmarkIdx = arguments.indexOf("-lanes"); benchmarkIdx != -1)
+      return LanesBenchmark::run(arguments.value(benchmarkIdx + 1));
+
+   if (const auto benchmarkIdx = arguments.indexOf("-catFile"); benchmarkIdx != -1)
+      return GitCatFileBenchmark::run(arguments.value(benchmarkIdx + 1));
+
+   if (const auto benchmarkIdx = arguments.indexOf("-revisionFiles"); benchmarkIdx != -1)
+      return RevisionFilesBenchmark::run(arguments.value(benchmarkIdx + 1, "100000").toInt());
+
+   if (const auto benchmarkIdx = arguments.indexOf("-commitsMemory"); benchmarkIdx != -1)
+      return CommitsMemoryBenchmark::run(arguments.value(benchmarkIdx + 1, "100000").toInt());
+
+   QTextStream(stderr) << "Usage: GitQlientBenchmarks -lanes <topology file> | -catFile <repository> | "
+                          "-revisionFiles [files] | -commitsMemory [commits]\n";
+
+   return 1;
+}
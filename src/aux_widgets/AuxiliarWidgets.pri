@@ -11,6 +11,7 @@ HEADERS += \
     $$PWD/ClickableFrame.h \
     $$PWD/ConflictButton.h \
     $$PWD/CreateRepoDlg.h \
+    $$PWD/GitDiagnosticsDlg.h \
     $$PWD/ProgressDlg.h \
     $$PWD/PullDlg.h \
     $$PWD/RepoConfigDlg.h
@@ -20,6 +21,7 @@ SOURCES += \
     $$PWD/ClickableFrame.cpp \
     $$PWD/ConflictButton.cpp \
     $$PWD/CreateRepoDlg.cpp \
+    $$PWD/GitDiagnosticsDlg.cpp \
     $$PWD/ProgressDlg.cpp \
     $$PWD/PullDlg.cpp \
     $$PWD/RepoConfigDlg.cpp
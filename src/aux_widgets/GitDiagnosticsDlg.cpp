@@ -0,0 +1,147 @@
+#include "GitDiagnosticsDlg.h"
+
+#include <GitCommandTrace.h>
+#include <GitQlientStyles.h>
+#include <RevisionsCache.h>
+
+#include <QFileDialog>
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QLabel>
+#include <QMap>
+#include <QMessageBox>
+#include <QPushButton>
+#include <QTreeWidget>
+#include <QVBoxLayout>
+
+namespace
+{
+struct Summary
+{
+   int count = 0;
+   int failed = 0;
+   qint64 totalTime = 0;
+   qint64 maxTime = 0;
+   qint64 spawnTime = 0;
+   qint64 bytesRead = 0;
+};
+
+enum Column
+{
+   Subsystem,
+   Command,
+   Count,
+   Failed,
+   Total,
+   Average,
+   Max,
+   Spawn,
+   Bytes
+};
+
+double toMilliseconds(qint64 nanoseconds)
+{
+   return qRound64(nanoseconds / 1e5) / 10.0;
+}
+
+/**
+ * @brief Returns the git sub-command: "git log" for "git log --graph ...".
+ */
+QString commandVerb(const QByteArray &command)
+{
+   const auto words = QString::fromUtf8(command).split(' ', QString::SkipEmptyParts);
+   return words.mid(0, 2).join(' ');
+}
+}
+
+GitDiagnosticsDlg::GitDiagnosticsDlg(const QSharedPointer<RevisionsCache> &cache, QWidget *parent)
+   : QDialog(parent)
+   , mCache(cache)
+   , mSummary(new QTreeWidget())
+   , mMemory(new QLabel())
+{
+   setAttribute(Qt::WA_DeleteOnClose);
+   setWindowTitle(tr("Git commands diagnostics"));
+   setStyleSheet(GitQlientStyles::getStyles());
+   resize(900, 500);
+
+   mSummary->setRootIsDecorated(false);
+   mSummary->setSortingEnabled(true);
+   mSummary->setHeaderLabels({ tr("Subsystem"), tr("Command"), tr("Calls"), tr("Failed"), tr("Total (ms)"),
+                               tr("Average (ms)"), tr("Max (ms)"), tr("Spawn avg. (ms)"), tr("Bytes read") });
+   mSummary->header()->setSectionResizeMode(QHeaderView::ResizeToContents);
+
+   mMemory->setWordWrap(true);
+   mMemory->setTextInteractionFlags(Qt::TextSelectableByMouse);
+
+   const auto refreshBtn = new QPushButton(tr("Refresh"));
+   const auto exportBtn = new QPushButton(tr("Export trace..."));
+   const auto closeBtn = new QPushButton(tr("Close"));
+
+   const auto buttonsLayout = new QHBoxLayout();
+   buttonsLayout->addWidget(refreshBtn);
+   buttonsLayout->addWidget(exportBtn);
+   buttonsLayout->addStretch();
+   buttonsLayout->addWidget(closeBtn);
+
+   const auto layout = new QVBoxLayout(this);
+   layout->addWidget(mSummary);
+   layout->addWidget(mMemory);
+   layout->addLayout(buttonsLayout);
+
+   connect(refreshBtn, &QPushButton::clicked, this, &GitDiagnosticsDlg::refresh);
+   connect(exportBtn, &QPushButton::clicked, this, &GitDiagnosticsDlg::exportTrace);
+   connect(closeBtn, &QPushButton::clicked, this, &GitDiagnosticsDlg::close);
+
+   refresh();
+}
+
+void GitDiagnosticsDlg::refresh()
+{
+   QMap<QPair<QString, QString>, Summary> summaries;
+
+   for (const auto &record : GitCommandTrace::records())
+   {
+      const auto subsystem = record.subsystem ? QString::fromUtf8(record.subsystem) : tr("Unknown");
+      auto &summary = summaries[qMakePair(subsystem, commandVerb(record.command))];
+
+      ++summary.count;
+      summary.failed += record.exitCode != 0 || record.crashed;
+      summary.totalTime += record.wallTime;
+      summary.maxTime = qMax(summary.maxTime, record.wallTime);
+      summary.spawnTime += record.spawnTime;
+      summary.bytesRead += record.bytesRead;
+   }
+
+   mSummary->setSortingEnabled(false);
+   mSummary->clear();
+
+   for (auto iter = summaries.cbegin(); iter != summaries.cend(); ++iter)
+   {
+      const auto &summary = iter.value();
+      const auto item = new QTreeWidgetItem(mSummary);
+      item->setText(Subsystem, iter.key().first);
+      item->setText(Command, iter.key().second);
+      item->setData(Count, Qt::DisplayRole, summary.count);
+      item->setData(Failed, Qt::DisplayRole, summary.failed);
+      item->setData(Total, Qt::DisplayRole, toMilliseconds(summary.totalTime));
+      item->setData(Average, Qt::DisplayRole, toMilliseconds(summary.totalTime / summary.count));
+      item->setData(Max, Qt::DisplayRole, toMilliseconds(summary.maxTime));
+      item->setData(Spawn, Qt::DisplayRole, toMilliseconds(summary.spawnTime / summary.count));
+      item->setData(Bytes, Qt::DisplayRole, summary.bytesRead);
+   }
+
+   mSummary->setSortingEnabled(true);
+   mSummary->sortByColumn(Total, Qt::DescendingOrder);
+
+   mMemory->setText(tr("Revisions cache: %1").arg(mCache->memoryReport()));
+}
+
+void GitDiagnosticsDlg::exportTrace()
+{
+   const auto fileName
+       = QFileDialog::getSaveFileName(this, tr("Export trace"), "gitqlient-trace.json", tr("Trace files (*.json)"));
+
+   if (!fileName.isEmpty() && !GitCommandTrace::exportChromeTrace(fileName))
+      QMessageBox::warning(this, tr("Export trace"), tr("The trace couldn't be written to %1.").arg(fileName));
+}
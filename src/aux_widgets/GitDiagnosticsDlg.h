@@ -0,0 +1,69 @@
+#pragma once
+
+/****************************************************************************************
+ ** GitQlient is an application to manage and operate one or several Git repositories. With
+ ** GitQlient you will be able to add commits, branches and manage all the options Git provides.
+ ** Copyright (C) 2020  Francesc Martinez
+ **
+ ** LinkedIn: www.linkedin.com/in/cescmm/
+ ** Web: www.francescmm.com
+ **
+ ** This program is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public
+ ** License as published by the Free Software Foundation; either
+ ** version 2 of the License, or (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this library; if not, write to the Free Software
+ ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ***************************************************************************************/
+
+#include <QDialog>
+#include <QSharedPointer>
+
+class QLabel;
+class QTreeWidget;
+class RevisionsCache;
+
+/**
+ * @brief The GitDiagnosticsDlg class shows how much time the git commands took since the application started. The
+ * commands are grouped by the subsystem that launched them and by the git sub-command. The raw records can be exported
+ * as a Chrome trace to inspect them in a timeline. It also shows how much memory the revisions cache of the repository
+ * uses, which is only measured when the dialog asks for it.
+ *
+ * The dialog is not reachable from the menus: it's opened with Ctrl+Shift+D from the repository view.
+ *
+ * @class GitDiagnosticsDlg GitDiagnosticsDlg.h "GitDiagnosticsDlg.h"
+ */
+class GitDiagnosticsDlg : public QDialog
+{
+   Q_OBJECT
+
+public:
+   /**
+    * @brief Default constructor.
+    *
+    * @param cache The revisions cache of the repository.
+    * @param parent The parent widget if needed.
+    */
+   explicit GitDiagnosticsDlg(const QSharedPointer<RevisionsCache> &cache, QWidget *parent = nullptr);
+
+private:
+   QSharedPointer<RevisionsCache> mCache;
+   QTreeWidget *mSummary = nullptr;
+   QLabel *mMemory = nullptr;
+
+   /**
+    * @brief Fills the summary table with the records currently stored and measures the memory of the cache.
+    */
+   void refresh();
+   /**
+    * @brief Asks for a file and exports the records in the Chrome trace-event format.
+    */
+   void exportTrace();
+};
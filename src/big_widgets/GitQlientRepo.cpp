@@ -8,7 +8,6 @@
 #include <QLogger.h>
 #include <BlameWidget.h>
 #include <CommitInfo.h>
-#include <ProgressDlg.h>
 #include <GitConfigDlg.h>
 #include <Controls.h>
 #include <HistoryWidget.h>
@@ -16,19 +15,19 @@
 #include <MergeWidget.h>
 #include <RevisionsCache.h>
 #include <GitRepoLoader.h>
+#include <GitRepoWatcher.h>
 #include <GitConfig.h>
 #include <GitBase.h>
 #include <GitHistory.h>
+#include <GitDiagnosticsDlg.h>
 
 #include <QTimer>
-#include <QDirIterator>
-#include <QFileSystemWatcher>
 #include <QFileDialog>
 #include <QMessageBox>
 #include <QStackedWidget>
 #include <QGridLayout>
-#include <QApplication>
 #include <QStackedLayout>
+#include <QShortcut>
 
 using namespace QLogger;
 
@@ -45,6 +44,7 @@ GitQlientRepo::GitQlientRepo(const QString &repoPath, QWidget *parent)
    , mMergeWidget(new MergeWidget(mGitQlientCache, mGitBase))
    , mAutoFetch(new QTimer())
    , mAutoFilesUpdate(new QTimer())
+   , mGitWatcher(new GitRepoWatcher(mGitBase, this))
 {
    setAttribute(Qt::WA_DeleteOnClose);
 
@@ -71,6 +71,13 @@ GitQlientRepo::GitQlientRepo(const QString &repoPath, QWidget *parent)
    connect(mAutoFetch, &QTimer::timeout, mControls, &Controls::fetchAll);
    connect(mAutoFilesUpdate, &QTimer::timeout, this, &GitQlientRepo::updateUiFromWatcher);
 
+   connect(mGitWatcher, &GitRepoWatcher::signalReferencesChanged, this, &GitQlientRepo::updateCache);
+   connect(mGitWatcher, &GitRepoWatcher::signalWorkingTreeChanged, this, [this]() {
+      // The polling is only a fallback, so it waits for a quiet period after any change the watcher reports.
+      mAutoFilesUpdate->start();
+      updateUiFromWatcher();
+   });
+
    connect(mControls, &Controls::signalGoRepo, this, &GitQlientRepo::showHistoryView);
    connect(mControls, &Controls::signalGoBlame, this, &GitQlientRepo::showBlameView);
    connect(mControls, &Controls::signalGoDiff, this, &GitQlientRepo::showDiffView);
@@ -112,15 +119,23 @@ GitQlientRepo::GitQlientRepo(const QString &repoPath, QWidget *parent)
    connect(mMergeWidget, &MergeWidget::signalMergeFinished, mControls, &Controls::disableMergeWarning);
    connect(mMergeWidget, &MergeWidget::signalEditFile, this, &GitQlientRepo::signalEditFile);
 
-   connect(mGitLoader.data(), &GitRepoLoader::signalLoadingStarted, this, &GitQlientRepo::createProgressDialog,
+   connect(mGitLoader.data(), &GitRepoLoader::signalLoadingStarted, this, &GitQlientRepo::onRepoLoadStarted,
            Qt::DirectConnection);
-   connect(mGitLoader.data(), &GitRepoLoader::signalLoadingStep, this, &GitQlientRepo::updateProgressDialog,
+   connect(mGitLoader.data(), &GitRepoLoader::signalLoadingStep, this, &GitQlientRepo::onRepoLoadStep,
            Qt::DirectConnection);
    connect(mGitLoader.data(), &GitRepoLoader::signalLoadingFinished, this, &GitQlientRepo::onRepoLoadFinished,
            Qt::DirectConnection);
+   connect(mGitLoader.data(), &GitRepoLoader::signalRevisionsInserted, this, &GitQlientRepo::onRevisionsInserted);
+   connect(mGitLoader.data(), &GitRepoLoader::signalWipRevisionUpdated, this, &GitQlientRepo::onWipRevisionUpdated);
+   connect(mGitLoader.data(), &GitRepoLoader::signalBranchDistancesUpdated, mHistoryWidget,
+           &HistoryWidget::updateBranchDistances);
+
+   const auto diagnosticsShortcut = new QShortcut(QKeySequence("Ctrl+Shift+D"), this);
+   connect(diagnosticsShortcut, &QShortcut::activated, this, &GitQlientRepo::showDiagnostics);
 
    GitQlientSettings settings;
    mGitLoader->setShowAll(settings.value("ShowAllBranches", true).toBool());
+   mGitQlientCache->setRevisionFilesBudget(settings.value("revisionFilesCacheMB", 64).toLongLong() * 1024 * 1024);
 
    setRepository(repoPath);
 }
@@ -153,7 +168,7 @@ void GitQlientRepo::updateCache()
    {
       QLog_Debug("UI", QString("Updating the GitQlient UI"));
 
-      mGitLoader->loadRepository();
+      mGitLoader->refreshRepository();
 
       mDiffWidget->reload();
    }
@@ -163,8 +178,11 @@ void GitQlientRepo::updateUiFromWatcher()
 {
    QLog_Info("UI", QString("Updating the GitQlient UI from watcher"));
 
-   mGitLoader->updateWipRevision();
+   mGitLoader->updateWipRevisionAsync();
+}
 
+void GitQlientRepo::onWipRevisionUpdated()
+{
    mHistoryWidget->updateUiFromWatcher();
 
    mDiffWidget->reload();
@@ -232,24 +250,9 @@ void GitQlientRepo::setRepository(const QString &newDir)
 
 void GitQlientRepo::setWatcher()
 {
-   mGitWatcher = new QFileSystemWatcher(this);
-   connect(mGitWatcher, &QFileSystemWatcher::fileChanged, this, [this](const QString &path) {
-      if (!path.endsWith(".autosave") && !path.endsWith(".tmp") && !path.endsWith(".user"))
-         updateUiFromWatcher();
-   });
-
    QLog_Info("UI", QString("Setting the file watcher for dir {%1}").arg(mCurrentDir));
 
-   mGitWatcher->addPath(mCurrentDir);
-
-   QDirIterator it(mCurrentDir, QDirIterator::Subdirectories);
-   while (it.hasNext())
-   {
-      const auto dir = it.next();
-
-      if (it.fileInfo().isDir() && !dir.endsWith(".") && !dir.endsWith(".."))
-         mGitWatcher->addPath(dir);
-   }
+   mGitWatcher->start();
 }
 
 void GitQlientRepo::clearWindow()
@@ -276,37 +279,27 @@ void GitQlientRepo::showFileHistory(const QString &fileName)
    showBlameView();
 }
 
-void GitQlientRepo::createProgressDialog(int total)
+void GitQlientRepo::onRepoLoadStarted(int loadedCommits)
 {
-   if (!mProgressDlg)
-   {
-      mProgressDlg = new ProgressDlg(tr("Loading repository..."), QString(), 0, total, false, true);
-      connect(mProgressDlg, &ProgressDlg::destroyed, this, [this]() { mProgressDlg = nullptr; });
-
-      mProgressDlg->show();
-
-      QApplication::processEvents(QEventLoop::ExcludeUserInputEvents);
-   }
+   mHistoryWidget->onNewRevisions(loadedCommits);
 }
 
-void GitQlientRepo::updateProgressDialog(int step)
+void GitQlientRepo::onRepoLoadStep(int loadedCommits)
 {
-   if (mProgressDlg)
-   {
-      mProgressDlg->setValue(step);
+   mHistoryWidget->onRevisionsLoaded(loadedCommits);
+}
 
-      QApplication::processEvents(QEventLoop::ExcludeUserInputEvents);
-   }
+void GitQlientRepo::onRevisionsInserted(int insertedCommits, int updatedCommits)
+{
+   mHistoryWidget->onRevisionsInserted(insertedCommits, updatedCommits);
 }
 
 void GitQlientRepo::onRepoLoadFinished()
 {
-   mProgressDlg->close();
-
    const auto totalCommits = mGitQlientCache->count();
 
    mHistoryWidget->loadBranches();
-   mHistoryWidget->onNewRevisions(totalCommits);
+   mHistoryWidget->onRevisionsLoaded(totalCommits);
    mBlameWidget->onNewRevisions(totalCommits);
 }
 
@@ -443,7 +436,8 @@ void GitQlientRepo::closeEvent(QCloseEvent *ce)
    QWidget::closeEvent(ce);
 }
 
-void GitRepoLoader::cancelAll()
+void GitQlientRepo::showDiagnostics()
 {
-   emit cancelAllProcesses(QPrivateSignal());
+   const auto dlg = new GitDiagnosticsDlg(mGitQlientCache, this);
+   dlg->show();
 }
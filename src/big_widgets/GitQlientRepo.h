@@ -29,7 +29,7 @@ class GitBase;
 class RevisionsCache;
 class GitRepoLoader;
 class QCloseEvent;
-class QFileSystemWatcher;
+class GitRepoWatcher;
 class QStackedLayout;
 class Controls;
 class HistoryWidget;
@@ -37,7 +37,6 @@ class DiffWidget;
 class BlameWidget;
 class MergeWidget;
 class QTimer;
-class ProgressDlg;
 
 enum class ControlsMainViews;
 
@@ -138,8 +137,7 @@ private:
    MergeWidget *mMergeWidget = nullptr;
    QTimer *mAutoFetch = nullptr;
    QTimer *mAutoFilesUpdate = nullptr;
-   ProgressDlg *mProgressDlg = nullptr;
-   QFileSystemWatcher *mGitWatcher = nullptr;
+   GitRepoWatcher *mGitWatcher = nullptr;
    QPair<ControlsMainViews, QWidget *> mPreviousView;
 
    /*!
@@ -148,10 +146,16 @@ private:
    */
    void updateCache();
    /*!
-    \brief Performs a light UI update triggered by the QFileSystemWatcher.
+    \brief Performs a light UI update triggered by the QFileSystemWatcher. The WIP is updated in the background and
+    the widgets are refreshed once it's ready.
 
    */
    void updateUiFromWatcher();
+   /*!
+    \brief Refreshes the subwidgets that show the WIP once it has been updated.
+
+   */
+   void onWipRevisionUpdated();
    /*!
     \brief Opens the diff view with the selected commit from the repository view.
     \param currentSha The current selected commit SHA.
@@ -193,18 +197,23 @@ private:
    void showFileHistory(const QString &fileName);
 
    /*!
-    \brief Updates the progess dialog when loading a really huge repository.
-    \param total Total number of steps
+    \brief Shows the first batch of commits as soon as it is available in the cache.
+    \param loadedCommits The number of commits loaded so far.
    */
-   void createProgressDialog(int total);
-
+   void onRepoLoadStarted(int loadedCommits);
    /*!
-    \brief Updates the progess dialog when loading a really huge repository.
-    \param step Number of step
+    \brief Appends a new batch of loaded commits to the views without resetting them.
+    \param loadedCommits The number of commits loaded so far.
    */
-   void updateProgressDialog(int step);
+   void onRepoLoadStep(int loadedCommits);
    /*!
-    \brief When the loading finishes this method closes and destroyes the dialog.
+    \brief Shows the commits added on top of the history by an incremental refresh.
+    \param insertedCommits The number of new commits.
+    \param updatedCommits The number of commits below the new ones whose graph changed.
+   */
+   void onRevisionsInserted(int insertedCommits, int updatedCommits);
+   /*!
+    \brief When the loading finishes this method loads the branches and updates the rest of the views.
 
    */
    void onRepoLoadFinished();
@@ -262,4 +271,9 @@ private:
 
    */
    void updateWip();
+   /*!
+    \brief Opens the hidden dialog that summarizes the time spent running git commands.
+
+   */
+   void showDiagnostics();
 };
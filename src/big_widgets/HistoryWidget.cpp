@@ -23,6 +23,7 @@
 #include <QCheckBox>
 #include <QMessageBox>
 #include <QApplication>
+#include <QScrollBar>
 
 using namespace QLogger;
 
@@ -69,7 +70,7 @@ HistoryWidget::HistoryWidget(const QSharedPointer<RevisionsCache> &cache, const
    connect(mCommitInfoWidget, &CommitInfoWidget::signalShowFileHistory, this, &HistoryWidget::signalShowFileHistory);
    connect(mCommitInfoWidget, &CommitInfoWidget::signalEditFile, this, &HistoryWidget::signalEditFile);
 
-   mSearchInput->setPlaceholderText(tr("Press Enter to search by SHA or log message..."));
+   mSearchInput->setPlaceholderText(tr("Press Enter to search by SHA, log message or author..."));
    connect(mSearchInput, &QLineEdit::returnPressed, this, &HistoryWidget::search);
 
    connect(mRepositoryView, &CommitHistoryView::signalViewUpdated, this, &HistoryWidget::signalViewUpdated);
@@ -155,6 +156,11 @@ void HistoryWidget::loadBranches()
    mBranchesWidget->showBranches();
 }
 
+void HistoryWidget::updateBranchDistances()
+{
+   mBranchesWidget->updateDistances();
+}
+
 void HistoryWidget::updateUiFromWatcher()
 {
    const auto commitStackedIndex = mCommitStackedWidget->currentIndex();
@@ -178,6 +184,7 @@ QString HistoryWidget::getCurrentSha() const
 void HistoryWidget::onNewRevisions(int totalCommits)
 {
    mRepositoryModel->onNewRevisions(totalCommits);
+   resetSearch();
 
    onCommitSelected(CommitInfo::ZERO_SHA);
 
@@ -186,6 +193,26 @@ void HistoryWidget::onNewRevisions(int totalCommits)
        QItemSelectionModel::Select);
 }
 
+void HistoryWidget::onRevisionsLoaded(int totalCommits)
+{
+   mRepositoryModel->onRevisionsLoaded(totalCommits);
+   mRepositoryView->viewport()->update();
+   resetSearch();
+}
+
+void HistoryWidget::onRevisionsInserted(int insertedCommits, int updatedCommits)
+{
+   const auto scrollBar = mRepositoryView->verticalScrollBar();
+   const auto scrollValue = scrollBar->value();
+
+   mRepositoryModel->onRevisionsInserted(insertedCommits, updatedCommits);
+   resetSearch();
+
+   // If the user is not at the top, the same commits are kept in the viewport.
+   if (scrollValue > 0 && mRepositoryView->verticalScrollMode() == QAbstractItemView::ScrollPerItem)
+      scrollBar->setValue(scrollValue + insertedCommits);
+}
+
 void HistoryWidget::search()
 {
    const auto text = mSearchInput->text();
@@ -198,24 +225,52 @@ void HistoryWidget::search()
          goToSha(text);
       else
       {
+         if (text != mLastSearch)
+         {
+            mLastSearch = text;
+            mSearchResults = mCache->searchCommits(text);
+
+            QLog_Debug("UI", QString("Found {%1} commits for the search {%2}.").arg(mSearchResults.count()).arg(text));
+         }
+
+         if (mSearchResults.isEmpty())
+            return;
+
          auto selectedItems = mRepositoryView->selectedIndexes();
-         auto startingRow = 0;
+         auto currentRow = 0;
 
          if (!selectedItems.isEmpty())
          {
             std::sort(selectedItems.begin(), selectedItems.end(),
                       [](const QModelIndex index1, const QModelIndex index2) { return index1.row() <= index2.row(); });
-            startingRow = selectedItems.constFirst().row();
+            currentRow = selectedItems.constFirst().row();
          }
 
-         commitInfo = mCache->getCommitInfoByField(CommitInfo::Field::SHORT_LOG, text, startingRow + 1);
+         // Enter goes to the next match and Shift+Enter to the previous one.
+         auto row = 0;
+
+         if (QApplication::keyboardModifiers() & Qt::ShiftModifier)
+         {
+            const auto it = std::lower_bound(mSearchResults.cbegin(), mSearchResults.cend(), currentRow);
+            row = it != mSearchResults.cbegin() ? *(it - 1) : mSearchResults.constLast();
+         }
+         else
+         {
+            const auto it = std::upper_bound(mSearchResults.cbegin(), mSearchResults.cend(), currentRow);
+            row = it != mSearchResults.cend() ? *it : mSearchResults.constFirst();
+         }
 
-         if (commitInfo.isValid())
-            goToSha(commitInfo.sha());
+         goToSha(mRepositoryModel->sha(row));
       }
    }
 }
 
+void HistoryWidget::resetSearch()
+{
+   mLastSearch.clear();
+   mSearchResults.clear();
+}
+
 void HistoryWidget::goToSha(const QString &sha)
 {
    mRepositoryView->focusOnCommit(sha);
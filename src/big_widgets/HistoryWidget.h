@@ -24,6 +24,7 @@
  ***************************************************************************************/
 
 #include <QFrame>
+#include <QVector>
 
 class RevisionsCache;
 class GitBase;
@@ -174,6 +175,10 @@ public:
     * @brief loadBranches Loads the information on the branches widget: branches, tags, stashes and submodules.
     */
    void loadBranches();
+   /**
+    * @brief updateBranchDistances Shows the last calculated distances of the local branches.
+    */
+   void updateBranchDistances();
 
    /*!
     \brief If the current view is the WIP widget, updates it.
@@ -211,6 +216,19 @@ public:
     \param totalCommits The new total of commits to show in the graph.
    */
    void onNewRevisions(int totalCommits);
+   /*!
+    \brief Appends to the history model the commits loaded since the last update without resetting the view.
+
+    \param totalCommits The total of commits loaded so far.
+   */
+   void onRevisionsLoaded(int totalCommits);
+   /*!
+    \brief Inserts the new commits on top of the history keeping the rows the user was looking at.
+
+    \param insertedCommits The number of new commits.
+    \param updatedCommits The number of commits below the new ones whose graph changed.
+   */
+   void onRevisionsInserted(int insertedCommits, int updatedCommits);
 
 private:
    QSharedPointer<GitBase> mGit;
@@ -219,6 +237,8 @@ private:
    CommitHistoryView *mRepositoryView = nullptr;
    BranchesWidget *mBranchesWidget = nullptr;
    QLineEdit *mSearchInput = nullptr;
+   QString mLastSearch;
+   QVector<int> mSearchResults;
    QStackedWidget *mCommitStackedWidget = nullptr;
    WipWidget *mWipWidget = nullptr;
    AmendWidget *mAmendWidget = nullptr;
@@ -227,10 +247,16 @@ private:
    RepositoryViewDelegate *mItemDelegate = nullptr;
 
    /*!
-    \brief Performs a search based on the input of the search QLineEdit with the users input.
+    \brief Performs a search based on the input of the search QLineEdit with the users input. Searching again the same
+    text goes to the next match, or to the previous one if Shift is pressed.
 
    */
    void search();
+   /*!
+    \brief Discards the results of the last search. The rows change when the history is reloaded.
+
+   */
+   void resetSearch();
    /*!
     \brief Goes to the selected SHA.
 
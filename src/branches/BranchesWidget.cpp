@@ -2,6 +2,7 @@
 
 #include <BranchTreeWidget.h>
 #include <GitBase.h>
+#include <GitCommandTrace.h>
 #include <GitTags.h>
 #include <GitSubmodules.h>
 #include <GitStashes.h>
@@ -15,6 +16,7 @@
 #include <QApplication>
 #include <QVBoxLayout>
 #include <QHeaderView>
+#include <QTreeWidgetItemIterator>
 #include <QListWidget>
 #include <QLabel>
 #include <QMenu>
@@ -216,6 +218,8 @@ void BranchesWidget::showBranches()
 {
    QLog_Info("UI", QString("Loading branches data"));
 
+   GitCommandTrace::Scope scope("Branches panel");
+
    clear();
 
    QApplication::setOverrideCursor(QCursor(Qt::WaitCursor));
@@ -352,7 +356,29 @@ void BranchesWidget::processLocalBranch(const QString &sha, QString branch)
       }
    }
 
-   QLog_Debug("UI", QString("Calculating distances..."));
+   showDistances(item);
+
+   mLocalBranchesTree->addTopLevelItem(item);
+
+   QLog_Debug("UI", QString("Finish gathering local branch information"));
+}
+
+void BranchesWidget::updateDistances()
+{
+   QTreeWidgetItemIterator it(mLocalBranchesTree);
+
+   while (*it)
+   {
+      if ((*it)->data(0, GitQlient::IsLeaf).toBool())
+         showDistances(*it);
+
+      ++it;
+   }
+}
+
+void BranchesWidget::showDistances(QTreeWidgetItem *item)
+{
+   const auto fullBranchName = item->data(0, GitQlient::FullNameRole).toString();
 
    if (fullBranchName != "detached")
    {
@@ -361,10 +387,6 @@ void BranchesWidget::processLocalBranch(const QString &sha, QString branch)
       item->setText(1, QString("%1 \u2193 - %2 \u2191").arg(distances.behindMaster).arg(distances.aheadMaster));
       item->setText(2, QString("%1 \u2193 - %2 \u2191").arg(distances.behindOrigin).arg(distances.aheadOrigin));
    }
-
-   mLocalBranchesTree->addTopLevelItem(item);
-
-   QLog_Debug("UI", QString("Finish gathering local branch information"));
 }
 
 void BranchesWidget::processRemoteBranch(const QString &sha, QString branch)
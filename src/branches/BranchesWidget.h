@@ -28,6 +28,7 @@
 class BranchTreeWidget;
 class QListWidget;
 class QListWidgetItem;
+class QTreeWidgetItem;
 class QLabel;
 class GitBase;
 class RevisionsCache;
@@ -93,6 +94,12 @@ public:
 
    */
    void showBranches();
+   /*!
+    \brief Updates the distances of the local branches with the ones in the cache. They are calculated in the
+    background, so they arrive after the branches are shown.
+
+   */
+   void updateDistances();
    /*!
     \brief Clears all widget's information.
 
@@ -128,6 +135,12 @@ private:
     \param branch The remote branch to be added in the tree widget.
    */
    void processRemoteBranch(const QString &sha, QString branch);
+   /*!
+    \brief Shows the distances to master and to the upstream of a local branch.
+
+    \param item The item of the local branch.
+   */
+   void showDistances(QTreeWidgetItem *item);
    /*!
     \brief Process all the tags and adds them into the QListWidget.
 
@@ -0,0 +1,154 @@
+#include "BranchDistancesCalculator.h"
+
+#include <QLogger.h>
+
+#include <QElapsedTimer>
+
+#include <algorithm>
+
+using namespace QLogger;
+
+namespace
+{
+const auto TIPS_PER_WALK = 64;
+}
+
+BranchDistancesCalculator::BranchDistancesCalculator(QObject *parent)
+   : QObject(parent)
+{
+}
+
+void BranchDistancesCalculator::calculate(int generation, const CommitGraph &graph, const QVector<Request> &requests)
+{
+   QElapsedTimer timer;
+   timer.start();
+
+   const auto isLoaded = [&graph](int row) { return row >= 0 && row < graph.count(); };
+   auto next = 0;
+
+   while (next < requests.count())
+   {
+      QVector<int> tips;
+      QVector<Comparison> comparisons;
+      QVector<Result> results;
+
+      const auto tipIndex = [&tips](int row) {
+         auto index = tips.indexOf(row);
+
+         if (index == -1)
+         {
+            index = tips.count();
+            tips.append(row);
+         }
+
+         return index;
+      };
+
+      while (next < requests.count())
+      {
+         const auto &request = requests.at(next);
+         const auto newTips = static_cast<int>(isLoaded(request.localRow) && !tips.contains(request.localRow))
+             + static_cast<int>(isLoaded(request.masterRow) && !tips.contains(request.masterRow))
+             + static_cast<int>(isLoaded(request.upstreamRow) && !tips.contains(request.upstreamRow));
+
+         if (tips.count() + newTips > TIPS_PER_WALK)
+            break;
+
+         Result result;
+         result.branch = request.branch;
+         results.append(result);
+
+         if (isLoaded(request.localRow))
+         {
+            const auto localTip = tipIndex(request.localRow);
+
+            if (isLoaded(request.masterRow))
+               comparisons.append({ localTip, tipIndex(request.masterRow), results.count() - 1, true });
+
+            if (isLoaded(request.upstreamRow))
+               comparisons.append({ localTip, tipIndex(request.upstreamRow), results.count() - 1, false });
+         }
+
+         ++next;
+      }
+
+      walk(graph, tips, comparisons, results);
+
+      emit signalDistancesCalculated(generation, results);
+   }
+
+   QLog_Debug("Git",
+              QString("Distances of {%1} branches calculated in {%2} ms.").arg(requests.count()).arg(timer.elapsed()));
+}
+
+void BranchDistancesCalculator::walk(const CommitGraph &graph, const QVector<int> &tips,
+                                     const QVector<Comparison> &comparisons, QVector<Result> &results)
+{
+   if (comparisons.isEmpty())
+      return;
+
+   QVector<quint64> reachedBy(graph.count(), 0);
+   quint64 allTips = 0;
+
+   for (auto i = 0; i < tips.count(); ++i)
+   {
+      reachedBy[tips.at(i)] |= quint64(1) << i;
+      allTips |= quint64(1) << i;
+   }
+
+   QVector<int> ahead(comparisons.count(), 0);
+   QVector<int> behind(comparisons.count(), 0);
+   const auto offsets = graph.parentsOffsets.constData();
+   const auto parents = graph.parents.constData();
+   const auto masks = reachedBy.data();
+
+   // The children always have a lower row than their parents, so a single pass propagates the marks to the roots.
+   for (auto row = tips.isEmpty() ? 0 : *std::min_element(tips.cbegin(), tips.cend()); row < graph.count(); ++row)
+   {
+      const auto mask = masks[row];
+
+      if (mask == 0)
+         continue;
+
+      for (auto i = offsets[row]; i < offsets[row + 1]; ++i)
+      {
+         if (parents[i] > row)
+            masks[parents[i]] |= mask;
+      }
+
+      // The common history is reached by all the tips and doesn't count for any distance.
+      if (mask == allTips)
+         continue;
+
+      for (auto i = 0; i < comparisons.count(); ++i)
+      {
+         const auto &comparison = comparisons.at(i);
+         const auto local = (mask >> comparison.localTip) & 1;
+         const auto other = (mask >> comparison.otherTip) & 1;
+
+         if (local && !other)
+            ++ahead[i];
+         else if (other && !local)
+            ++behind[i];
+      }
+   }
+
+   for (auto i = 0; i < comparisons.count(); ++i)
+   {
+      const auto &comparison = comparisons.at(i);
+      auto &result = results[comparison.result];
+
+      if (comparison.toMaster)
+      {
+         result.hasMaster = true;
+         result.distances.aheadMaster = ahead.at(i);
+         result.distances.behindMaster = behind.at(i);
+      }
+      else
+      {
+         result.hasUpstream = true;
+         result.distances.aheadOrigin = ahead.at(i);
+         result.distances.behindOrigin = behind.at(i);
+      }
+   }
+}
@@ -0,0 +1,102 @@
+#pragma once
+
+#pragma once
+
+/****************************************************************************************
+ ** GitQlient is an application to manage and operate one or several Git repositories. With
+ ** GitQlient you will be able to add commits, branches and manage all the options Git provides.
+ ** Copyright (C) 2020  Francesc Martinez
+ **
+ ** LinkedIn: www.linkedin.com/in/cescmm/
+ ** Web: www.francescmm.com
+ **
+ ** This program is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public
+ ** License as published by the Free Software Foundation; either
+ ** version 2 of the License, or (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this library; if not, write to the Free Software
+ ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ***************************************************************************************/
+
+#include <CommitGraph.h>
+#include <RevisionsCache.h>
+
+#include <QObject>
+
+/**
+ * @brief The BranchDistancesCalculator class computes how many commits every local branch is ahead and behind of the
+ * master branch and of its upstream. Instead of asking git for every pair of branches, all the distances are computed
+ * from the loaded commit graph: each walk marks with one bit the tips that reach every commit, so up to 64 tips are
+ * resolved with a single pass over the graph. It lives in its own thread and notifies the results batch by batch.
+ *
+ * @class BranchDistancesCalculator BranchDistancesCalculator.h "BranchDistancesCalculator.h"
+ */
+class BranchDistancesCalculator : public QObject
+{
+   Q_OBJECT
+
+public:
+   /**
+    * @brief The rows of the tips to compare. A row is -1 when the reference doesn't exist or isn't loaded.
+    */
+   struct Request
+   {
+      QString branch;
+      int localRow = -1;
+      int masterRow = -1;
+      int upstreamRow = -1;
+   };
+
+   /**
+    * @brief The distances of a branch. Only the distances whose flag is set have been computed.
+    */
+   struct Result
+   {
+      QString branch;
+      bool hasMaster = false;
+      bool hasUpstream = false;
+      RevisionsCache::LocalBranchDistances distances;
+   };
+
+signals:
+   /**
+    * @brief Signal triggered every time a batch of branches has been calculated.
+    *
+    * @param generation The generation of the request the results belong to.
+    * @param results The distances of the branches of the batch.
+    */
+   void signalDistancesCalculated(int generation, const QVector<BranchDistancesCalculator::Result> &results);
+
+public:
+   explicit BranchDistancesCalculator(QObject *parent = nullptr);
+
+   /**
+    * @brief Calculates the distances of all the requested branches.
+    *
+    * @param generation An identifier that is sent back with the results so old requests can be discarded.
+    * @param graph The commit graph.
+    * @param requests The branches to calculate.
+    */
+   void calculate(int generation, const CommitGraph &graph, const QVector<Request> &requests);
+
+private:
+   struct Comparison
+   {
+      int localTip;
+      int otherTip;
+      int result;
+      bool toMaster;
+   };
+
+   static void walk(const CommitGraph &graph, const QVector<int> &tips, const QVector<Comparison> &comparisons,
+                    QVector<Result> &results);
+};
+
+Q_DECLARE_METATYPE(BranchDistancesCalculator::Result)
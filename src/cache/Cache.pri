@@ -1,18 +1,37 @@
 INCLUDEPATH += $$PWD
 
 HEADERS += \
+    $$PWD/BranchDistancesCalculator.h \
+    $$PWD/CommitGraph.h \
     $$PWD/CommitInfo.h \
+    $$PWD/CommitsSearchIndex.h \
+    $$PWD/CommitsTable.h \
+    $$PWD/FileBlame.h \
+    $$PWD/FilePathPool.h \
     $$PWD/Lane.h \
+    $$PWD/LanesBuilder.h \
     $$PWD/LaneType.h \
+    $$PWD/ObjectId.h \
+    $$PWD/PackedLanes.h \
     $$PWD/References.h \
     $$PWD/RevisionFiles.h \
+    $$PWD/RevisionsDiskCache.h \
     $$PWD/RevisionsCache.h \
     $$PWD/lanes.h
 
 SOURCES += \
+    $$PWD/BranchDistancesCalculator.cpp \
     $$PWD/CommitInfo.cpp \
+    $$PWD/CommitsSearchIndex.cpp \
+    $$PWD/CommitsTable.cpp \
+    $$PWD/FileBlame.cpp \
+    $$PWD/FilePathPool.cpp \
     $$PWD/Lane.cpp \
+    $$PWD/LanesBuilder.cpp \
+    $$PWD/ObjectId.cpp \
+    $$PWD/PackedLanes.cpp \
     $$PWD/References.cpp \
     $$PWD/RevisionFiles.cpp \
+    $$PWD/RevisionsDiskCache.cpp \
     $$PWD/RevisionsCache.cpp \
     $$PWD/lanes.cpp
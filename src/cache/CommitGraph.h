@@ -1,5 +1,7 @@
 #pragma once
 
+#pragma once
+
 /****************************************************************************************
  ** GitQlient is an application to manage and operate one or several Git repositories. With
  ** GitQlient you will be able to add commits, branches and manage all the options Git provides.
@@ -22,30 +24,21 @@
  ** License along with this library; if not, write to the Free Software
  ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
  ***************************************************************************************/
-#include <QSyntaxHighlighter>
 
-/*!
- \brief Overloaded class that adds syntax highlight for the diff view. It shows the additions in green, removals in red
- and the files where that happened in blue.
+#include <QMetaType>
+#include <QVector>
 
- \class FileDiffHighlighter FileDiffHighlighter.h "FileDiffHighlighter.h"
-*/
-class FileDiffHighlighter : public QSyntaxHighlighter
+/**
+ * @brief The CommitGraph struct is a compact copy of the parents of the loaded commits, indexed by row, so the graph
+ * can be walked from other threads. The parents of the commit in the row r are stored in @ref parents from the
+ * position parentsOffsets[r] to parentsOffsets[r + 1], not included. The parents that aren't loaded are left out.
+ */
+struct CommitGraph
 {
-   Q_OBJECT
-
-public:
-   /*!
-    \brief Default constructor.
+   QVector<int> parentsOffsets;
+   QVector<int> parents;
 
-    \param document The document to parse.
-   */
-   explicit FileDiffHighlighter(QTextDocument *document);
-
-   /*!
-    \brief Analyses a block of text and applies the syntax highlighter.
-
-    \param text The block of text to analyse.
-   */
-   void highlightBlock(const QString &text) override;
+   int count() const { return parentsOffsets.isEmpty() ? 0 : parentsOffsets.count() - 1; }
 };
+
+Q_DECLARE_METATYPE(CommitGraph)
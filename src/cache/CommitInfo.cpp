@@ -1,50 +1,75 @@
 #include "CommitInfo.h"
 
+#include <LaneType.h>
+
+#include <QDataStream>
 #include <QStringList>
 
 const QString CommitInfo::ZERO_SHA = QString("0000000000000000000000000000000000000000");
+const ObjectId CommitInfo::ZERO_ID = ObjectId(CommitInfo::ZERO_SHA);
 
 CommitInfo::CommitInfo(const QString &sha, const QStringList &parents, const QString &author, long long secsSinceEpoch,
                        const QString &log, const QString &longLog)
 {
-   mSha = sha;
-   mParentsSha = parents;
+   mId = ObjectId(sha);
+
+   for (const auto &parent : parents)
+      mParents.append(ObjectId(parent));
+
    mCommitter = author;
    mAuthor = author;
-   mCommitDate = QDateTime::fromSecsSinceEpoch(secsSinceEpoch);
-   mShortLog = log;
-   mLongLog = longLog;
+   mCommitDate = secsSinceEpoch;
+   mShortLog = log.toUtf8();
+   mLongLog = longLog.toUtf8();
 }
 
 CommitInfo::CommitInfo(const QByteArray &b)
 {
-   const auto fields = QString::fromUtf8(b).split('\n');
+   // The first line has the log size and the second one the boundary mark, the SHA and the parents: "<m><sha>X<p> <p>".
+   const auto headerStart = b.indexOf('\n') + 1;
+   const auto headerEnd = headerStart > 0 ? b.indexOf('\n', headerStart) : -1;
+   const auto separator = headerEnd != -1 ? b.indexOf('X', headerStart) : -1;
+
+   if (separator == -1 || separator > headerEnd)
+      return;
 
-   if (fields.count() > 6)
+   const auto fields = b.mid(headerEnd + 1).split('\n');
+
+   if (fields.count() > 4)
    {
-      auto combinedShas = fields.at(1);
-      auto sha = combinedShas.split('X').first();
-      mBoundaryInfo = sha.at(0);
-      sha.remove(0, 1);
-      mSha = sha;
-      combinedShas = combinedShas.remove(0, mSha.size() + 1 + 1);
-      mParentsSha = combinedShas.trimmed().split(' ', QString::SkipEmptyParts);
-      mCommitter = fields.at(2);
-      mAuthor = fields.at(3);
-      mCommitDate = QDateTime::fromSecsSinceEpoch(fields.at(4).toInt());
-      mShortLog = fields.at(5);
-
-      for (auto i = 6; i < fields.count(); ++i)
+      const auto data = b.constData();
+
+      mBoundaryInfo = QChar::fromLatin1(data[headerStart]);
+      mId = ObjectId::fromHex(data + headerStart + 1, separator - headerStart - 1);
+
+      for (auto parentStart = separator + 1; parentStart < headerEnd;)
+      {
+         auto parentEnd = b.indexOf(' ', parentStart);
+
+         if (parentEnd == -1 || parentEnd > headerEnd)
+            parentEnd = headerEnd;
+
+         if (parentEnd > parentStart)
+            mParents.append(ObjectId::fromHex(data + parentStart, parentEnd - parentStart));
+
+         parentStart = parentEnd + 1;
+      }
+
+      mCommitter = QString::fromUtf8(fields.at(0));
+      mAuthor = QString::fromUtf8(fields.at(1));
+      mCommitDate = fields.at(2).toLongLong();
+      mShortLog = fields.at(3);
+
+      for (auto i = 4; i < fields.count(); ++i)
          mLongLog += fields.at(i);
    }
 }
 
 bool CommitInfo::operator==(const CommitInfo &commit) const
 {
-   return (mSha == commit.mSha || mSha.startsWith(commit.sha()) || commit.sha().startsWith(mSha))
-       && mParentsSha == commit.mParentsSha && mCommitter == commit.mCommitter && mAuthor == commit.mAuthor
-       && mCommitDate == commit.mCommitDate && mShortLog == commit.mShortLog && mLongLog == commit.mLongLog
-       && mLanes == commit.mLanes;
+   return mId == commit.mId && mParents == commit.mParents && mCommitter == commit.mCommitter
+       && mAuthor == commit.mAuthor && mCommitDate == commit.mCommitDate && mShortLog == commit.mShortLog
+       && mLongLog == commit.mLongLog && mLanes == commit.mLanes;
 }
 
 bool CommitInfo::operator!=(const CommitInfo &commit) const
@@ -75,11 +100,14 @@ QString CommitInfo::getFieldStr(CommitInfo::Field field) const
    }
 }
 
-bool CommitInfo::isValid() const
+QStringList CommitInfo::parents() const
 {
-   QRegExp hexMatcher("^[0-9A-F]{40}$", Qt::CaseInsensitive);
+   QStringList parents;
 
-   return !mSha.isEmpty() && hexMatcher.exactMatch(mSha);
+   for (const auto &parent : mParents)
+      parents.append(parent.toString());
+
+   return parents;
 }
 
 int CommitInfo::getActiveLane() const
@@ -101,3 +129,40 @@ void CommitInfo::addReference(References::Type type, const QString &reference)
 {
    mReferences.addReference(type, reference);
 }
+
+void CommitStringsPool::clear()
+{
+   identities.clear();
+}
+
+void CommitInfo::shareStrings(CommitStringsPool &pool)
+{
+   const auto shareIdentity = [&pool](QString &identity) {
+      auto it = pool.identities.constFind(identity);
+
+      if (it == pool.identities.constEnd())
+         it = pool.identities.insert(identity);
+
+      identity = *it;
+   };
+
+   shareIdentity(mCommitter);
+   shareIdentity(mAuthor);
+}
+
+QDataStream &operator<<(QDataStream &stream, const CommitInfo &commit)
+{
+   // The references are not stored since they are reloaded every time, and the lanes are calculated on demand.
+   stream << commit.mBoundaryInfo << commit.mId << commit.mParents << commit.mCommitter << commit.mAuthor
+          << commit.mCommitDate << commit.mShortLog << commit.mLongLog;
+
+   return stream;
+}
+
+QDataStream &operator>>(QDataStream &stream, CommitInfo &commit)
+{
+   stream >> commit.mBoundaryInfo >> commit.mId >> commit.mParents >> commit.mCommitter >> commit.mAuthor
+       >> commit.mCommitDate >> commit.mShortLog >> commit.mLongLog;
+
+   return stream;
+}
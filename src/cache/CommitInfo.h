@@ -26,10 +26,26 @@
 #include <QVector>
 #include <QStringList>
 #include <QDateTime>
+#include <QMetaType>
+#include <QSet>
 
 #include <Lane.h>
+#include <ObjectId.h>
 #include <References.h>
 
+class QDataStream;
+
+/**
+ * @brief Pool of the strings that repeat between commits: the identities of the authors and committers. Commits that
+ * share a pool share the data of those strings instead of having their own copy.
+ */
+struct CommitStringsPool
+{
+   QSet<QString> identities;
+
+   void clear();
+};
+
 class CommitInfo
 {
 public:
@@ -53,20 +69,24 @@ public:
 
    QString getFieldStr(CommitInfo::Field field) const;
    bool isBoundary() const { return mBoundaryInfo == '-'; }
-   int parentsCount() const { return mParentsSha.count(); }
-   QString parent(int idx) const { return mParentsSha.count() > idx ? mParentsSha.at(idx) : QString(); }
-   QStringList parents() const { return mParentsSha; }
+   int parentsCount() const { return mParents.count(); }
+   QString parent(int idx) const { return mParents.count() > idx ? mParents.at(idx).toString() : QString(); }
+   QStringList parents() const;
+   ObjectId parentId(int idx) const { return mParents.count() > idx ? mParents.at(idx) : ObjectId(); }
+   QVector<ObjectId> parentIds() const { return mParents; }
 
-   QString sha() const { return mSha; }
+   QString sha() const { return mId.toString(); }
+   ObjectId id() const { return mId; }
    QString committer() const { return mCommitter; }
    QString author() const { return mAuthor; }
-   QString authorDate() const { return QString::number(mCommitDate.toSecsSinceEpoch()); }
-   QString shortLog() const { return mShortLog; }
-   QString longLog() const { return mLongLog; }
-   QString fullLog() const { return QString("%1\n\n%2").arg(mShortLog, mLongLog.trimmed()); }
+   QString authorDate() const { return QString::number(mCommitDate); }
+   QString shortLog() const { return QString::fromUtf8(mShortLog); }
+   QString longLog() const { return QString::fromUtf8(mLongLog); }
+   QString fullLog() const { return QString("%1\n\n%2").arg(shortLog(), longLog().trimmed()); }
 
-   bool isValid() const;
-   bool isWip() const { return mSha == ZERO_SHA; }
+   bool isValid() const { return !mId.isNull(); }
+   bool isWip() const { return mId == ZERO_ID; }
+   int row() const { return mRow; }
 
    void setLanes(const QVector<Lane> &lanes) { mLanes = lanes; }
    QVector<Lane> getLanes() const { return mLanes; }
@@ -74,23 +94,34 @@ public:
    int getLanesCount() const { return mLanes.count(); }
    int getActiveLane() const;
 
+   void shareStrings(CommitStringsPool &pool);
+
    void addReference(References::Type type, const QString &reference);
    void addReferences(const References &refs) { mReferences = refs; }
    QStringList getReferences(References::Type type) const { return mReferences.getReferences(type); }
    bool hasReferences() const { return !mReferences.isEmpty(); }
 
    static const QString ZERO_SHA;
+   static const ObjectId ZERO_ID;
+
+   friend QDataStream &operator<<(QDataStream &stream, const CommitInfo &commit);
+   friend QDataStream &operator>>(QDataStream &stream, CommitInfo &commit);
 
 private:
+   // The cache stores the commits in a table and builds the CommitInfo of a row from its columns.
+   friend class CommitsTable;
+
    QChar mBoundaryInfo;
-   QString mSha;
-   QStringList mParentsSha;
+   ObjectId mId;
+   QVector<ObjectId> mParents;
    QString mCommitter;
    QString mAuthor;
-   QDateTime mCommitDate;
-   QString mShortLog;
-   QString mLongLog;
-   QString mDiff;
+   qint64 mCommitDate = 0;
+   QByteArray mShortLog; // Stored in UTF-8 and only converted when displayed.
+   QByteArray mLongLog;
    QVector<Lane> mLanes;
    References mReferences;
+   int mRow = -1;
 };
+
+Q_DECLARE_METATYPE(CommitInfo)
@@ -0,0 +1,192 @@
+#include "CommitsSearchIndex.h"
+
+#include <CommitsTable.h>
+
+#include <QElapsedTimer>
+#include <QRegularExpression>
+
+#include <algorithm>
+
+namespace
+{
+// Number of commits indexed between two checks of the time budget.
+const auto COMMITS_PER_CHECK = 64;
+
+quint32 trigramKey(const char *data)
+{
+   const auto bytes = reinterpret_cast<const uchar *>(data);
+
+   return static_cast<quint32>(bytes[0]) << 16 | static_cast<quint32>(bytes[1]) << 8 | static_cast<quint32>(bytes[2]);
+}
+
+QVector<int> intersect(const QVector<int> &a, const QVector<int> &b)
+{
+   QVector<int> result;
+   result.reserve(std::min(a.count(), b.count()));
+
+   std::set_intersection(a.cbegin(), a.cend(), b.cbegin(), b.cend(), std::back_inserter(result));
+
+   return result;
+}
+}
+
+CommitsSearchIndex::CommitsSearchIndex(const CommitsTable &commits)
+   : mTable(commits)
+{
+}
+
+void CommitsSearchIndex::clear()
+{
+   mRows.clear();
+   mIndexedCommits = 0;
+   mTrigrams.clear();
+}
+
+void CommitsSearchIndex::addCommit(int row)
+{
+   mRows.append(row);
+}
+
+void CommitsSearchIndex::insertRows(int row, int rowsCount)
+{
+   for (auto &commitRow : mRows)
+   {
+      if (commitRow >= row)
+         commitRow += rowsCount;
+   }
+}
+
+QVector<int> CommitsSearchIndex::search(const QString &query)
+{
+   const auto trimmedQuery = query.trimmed();
+
+   if (trimmedQuery.isEmpty())
+      return {};
+
+   indexPendingCommits();
+
+   const auto isRegExp = trimmedQuery.length() > 2 && trimmedQuery.startsWith('/') && trimmedQuery.endsWith('/');
+   QRegularExpression regExp;
+   QStringList terms;
+   QVector<int> candidates;
+   auto allCandidates = true;
+
+   if (isRegExp)
+   {
+      regExp = QRegularExpression(trimmedQuery.mid(1, trimmedQuery.length() - 2),
+                                  QRegularExpression::CaseInsensitiveOption);
+
+      if (!regExp.isValid())
+         return {};
+   }
+   else
+   {
+      terms = trimmedQuery.toLower().split(QRegularExpression("\\s+"), QString::SkipEmptyParts);
+
+      for (const auto &term : qAsConst(terms))
+      {
+         const auto utf8Term = term.toUtf8();
+
+         // Terms shorter than a trigram can't be searched in the index.
+         if (utf8Term.length() < 3)
+            continue;
+
+         const auto termCandidates = candidatesFor(utf8Term);
+
+         candidates = allCandidates ? termCandidates : intersect(candidates, termCandidates);
+         allCandidates = false;
+
+         if (candidates.isEmpty())
+            return {};
+      }
+   }
+
+   // The trigrams only discard commits: the candidates must still contain the whole terms.
+   const auto matches = [&](int row) {
+      const auto text = searchableText(row);
+
+      if (isRegExp)
+         return regExp.match(text).hasMatch();
+
+      const auto lowerText = text.toLower();
+
+      return std::all_of(terms.cbegin(), terms.cend(),
+                         [&lowerText](const QString &term) { return lowerText.contains(term); });
+   };
+
+   QVector<int> rows;
+   const auto checkCommit = [&](int doc) {
+      const auto row = mRows.at(doc);
+
+      if (matches(row))
+         rows.append(row);
+   };
+
+   if (allCandidates)
+   {
+      for (auto doc = 0; doc < mRows.count(); ++doc)
+         checkCommit(doc);
+   }
+   else
+   {
+      for (const auto doc : qAsConst(candidates))
+         checkCommit(doc);
+   }
+
+   std::sort(rows.begin(), rows.end());
+
+   return rows;
+}
+
+bool CommitsSearchIndex::indexPendingCommits(int budgetMs)
+{
+   QElapsedTimer timer;
+   timer.start();
+
+   for (; mIndexedCommits < mRows.count(); ++mIndexedCommits)
+   {
+      if (budgetMs != -1 && mIndexedCommits % COMMITS_PER_CHECK == 0 && timer.elapsed() >= budgetMs)
+         return false;
+
+      const auto text = searchableText(mRows.at(mIndexedCommits)).toLower().toUtf8();
+
+      for (auto i = 0; i + 2 < text.length(); ++i)
+      {
+         auto &docs = mTrigrams[trigramKey(text.constData() + i)];
+
+         // The documents are indexed in order so the lists stay sorted and without duplicates.
+         if (docs.isEmpty() || docs.constLast() != mIndexedCommits)
+            docs.append(mIndexedCommits);
+      }
+   }
+
+   return true;
+}
+
+QVector<int> CommitsSearchIndex::candidatesFor(const QByteArray &term) const
+{
+   QVector<int> candidates;
+   auto first = true;
+
+   for (auto i = 0; i + 2 < term.length(); ++i)
+   {
+      const auto it = mTrigrams.constFind(trigramKey(term.constData() + i));
+
+      if (it == mTrigrams.constEnd())
+         return {};
+
+      candidates = first ? *it : intersect(candidates, *it);
+      first = false;
+
+      if (candidates.isEmpty())
+         break;
+   }
+
+   return candidates;
+}
+
+QString CommitsSearchIndex::searchableText(int row) const
+{
+   return QString("%1\n%2\n%3\n%4")
+       .arg(mTable.shortLog(row), mTable.longLog(row), mTable.author(row), mTable.committer(row));
+}
@@ -0,0 +1,92 @@
+#pragma once
+
+/****************************************************************************************
+ ** GitQlient is an application to manage and operate one or several Git repositories. With
+ ** GitQlient you will be able to add commits, branches and manage all the options Git provides.
+ ** Copyright (C) 2020  Francesc Martinez
+ **
+ ** LinkedIn: www.linkedin.com/in/cescmm/
+ ** Web: www.francescmm.com
+ **
+ ** This program is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public
+ ** License as published by the Free Software Foundation; either
+ ** version 2 of the License, or (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this library; if not, write to the Free Software
+ ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ***************************************************************************************/
+
+#include <QHash>
+#include <QVector>
+
+class CommitsTable;
+
+/**
+ * @brief The CommitsSearchIndex class is a trigram index over the short log, long log, author and committer of the
+ * commits in the cache. It finds all the commits that contain a text without scanning the whole history.
+ *
+ * The commits are registered while the history is loaded and indexed in small slices while the GUI thread is idle,
+ * so neither the loading nor the first search pay for indexing the whole history at once. A search indexes the
+ * commits that are still pending before looking for the matches.
+ *
+ * @class CommitsSearchIndex CommitsSearchIndex.h "CommitsSearchIndex.h"
+ */
+class CommitsSearchIndex
+{
+public:
+   /**
+    * @brief Creates the index of the commits stored in @p commits.
+    */
+   explicit CommitsSearchIndex(const CommitsTable &commits);
+
+   /**
+    * @brief Removes all the commits from the index.
+    */
+   void clear();
+   /**
+    * @brief Registers a commit to be indexed. The row must keep the commit as long as the index is not cleared.
+    *
+    * @param row The row of the commit in the table.
+    */
+   void addCommit(int row);
+   /**
+    * @brief Moves down the registered commits when rows are inserted in the table.
+    *
+    * @param row The first row that moves.
+    * @param rowsCount The number of inserted rows.
+    */
+   void insertRows(int row, int rowsCount);
+   /**
+    * @brief Searches the commits that match the query. The search is case insensitive.
+    *
+    * If the query is enclosed in slashes (i.e. /fix(ed)?/) it's used as a regular expression. Otherwise, it's split in
+    * terms by the white spaces and a commit matches if it contains all of them.
+    *
+    * @param query The text to search.
+    * @return QVector<int> The rows of all the matching commits in ascending order.
+    */
+   QVector<int> search(const QString &query);
+   /**
+    * @brief Indexes the registered commits that are not indexed yet, stopping once the time budget is spent.
+    *
+    * @param budgetMs The maximum time in milliseconds, or -1 to index all of them.
+    * @return bool True if all the registered commits are indexed.
+    */
+   bool indexPendingCommits(int budgetMs = -1);
+
+private:
+   const CommitsTable &mTable;
+   QVector<int> mRows;
+   int mIndexedCommits = 0;
+   QHash<quint32, QVector<int>> mTrigrams;
+
+   QVector<int> candidatesFor(const QByteArray &term) const;
+   QString searchableText(int row) const;
+};
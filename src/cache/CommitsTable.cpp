@@ -0,0 +1,536 @@
+#include "CommitsTable.h"
+
+#include <CommitInfo.h>
+
+#include <cstring>
+
+namespace
+{
+// Minimum number of buckets of the object table. The number of buckets is always a power of two.
+const auto MIN_BUCKETS = 1024;
+
+// Bytes of the arena that can be unused before the logs are compacted.
+const auto MIN_COMPACTED_LOG_BYTES = 64 * 1024;
+
+int bucketsCount(int objects)
+{
+   auto buckets = MIN_BUCKETS;
+
+   // The buckets are kept at most half full so the probe sequences stay short.
+   while (buckets < 2 * objects)
+      buckets *= 2;
+
+   return buckets;
+}
+
+template<typename T>
+size_t vectorUsage(const QVector<T> &vector)
+{
+   return vector.capacity() == 0 ? 0 : sizeof(QArrayData) + static_cast<size_t>(vector.capacity()) * sizeof(T);
+}
+
+template<typename Key, typename Value>
+size_t hashUsage(const QHash<Key, Value> &hash)
+{
+   // Every entry is a node with the next node, the hash, the key and the value.
+   const auto nodeSize = sizeof(void *) + sizeof(uint) + sizeof(Key) + sizeof(Value);
+
+   return static_cast<size_t>(hash.capacity()) * sizeof(void *) + static_cast<size_t>(hash.count()) * nodeSize;
+}
+}
+
+void CommitsTable::clear()
+{
+   mObjects.clear();
+   mObjectRows.clear();
+   mBuckets.clear();
+   mIdentities.clear();
+   mIdentityIndexes.clear();
+   mLogs.clear();
+   mUnusedLogBytes = 0;
+   mRowObjects.clear();
+   mBoundaryMarks.clear();
+   mFirstParents.clear();
+   mSecondParents.clear();
+   mOtherParents.clear();
+   mCommitters.clear();
+   mAuthors.clear();
+   mDates.clear();
+   mLogOffsets.clear();
+   mShortLogSizes.clear();
+   mLongLogSizes.clear();
+}
+
+void CommitsTable::reserve(int rows)
+{
+   mObjects.reserve(rows);
+   mObjectRows.reserve(rows);
+   mRowObjects.reserve(rows);
+   mBoundaryMarks.reserve(rows);
+   mFirstParents.reserve(rows);
+   mSecondParents.reserve(rows);
+   mCommitters.reserve(rows);
+   mAuthors.reserve(rows);
+   mDates.reserve(rows);
+   mLogOffsets.reserve(rows);
+   mShortLogSizes.reserve(rows);
+   mLongLogSizes.reserve(rows);
+
+   if (const auto buckets = bucketsCount(rows); buckets > mBuckets.count())
+      rehash(buckets);
+}
+
+void CommitsTable::resize(int rows)
+{
+   const auto previousCount = count();
+
+   for (auto row = rows; row < previousCount; ++row)
+      releaseRow(row);
+
+   mRowObjects.resize(rows);
+   mBoundaryMarks.resize(rows);
+   mFirstParents.resize(rows);
+   mSecondParents.resize(rows);
+   mCommitters.resize(rows);
+   mAuthors.resize(rows);
+   mDates.resize(rows);
+   mLogOffsets.resize(rows);
+   mShortLogSizes.resize(rows);
+   mLongLogSizes.resize(rows);
+
+   for (auto row = previousCount; row < rows; ++row)
+      mRowObjects[row] = -1;
+}
+
+void CommitsTable::insertRows(int row, int rowsCount)
+{
+   mRowObjects.insert(row, rowsCount, -1);
+   mBoundaryMarks.insert(row, rowsCount, 0);
+   mFirstParents.insert(row, rowsCount, -1);
+   mSecondParents.insert(row, rowsCount, -1);
+   mCommitters.insert(row, rowsCount, 0);
+   mAuthors.insert(row, rowsCount, 0);
+   mDates.insert(row, rowsCount, 0);
+   mLogOffsets.insert(row, rowsCount, 0);
+   mShortLogSizes.insert(row, rowsCount, 0);
+   mLongLogSizes.insert(row, rowsCount, 0);
+
+   for (auto &objectRow : mObjectRows)
+   {
+      if (objectRow >= row)
+         objectRow += rowsCount;
+   }
+
+   if (!mOtherParents.isEmpty())
+   {
+      QHash<int, QVector<int>> otherParents;
+
+      for (auto it = mOtherParents.cbegin(); it != mOtherParents.cend(); ++it)
+         otherParents.insert(it.key() >= row ? it.key() + rowsCount : it.key(), it.value());
+
+      mOtherParents = otherParents;
+   }
+}
+
+void CommitsTable::setCommit(int row, const CommitInfo &commit)
+{
+   if (row < 0 || row >= count() || commit.mId.isNull())
+      return;
+
+   const auto object = addObject(commit.mId);
+
+   // A reload stores the same commits in the same rows most of the time.
+   if (mRowObjects.at(row) == object && isSameCommit(row, commit))
+   {
+      mObjectRows[object] = row;
+      return;
+   }
+
+   releaseRow(row);
+
+   mRowObjects[row] = object;
+   mObjectRows[object] = row;
+   mBoundaryMarks[row] = commit.mBoundaryInfo.toLatin1();
+
+   const auto &parents = commit.mParents;
+
+   mFirstParents[row] = parents.isEmpty() ? -1 : addObject(parents.at(0));
+   mSecondParents[row] = parents.count() < 2 ? -1 : addObject(parents.at(1));
+
+   if (parents.count() > 2)
+   {
+      QVector<int> otherParents;
+      otherParents.reserve(parents.count() - 2);
+
+      for (auto i = 2; i < parents.count(); ++i)
+         otherParents.append(addObject(parents.at(i)));
+
+      mOtherParents.insert(row, otherParents);
+   }
+
+   mCommitters[row] = addIdentity(commit.mCommitter);
+   mAuthors[row] = addIdentity(commit.mAuthor);
+   mDates[row] = commit.mCommitDate;
+
+   storeLogs(row, commit.mShortLog, commit.mLongLog);
+}
+
+CommitInfo CommitsTable::commit(int row) const
+{
+   CommitInfo commit;
+
+   if (!hasCommit(row))
+      return commit;
+
+   const auto offset = mLogOffsets.at(row);
+   const auto shortLogSize = mShortLogSizes.at(row);
+
+   commit.mBoundaryInfo = QChar::fromLatin1(mBoundaryMarks.at(row));
+   commit.mId = mObjects.at(mRowObjects.at(row));
+   commit.mParents = parentIds(row);
+   commit.mCommitter = mIdentities.at(mCommitters.at(row));
+   commit.mAuthor = mIdentities.at(mAuthors.at(row));
+   commit.mCommitDate = mDates.at(row);
+   commit.mShortLog = mLogs.mid(offset, shortLogSize);
+   commit.mLongLog = mLogs.mid(offset + shortLogSize, mLongLogSizes.at(row));
+   commit.mRow = row;
+
+   return commit;
+}
+
+ObjectId CommitsTable::id(int row) const
+{
+   return hasCommit(row) ? mObjects.at(mRowObjects.at(row)) : ObjectId();
+}
+
+QVector<ObjectId> CommitsTable::parentIds(int row) const
+{
+   QVector<ObjectId> parents;
+
+   if (!hasCommit(row) || mFirstParents.at(row) == -1)
+      return parents;
+
+   parents.append(mObjects.at(mFirstParents.at(row)));
+
+   if (mSecondParents.at(row) != -1)
+   {
+      parents.append(mObjects.at(mSecondParents.at(row)));
+
+      for (const auto object : mOtherParents.value(row))
+         parents.append(mObjects.at(object));
+   }
+
+   return parents;
+}
+
+QString CommitsTable::shortLog(int row) const
+{
+   return hasCommit(row) ? QString::fromUtf8(mLogs.constData() + mLogOffsets.at(row), mShortLogSizes.at(row))
+                         : QString();
+}
+
+QString CommitsTable::longLog(int row) const
+{
+   return hasCommit(row) ? QString::fromUtf8(mLogs.constData() + mLogOffsets.at(row) + mShortLogSizes.at(row),
+                                             mLongLogSizes.at(row))
+                         : QString();
+}
+
+QString CommitsTable::author(int row) const
+{
+   return hasCommit(row) ? mIdentities.at(mAuthors.at(row)) : QString();
+}
+
+QString CommitsTable::committer(int row) const
+{
+   return hasCommit(row) ? mIdentities.at(mCommitters.at(row)) : QString();
+}
+
+int CommitsTable::row(const ObjectId &id) const
+{
+   const auto object = findObject(id);
+
+   return object == -1 ? -1 : mObjectRows.at(object);
+}
+
+void CommitsTable::unmapId(const ObjectId &id)
+{
+   if (const auto object = findObject(id); object != -1)
+      mObjectRows[object] = -1;
+}
+
+void CommitsTable::unmapIds()
+{
+   mObjectRows.fill(-1);
+}
+
+CommitGraph CommitsTable::graph() const
+{
+   CommitGraph graph;
+   graph.parentsOffsets.reserve(count() + 1);
+   graph.parents.reserve(count());
+   graph.parentsOffsets.append(0);
+
+   const auto appendParent = [this, &graph](int object) {
+      if (const auto row = mObjectRows.at(object); row != -1)
+         graph.parents.append(row);
+   };
+
+   for (auto row = 0; row < count(); ++row)
+   {
+      if (mRowObjects.at(row) != -1 && mFirstParents.at(row) != -1)
+      {
+         appendParent(mFirstParents.at(row));
+
+         if (mSecondParents.at(row) != -1)
+         {
+            appendParent(mSecondParents.at(row));
+
+            for (const auto object : mOtherParents.value(row))
+               appendParent(object);
+         }
+      }
+
+      graph.parentsOffsets.append(graph.parents.count());
+   }
+
+   return graph;
+}
+
+void CommitsTable::squeeze()
+{
+   if (mUnusedLogBytes > 0)
+      compactLogs();
+
+   // Only the reloads of a rewritten history leave ids that no row uses.
+   if (mObjects.count() - count() > count() / 4)
+      compactObjects();
+
+   mObjects.squeeze();
+   mObjectRows.squeeze();
+   mLogs.squeeze();
+   mRowObjects.squeeze();
+   mBoundaryMarks.squeeze();
+   mFirstParents.squeeze();
+   mSecondParents.squeeze();
+   mCommitters.squeeze();
+   mAuthors.squeeze();
+   mDates.squeeze();
+   mLogOffsets.squeeze();
+   mShortLogSizes.squeeze();
+   mLongLogSizes.squeeze();
+}
+
+size_t CommitsTable::memoryUsage() const
+{
+   auto usage = sizeof(CommitsTable);
+
+   usage += vectorUsage(mObjects) + vectorUsage(mObjectRows) + vectorUsage(mBuckets);
+
+   // The keys of the hash share the data of the identities.
+   usage += vectorUsage(mIdentities) + hashUsage(mIdentityIndexes);
+
+   for (const auto &identity : mIdentities)
+      usage += sizeof(QArrayData) + static_cast<size_t>(identity.capacity() + 1) * sizeof(QChar);
+
+   usage += sizeof(QArrayData) + static_cast<size_t>(mLogs.capacity());
+   usage += vectorUsage(mRowObjects) + vectorUsage(mBoundaryMarks) + vectorUsage(mFirstParents)
+       + vectorUsage(mSecondParents) + vectorUsage(mCommitters) + vectorUsage(mAuthors) + vectorUsage(mDates)
+       + vectorUsage(mLogOffsets) + vectorUsage(mShortLogSizes) + vectorUsage(mLongLogSizes);
+   usage += hashUsage(mOtherParents);
+
+   for (const auto &otherParents : mOtherParents)
+      usage += vectorUsage(otherParents);
+
+   return usage;
+}
+
+int CommitsTable::findObject(const ObjectId &id) const
+{
+   if (mBuckets.isEmpty() || id.isNull())
+      return -1;
+
+   const auto mask = mBuckets.count() - 1;
+
+   for (auto bucket = static_cast<int>(qHash(id) & static_cast<uint>(mask));; bucket = (bucket + 1) & mask)
+   {
+      const auto object = mBuckets.at(bucket);
+
+      if (object == -1 || mObjects.at(object) == id)
+         return object;
+   }
+}
+
+int CommitsTable::addObject(const ObjectId &id)
+{
+   if (id.isNull())
+      return -1;
+
+   if (const auto object = findObject(id); object != -1)
+      return object;
+
+   if (const auto buckets = bucketsCount(mObjects.count() + 1); buckets > mBuckets.count())
+      rehash(buckets);
+
+   const auto mask = mBuckets.count() - 1;
+   auto bucket = static_cast<int>(qHash(id) & static_cast<uint>(mask));
+
+   while (mBuckets.at(bucket) != -1)
+      bucket = (bucket + 1) & mask;
+
+   mBuckets[bucket] = mObjects.count();
+   mObjects.append(id);
+   mObjectRows.append(-1);
+
+   return mObjects.count() - 1;
+}
+
+void CommitsTable::rehash(int bucketsCount)
+{
+   mBuckets.fill(-1, bucketsCount);
+
+   const auto mask = bucketsCount - 1;
+
+   for (auto object = 0; object < mObjects.count(); ++object)
+   {
+      auto bucket = static_cast<int>(qHash(mObjects.at(object)) & static_cast<uint>(mask));
+
+      while (mBuckets.at(bucket) != -1)
+         bucket = (bucket + 1) & mask;
+
+      mBuckets[bucket] = object;
+   }
+}
+
+int CommitsTable::addIdentity(const QString &identity)
+{
+   auto it = mIdentityIndexes.constFind(identity);
+
+   if (it == mIdentityIndexes.constEnd())
+   {
+      it = mIdentityIndexes.insert(identity, mIdentities.count());
+      mIdentities.append(identity);
+   }
+
+   return it.value();
+}
+
+bool CommitsTable::isSameCommit(int row, const CommitInfo &commit) const
+{
+   const auto offset = mLogOffsets.at(row);
+   const auto shortLogSize = mShortLogSizes.at(row);
+
+   const auto shortLog = QByteArray::fromRawData(mLogs.constData() + offset, shortLogSize);
+   const auto longLog = QByteArray::fromRawData(mLogs.constData() + offset + shortLogSize, mLongLogSizes.at(row));
+
+   return mBoundaryMarks.at(row) == commit.mBoundaryInfo.toLatin1() && mDates.at(row) == commit.mCommitDate
+       && mIdentities.at(mCommitters.at(row)) == commit.mCommitter && mIdentities.at(mAuthors.at(row)) == commit.mAuthor
+       && parentIds(row) == commit.mParents && shortLog == commit.mShortLog && longLog == commit.mLongLog;
+}
+
+void CommitsTable::releaseRow(int row)
+{
+   const auto object = mRowObjects.at(row);
+
+   if (object == -1)
+      return;
+
+   // The commit could be in another row already if the history changed since the previous load.
+   if (mObjectRows.at(object) == row)
+      mObjectRows[object] = -1;
+
+   mOtherParents.remove(row);
+   mUnusedLogBytes += mShortLogSizes.at(row) + mLongLogSizes.at(row);
+   mRowObjects[row] = -1;
+}
+
+void CommitsTable::storeLogs(int row, const QByteArray &shortLog, const QByteArray &longLog)
+{
+   const auto size = shortLog.size() + longLog.size();
+
+   // The logs of a released row are replaced in place when the new ones fit, like the ones of the WIP commit do.
+   if (size > 0 && size <= mShortLogSizes.at(row) + mLongLogSizes.at(row))
+   {
+      const auto data = mLogs.data() + mLogOffsets.at(row);
+
+      std::memcpy(data, shortLog.constData(), static_cast<size_t>(shortLog.size()));
+      std::memcpy(data + shortLog.size(), longLog.constData(), static_cast<size_t>(longLog.size()));
+
+      mUnusedLogBytes -= size;
+   }
+   else
+   {
+      mLogOffsets[row] = mLogs.size();
+      mLogs.append(shortLog).append(longLog);
+   }
+
+   mShortLogSizes[row] = shortLog.size();
+   mLongLogSizes[row] = longLog.size();
+
+   if (mUnusedLogBytes > MIN_COMPACTED_LOG_BYTES && mUnusedLogBytes > mLogs.size() / 2)
+      compactLogs();
+}
+
+void CommitsTable::compactLogs()
+{
+   QByteArray logs;
+   logs.reserve(mLogs.size() - mUnusedLogBytes);
+
+   for (auto row = 0; row < count(); ++row)
+   {
+      if (mRowObjects.at(row) == -1)
+      {
+         mShortLogSizes[row] = 0;
+         mLongLogSizes[row] = 0;
+      }
+
+      const auto offset = logs.size();
+
+      logs.append(mLogs.constData() + mLogOffsets.at(row), mShortLogSizes.at(row) + mLongLogSizes.at(row));
+      mLogOffsets[row] = offset;
+   }
+
+   mLogs = logs;
+   mUnusedLogBytes = 0;
+}
+
+void CommitsTable::compactObjects()
+{
+   QVector<int> newIndexes(mObjects.count(), -1);
+   QVector<ObjectId> objects;
+   QVector<int> objectRows;
+
+   const auto keep = [&](int object) {
+      if (object == -1)
+         return -1;
+
+      auto &newIndex = newIndexes[object];
+
+      if (newIndex == -1)
+      {
+         newIndex = objects.count();
+         objects.append(mObjects.at(object));
+         objectRows.append(mObjectRows.at(object));
+      }
+
+      return newIndex;
+   };
+
+   for (auto row = 0; row < count(); ++row)
+   {
+      mRowObjects[row] = keep(mRowObjects.at(row));
+      mFirstParents[row] = mRowObjects.at(row) == -1 ? -1 : keep(mFirstParents.at(row));
+      mSecondParents[row] = mRowObjects.at(row) == -1 ? -1 : keep(mSecondParents.at(row));
+   }
+
+   for (auto &otherParents : mOtherParents)
+   {
+      for (auto &object : otherParents)
+         object = keep(object);
+   }
+
+   mObjects = objects;
+   mObjectRows = objectRows;
+
+   rehash(bucketsCount(mObjects.count()));
+}
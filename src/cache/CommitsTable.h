@@ -0,0 +1,159 @@
+#pragma once
+
+/****************************************************************************************
+ ** GitQlient is an application to manage and operate one or several Git repositories. With
+ ** GitQlient you will be able to add commits, branches and manage all the options Git provides.
+ ** Copyright (C) 2020  Francesc Martinez
+ **
+ ** LinkedIn: www.linkedin.com/in/cescmm/
+ ** Web: www.francescmm.com
+ **
+ ** This program is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public
+ ** License as published by the Free Software Foundation; either
+ ** version 2 of the License, or (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this library; if not, write to the Free Software
+ ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ***************************************************************************************/
+
+#include <CommitGraph.h>
+#include <ObjectId.h>
+
+#include <QByteArray>
+#include <QHash>
+#include <QString>
+#include <QVector>
+
+class CommitInfo;
+
+/**
+ * @brief The CommitsTable class stores the loaded history as a table of columns indexed by row instead of one object
+ * per commit. Every field of the commits is kept in its own contiguous vector:
+ *
+ * - The object ids of the commits and their parents are stored once in an object table. The rows and the parents
+ * refer to them by their index, so a parent costs four bytes and the graph is walked without hashing any id. The
+ * table is indexed by an open addressing hash of object indexes that doesn't copy the ids again.
+ * - The identities of the authors and the committers are interned and referenced by index.
+ * - The short and long logs of all the commits are stored in a single UTF-8 arena, with the offset and the sizes of
+ * every row in the columns.
+ *
+ * A row is read back as a @ref CommitInfo built from the columns, which is how the rest of the application sees the
+ * commits. The lanes and the references are not stored here.
+ *
+ * The rows of a previous load are overwritten by the next one. The logs that are not used anymore are discarded
+ * when they take more than half of the arena and by @ref squeeze.
+ *
+ * @class CommitsTable CommitsTable.h "CommitsTable.h"
+ */
+class CommitsTable
+{
+public:
+   /**
+    * @brief Returns the number of rows, including the empty ones.
+    */
+   int count() const { return mRowObjects.count(); }
+   /**
+    * @brief Removes all the rows and the data they use.
+    */
+   void clear();
+   /**
+    * @brief Reserves the memory of the columns for @p rows rows.
+    */
+   void reserve(int rows);
+   /**
+    * @brief Sets the number of rows. The new rows are empty and the removed ones release their data.
+    */
+   void resize(int rows);
+   /**
+    * @brief Inserts @p rowsCount empty rows before @p row. The rows below move down.
+    */
+   void insertRows(int row, int rowsCount);
+   /**
+    * @brief Stores the commit in the row, replacing the commit the row had. The id of the commit is mapped to the row.
+    */
+   void setCommit(int row, const CommitInfo &commit);
+   /**
+    * @brief Returns true if the row holds a commit.
+    */
+   bool hasCommit(int row) const { return row >= 0 && row < mRowObjects.count() && mRowObjects.at(row) != -1; }
+   /**
+    * @brief Builds the commit stored in the row, without lanes nor references. It's invalid if the row is empty.
+    */
+   CommitInfo commit(int row) const;
+
+   ObjectId id(int row) const;
+   QVector<ObjectId> parentIds(int row) const;
+   QString shortLog(int row) const;
+   QString longLog(int row) const;
+   QString author(int row) const;
+   QString committer(int row) const;
+
+   /**
+    * @brief Returns the row mapped to the commit id, or -1 if there is none.
+    */
+   int row(const ObjectId &id) const;
+   /**
+    * @brief Removes the mapping of the commit id to its row. The row keeps the commit.
+    */
+   void unmapId(const ObjectId &id);
+   /**
+    * @brief Removes the mapping of all the ids, so a new load can store the same commits again while the rows of the
+    * previous one are still shown.
+    */
+   void unmapIds();
+
+   /**
+    * @brief Returns the parents of all the rows as row indexes. The parents that aren't in the table are left out.
+    */
+   CommitGraph graph() const;
+
+   /**
+    * @brief Releases the data that is not used by any row and the unused capacity of the columns.
+    */
+   void squeeze();
+   /**
+    * @brief Returns the bytes of memory used by the table.
+    */
+   size_t memoryUsage() const;
+
+private:
+   // The object table: the ids, the rows they are mapped to, and the hash buckets with the index of the ids.
+   QVector<ObjectId> mObjects;
+   QVector<int> mObjectRows;
+   QVector<int> mBuckets;
+   // The identities of the authors and committers.
+   QVector<QString> mIdentities;
+   QHash<QString, int> mIdentityIndexes;
+   // The logs of all the rows, stored in UTF-8.
+   QByteArray mLogs;
+   int mUnusedLogBytes = 0;
+   // The columns. Most commits have one or two parents, the rest of them are stored apart by row.
+   QVector<int> mRowObjects;
+   QVector<char> mBoundaryMarks;
+   QVector<int> mFirstParents;
+   QVector<int> mSecondParents;
+   QHash<int, QVector<int>> mOtherParents;
+   QVector<int> mCommitters;
+   QVector<int> mAuthors;
+   QVector<qint64> mDates;
+   QVector<int> mLogOffsets;
+   QVector<int> mShortLogSizes;
+   QVector<int> mLongLogSizes;
+
+   int findObject(const ObjectId &id) const;
+   int addObject(const ObjectId &id);
+   void rehash(int bucketsCount);
+   int addIdentity(const QString &identity);
+   bool isSameCommit(int row, const CommitInfo &commit) const;
+   void releaseRow(int row);
+   void storeLogs(int row, const QByteArray &shortLog, const QByteArray &longLog);
+   void compactLogs();
+   void compactObjects();
+};
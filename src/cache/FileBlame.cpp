@@ -0,0 +1,108 @@
+#include "FileBlame.h"
+
+#include <algorithm>
+
+namespace
+{
+const auto TAB_SIZE = 4;
+}
+
+void FileBlame::setContents(const QByteArray &contents)
+{
+   mContents = contents;
+   mLineStarts.clear();
+   mMaxLineLength = 0;
+
+   auto start = 0;
+
+   while (start < mContents.size())
+   {
+      mLineStarts.append(start);
+
+      auto end = mContents.indexOf('\n', start);
+
+      if (end == -1)
+         end = mContents.size();
+
+      const auto tabs = static_cast<int>(std::count(mContents.cbegin() + start, mContents.cbegin() + end, '\t'));
+      mMaxLineLength = qMax(mMaxLineLength, end - start + tabs * (TAB_SIZE - 1));
+
+      start = end + 1;
+   }
+
+   const auto blamedLines = mLineCommits.count();
+
+   if (blamedLines < mLineStarts.count())
+   {
+      mLineCommits.resize(mLineStarts.count());
+      std::fill(mLineCommits.begin() + blamedLines, mLineCommits.end(), -1);
+   }
+
+   // The lines that git blamed beyond the contents are shown empty.
+   while (mLineStarts.count() < mLineCommits.count())
+      mLineStarts.append(mContents.size());
+}
+
+QString FileBlame::line(int line) const
+{
+   if (line < 0 || line >= mLineStarts.count())
+      return QString();
+
+   const auto start = mLineStarts.at(line);
+   auto end = mContents.indexOf('\n', start);
+
+   if (end == -1)
+      end = mContents.size();
+
+   if (end > start && mContents.at(end - 1) == '\r')
+      --end;
+
+   return QString::fromUtf8(mContents.constData() + start, qMax(0, end - start));
+}
+
+int FileBlame::addCommit(const Commit &commit)
+{
+   const auto iter = mCommitIndexes.constFind(commit.sha);
+
+   if (iter != mCommitIndexes.cend())
+      return iter.value();
+
+   const auto index = mCommits.count();
+
+   mCommits.append(commit);
+   mCommitIndexes.insert(commit.sha, index);
+
+   if (!commit.boundary && commit.authorTime > 0)
+   {
+      mOldestTime = mOldestTime == 0 ? commit.authorTime : qMin(mOldestTime, commit.authorTime);
+      mNewestTime = qMax(mNewestTime, commit.authorTime);
+   }
+
+   return index;
+}
+
+void FileBlame::setLinesCommit(int firstLine, int count, int commitIndex)
+{
+   if (firstLine < 0 || count <= 0)
+      return;
+
+   const auto previousCount = mLineCommits.count();
+
+   if (firstLine + count > previousCount)
+   {
+      mLineCommits.resize(firstLine + count);
+      std::fill(mLineCommits.begin() + previousCount, mLineCommits.end(), -1);
+   }
+
+   std::fill(mLineCommits.begin() + firstLine, mLineCommits.begin() + firstLine + count, commitIndex);
+}
+
+int FileBlame::memorySize() const
+{
+   auto size = mContents.size() + (mLineStarts.count() + mLineCommits.count()) * static_cast<int>(sizeof(int));
+
+   for (const auto &commit : mCommits)
+      size += (commit.sha.size() + commit.author.size() + commit.summary.size()) * 2 + static_cast<int>(sizeof(Commit));
+
+   return size;
+}
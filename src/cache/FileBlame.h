@@ -0,0 +1,123 @@
+#pragma once
+
+/****************************************************************************************
+ ** GitQlient is an application to manage and operate one or several Git repositories. With
+ ** GitQlient you will be able to add commits, branches and manage all the options Git provides.
+ ** Copyright (C) 2020  Francesc Martinez
+ **
+ ** LinkedIn: www.linkedin.com/in/cescmm/
+ ** Web: www.francescmm.com
+ **
+ ** This program is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public
+ ** License as published by the Free Software Foundation; either
+ ** version 2 of the License, or (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this library; if not, write to the Free Software
+ ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ***************************************************************************************/
+
+#include <QByteArray>
+#include <QHash>
+#include <QString>
+#include <QVector>
+
+/**
+ * @brief The FileBlame class stores the blame of a file in a compact way: the commits that appear in it are stored
+ * once and every line only keeps the index of its commit. The contents of the file are kept as a single buffer with the
+ * offsets where every line starts, so a blame of a big file only needs a few allocations.
+ *
+ * The lines can be blamed in any order, so the blame can be filled while git is still producing it.
+ *
+ * @class FileBlame FileBlame.h "FileBlame.h"
+ */
+class FileBlame
+{
+public:
+   /**
+    * @brief The information of a commit that last modified any line of the file.
+    */
+   struct Commit
+   {
+      QString sha;
+      QString author;
+      qint64 authorTime = 0;
+      QString summary;
+      bool boundary = false;
+   };
+
+   /**
+    * @brief Sets the contents of the file. The lines that were already blamed are kept.
+    *
+    * @param contents The raw contents of the file.
+    */
+   void setContents(const QByteArray &contents);
+   /**
+    * @brief Returns the number of lines of the file, or the number of lines blamed so far if the contents are not set.
+    */
+   int lineCount() const { return mLineCommits.count(); }
+   /**
+    * @brief Returns the text of the line @p line, without the end of line.
+    */
+   QString line(int line) const;
+   /**
+    * @brief Returns the length of the longest line, counting every tab as 4 characters.
+    */
+   int maxLineLength() const { return mMaxLineLength; }
+
+   /**
+    * @brief Adds a commit if it's not stored yet.
+    *
+    * @param commit The commit information.
+    * @return int The index of the commit.
+    */
+   int addCommit(const Commit &commit);
+   /**
+    * @brief Returns the index of the commit with SHA @p sha or -1 if it's not part of the blame.
+    */
+   int commitIndex(const QString &sha) const { return mCommitIndexes.value(sha, -1); }
+   int commitsCount() const { return mCommits.count(); }
+   const Commit &commit(int index) const { return mCommits.at(index); }
+   /**
+    * @brief Assigns the lines [@p firstLine, @p firstLine + @p count) to the commit @p commitIndex.
+    */
+   void setLinesCommit(int firstLine, int count, int commitIndex);
+   /**
+    * @brief Returns the index of the commit of the line @p line or -1 if it's not blamed yet.
+    */
+   int lineCommit(int line) const { return mLineCommits.at(line); }
+   /**
+    * @brief Tells if the commit of @p line is not the same one than the commit of the previous line.
+    */
+   bool startsBlock(int line) const { return line == 0 || mLineCommits.at(line) != mLineCommits.at(line - 1); }
+
+   /**
+    * @brief Returns the date of the oldest commit of the blame, or 0 if there are none. The boundary commits are not
+    * taken into account.
+    */
+   qint64 oldestTime() const { return mOldestTime; }
+   /**
+    * @brief Returns the date of the newest commit of the blame, or 0 if there are none.
+    */
+   qint64 newestTime() const { return mNewestTime; }
+   /**
+    * @brief Returns the approximated memory used by the blame, in bytes.
+    */
+   int memorySize() const;
+
+private:
+   QByteArray mContents;
+   QVector<int> mLineStarts;
+   int mMaxLineLength = 0;
+   QVector<Commit> mCommits;
+   QHash<QString, int> mCommitIndexes;
+   QVector<int> mLineCommits;
+   qint64 mOldestTime = 0;
+   qint64 mNewestTime = 0;
+};
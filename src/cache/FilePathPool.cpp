@@ -0,0 +1,115 @@
+#include "FilePathPool.h"
+
+namespace
+{
+/**
+ * @brief Returns the position where the file name of @p path starts, right after its last separator.
+ */
+int fileNameStart(const char *path, int size)
+{
+   auto separator = size;
+
+   while (separator > 0 && path[separator - 1] != '/')
+      --separator;
+
+   return separator;
+}
+
+/**
+ * @brief Returns the index of @p value in the pool, adding it if needed. The caller must hold the write lock.
+ */
+int internString(const QByteArray &value, QVector<QByteArray> &strings, QHash<QByteArray, int> &indexes)
+{
+   const auto iter = indexes.constFind(value);
+
+   if (iter != indexes.cend())
+      return iter.value();
+
+   // The value can point to the buffer of the caller, so the pool keeps its own copy.
+   const QByteArray copy(value.constData(), value.size());
+   const auto index = strings.count();
+
+   strings.append(copy);
+   indexes.insert(copy, index);
+
+   return index;
+}
+}
+
+FilePathPool &FilePathPool::instance()
+{
+   static FilePathPool pool;
+
+   return pool;
+}
+
+FilePathPool::PathId FilePathPool::intern(const QString &path)
+{
+   const auto utf8 = path.toUtf8();
+
+   return intern(utf8.constData(), utf8.size());
+}
+
+FilePathPool::PathId FilePathPool::intern(const char *path, int size)
+{
+   const auto separator = fileNameStart(path, size);
+   const auto dir = QByteArray::fromRawData(path, separator);
+   const auto name = QByteArray::fromRawData(path + separator, size - separator);
+
+   PathId id;
+
+   // Most of the paths were already seen, so they are looked up first without blocking the other readers.
+   {
+      QReadLocker lock(&mLock);
+
+      id.dir = mDirIndexes.value(dir, -1);
+      id.name = mNameIndexes.value(name, -1);
+   }
+
+   if (id.isValid())
+      return id;
+
+   QWriteLocker lock(&mLock);
+
+   id.dir = internString(dir, mDirs, mDirIndexes);
+   id.name = internString(name, mNames, mNameIndexes);
+
+   return id;
+}
+
+FilePathPool::PathId FilePathPool::find(const QString &path) const
+{
+   const auto utf8 = path.toUtf8();
+   const auto separator = fileNameStart(utf8.constData(), utf8.size());
+   const auto dir = QByteArray::fromRawData(utf8.constData(), separator);
+   const auto name = QByteArray::fromRawData(utf8.constData() + separator, utf8.size() - separator);
+
+   QReadLocker lock(&mLock);
+
+   PathId id;
+   id.dir = mDirIndexes.value(dir, -1);
+   id.name = id.dir != -1 ? mNameIndexes.value(name, -1) : -1;
+
+   return id;
+}
+
+QString FilePathPool::path(PathId id) const
+{
+   QReadLocker lock(&mLock);
+
+   return QString::fromUtf8(mDirs.at(id.dir) + mNames.at(id.name));
+}
+
+int FilePathPool::dirsCount() const
+{
+   QReadLocker lock(&mLock);
+
+   return mDirs.count();
+}
+
+int FilePathPool::namesCount() const
+{
+   QReadLocker lock(&mLock);
+
+   return mNames.count();
+}
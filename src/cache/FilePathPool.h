@@ -0,0 +1,105 @@
+#pragma once
+
+/****************************************************************************************
+ ** GitQlient is an application to manage and operate one or several Git repositories. With
+ ** GitQlient you will be able to add commits, branches and manage all the options Git provides.
+ ** Copyright (C) 2020  Francesc Martinez
+ **
+ ** LinkedIn: www.linkedin.com/in/cescmm/
+ ** Web: www.francescmm.com
+ **
+ ** This program is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public
+ ** License as published by the Free Software Foundation; either
+ ** version 2 of the License, or (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this library; if not, write to the Free Software
+ ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ***************************************************************************************/
+
+#include <QByteArray>
+#include <QHash>
+#include <QReadWriteLock>
+#include <QString>
+#include <QVector>
+
+/**
+ * @brief The FilePathPool class interns the paths of the files that appear in the revisions. Every path is split in its
+ * directory and its file name, and each of them is stored only once in a pool indexed by a hash table. A path is then
+ * identified by the pair of indexes, so the lists of files of the revisions don't duplicate the strings and comparing
+ * two paths is comparing two integers.
+ *
+ * The names are stored as the UTF-8 bytes git writes, so the parsers can intern a path straight from the output buffer
+ * and it's only decoded to QString when it's requested.
+ *
+ * There is a single pool shared by all the @ref RevisionFiles. The names are never removed, so an identifier stays
+ * valid for the whole execution. The pool can be used from any thread.
+ *
+ * @class FilePathPool FilePathPool.h "FilePathPool.h"
+ */
+class FilePathPool
+{
+public:
+   /**
+    * @brief The identifier of an interned path.
+    */
+   struct PathId
+   {
+      int dir = -1;
+      int name = -1;
+
+      bool isValid() const { return dir != -1 && name != -1; }
+      bool operator==(const PathId &other) const { return dir == other.dir && name == other.name; }
+      bool operator!=(const PathId &other) const { return !(*this == other); }
+   };
+
+   /**
+    * @brief Returns the pool shared by all the revisions.
+    */
+   static FilePathPool &instance();
+
+   /**
+    * @brief Returns the identifier of @p path, adding it to the pool if it's not there yet.
+    */
+   PathId intern(const QString &path);
+   /**
+    * @brief Returns the identifier of the UTF-8 encoded path that starts at @p path and has @p size bytes. The bytes
+    * are only copied the first time the directory or the file name is seen.
+    */
+   PathId intern(const char *path, int size);
+   /**
+    * @brief Returns the identifier of @p path without adding it. It's invalid if the path was never interned.
+    */
+   PathId find(const QString &path) const;
+   /**
+    * @brief Returns the full path of the identifier @p id.
+    */
+   QString path(PathId id) const;
+
+   /**
+    * @brief Returns the number of different directories in the pool.
+    */
+   int dirsCount() const;
+   /**
+    * @brief Returns the number of different file names in the pool.
+    */
+   int namesCount() const;
+
+private:
+   mutable QReadWriteLock mLock;
+   QVector<QByteArray> mDirs;
+   QHash<QByteArray, int> mDirIndexes;
+   QVector<QByteArray> mNames;
+   QHash<QByteArray, int> mNameIndexes;
+};
+
+inline uint qHash(const FilePathPool::PathId &id, uint seed = 0)
+{
+   return qHash((static_cast<quint64>(static_cast<quint32>(id.dir)) << 32) | static_cast<quint32>(id.name), seed);
+}
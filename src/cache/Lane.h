@@ -1,6 +1,6 @@
 #pragma once
 
-enum class LaneType;
+enum class LaneType : unsigned char;
 
 class Lane
 {
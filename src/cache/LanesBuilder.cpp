@@ -0,0 +1,42 @@
+#include "LanesBuilder.h"
+
+LanesBuilder::LanesBuilder(QObject *parent)
+   : QObject(parent)
+{
+}
+
+void LanesBuilder::reset(const ObjectId &wipParentId)
+{
+   mLanes.clear();
+
+   // The first row is always the WIP commit.
+   mNextRow = 1;
+
+   if (!wipParentId.isNull())
+   {
+      mLanes.init(CommitInfo::ZERO_ID);
+      mLanes.advance(CommitInfo::ZERO_ID, { wipParentId });
+   }
+}
+
+void LanesBuilder::calculateLanes(const QVector<CommitInfo> &commits)
+{
+   for (const auto &commit : commits)
+   {
+      if (mLanes.isEmpty())
+         mLanes.init(commit.id());
+
+      if ((mNextRow - 1) % CHECKPOINT_INTERVAL == 0)
+         emit signalLanesCheckpoint(mNextRow, mLanes);
+
+      mLanes.advance(commit.id(), commit.parentIds());
+      ++mNextRow;
+   }
+
+   emit signalLanesReady(commits);
+}
+
+void LanesBuilder::finish()
+{
+   emit signalFinished();
+}
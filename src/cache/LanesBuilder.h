@@ -0,0 +1,88 @@
+#pragma once
+
+/****************************************************************************************
+ ** GitQlient is an application to manage and operate one or several Git repositories. With
+ ** GitQlient you will be able to add commits, branches and manage all the options Git provides.
+ ** Copyright (C) 2020  Francesc Martinez
+ **
+ ** LinkedIn: www.linkedin.com/in/cescmm/
+ ** Web: www.francescmm.com
+ **
+ ** This program is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public
+ ** License as published by the Free Software Foundation; either
+ ** version 2 of the License, or (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this library; if not, write to the Free Software
+ ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ***************************************************************************************/
+
+#include <CommitInfo.h>
+#include <lanes.h>
+
+#include <QObject>
+#include <QVector>
+
+/**
+ * @brief The LanesBuilder class is the last stage of the repository loading pipeline. It lives in its own thread and
+ * follows the state of the graph lanes through the commits that the GitLogParser has already parsed. The lanes of
+ * every row are not stored: the state is saved every few rows as a checkpoint, so the RevisionsCache can calculate
+ * the lanes of any row on demand replaying only a few commits.
+ *
+ * @class LanesBuilder LanesBuilder.h "LanesBuilder.h"
+ */
+class LanesBuilder : public QObject
+{
+   Q_OBJECT
+
+signals:
+   /**
+    * @brief Signal triggered when a batch of commits has been processed and is ready to be stored in the cache.
+    *
+    * @param commits The commits of the batch.
+    */
+   void signalLanesReady(const QVector<CommitInfo> &commits);
+   /**
+    * @brief Signal triggered every CHECKPOINT_INTERVAL rows with the state of the lanes before processing the row.
+    *
+    * @param row The row of the history.
+    * @param lanes The state of the lanes.
+    */
+   void signalLanesCheckpoint(int row, const Lanes &lanes);
+   /**
+    * @brief Signal triggered when all the batches have been processed.
+    */
+   void signalFinished();
+
+public:
+   static constexpr int CHECKPOINT_INTERVAL = 1000;
+
+   explicit LanesBuilder(QObject *parent = nullptr);
+
+   /**
+    * @brief Resets the lanes state. The graph starts with the WIP commit, which is child of the current HEAD.
+    *
+    * @param wipParentId The id of the current HEAD. If it's null the graph starts with the first commit received.
+    */
+   void reset(const ObjectId &wipParentId);
+   /**
+    * @brief Processes a batch of commits.
+    *
+    * @param commits The commits to process.
+    */
+   void calculateLanes(const QVector<CommitInfo> &commits);
+   /**
+    * @brief Notifies that no more batches will arrive.
+    */
+   void finish();
+
+private:
+   Lanes mLanes;
+   int mNextRow = 1;
+};
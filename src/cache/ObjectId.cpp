@@ -0,0 +1,145 @@
+#include "ObjectId.h"
+
+#include <QDataStream>
+
+#include <cstring>
+
+namespace
+{
+int hexValue(char c)
+{
+   if (c >= '0' && c <= '9')
+      return c - '0';
+   if (c >= 'a' && c <= 'f')
+      return c - 'a' + 10;
+   if (c >= 'A' && c <= 'F')
+      return c - 'A' + 10;
+
+   return -1;
+}
+
+int hexValue(QChar c)
+{
+   return c.unicode() < 128 ? hexValue(static_cast<char>(c.unicode())) : -1;
+}
+
+template<typename Char>
+bool parseHex(const Char *hex, int length, uchar *data)
+{
+   for (auto i = 0; i < length; i += 2)
+   {
+      const auto high = hexValue(hex[i]);
+      const auto low = hexValue(hex[i + 1]);
+
+      if (high < 0 || low < 0)
+         return false;
+
+      data[i / 2] = static_cast<uchar>(high << 4 | low);
+   }
+
+   return true;
+}
+}
+
+ObjectId::ObjectId(const QString &hex)
+{
+   const auto length = hex.length();
+
+   if ((length == 2 * SHA1_SIZE || length == 2 * SHA256_SIZE) && parseHex(hex.constData(), length, mData.data()))
+      mSize = static_cast<quint8>(length / 2);
+   else
+      mData.fill(0);
+}
+
+ObjectId ObjectId::fromHex(const char *hex, int length)
+{
+   ObjectId id;
+
+   if ((length == 2 * SHA1_SIZE || length == 2 * SHA256_SIZE) && parseHex(hex, length, id.mData.data()))
+      id.mSize = static_cast<quint8>(length / 2);
+   else
+      id.mData.fill(0);
+
+   return id;
+}
+
+QString ObjectId::toString() const
+{
+   static const char digits[] = "0123456789abcdef";
+
+   QString hex(2 * mSize, Qt::Uninitialized);
+   auto out = hex.data();
+
+   for (auto i = 0; i < mSize; ++i)
+   {
+      *out++ = QLatin1Char(digits[mData[i] >> 4]);
+      *out++ = QLatin1Char(digits[mData[i] & 0xf]);
+   }
+
+   return hex;
+}
+
+bool ObjectId::startsWith(const QString &hexPrefix) const
+{
+   if (hexPrefix.length() > 2 * mSize)
+      return false;
+
+   for (auto i = 0; i < hexPrefix.length(); ++i)
+   {
+      const auto nibble = i % 2 == 0 ? mData[i / 2] >> 4 : mData[i / 2] & 0xf;
+
+      if (hexValue(hexPrefix.at(i)) != nibble)
+         return false;
+   }
+
+   return true;
+}
+
+quint64 ObjectId::prefix64() const
+{
+   quint64 prefix = 0;
+
+   for (auto i = 0; i < 8; ++i)
+      prefix = prefix << 8 | mData[i];
+
+   return prefix;
+}
+
+bool ObjectId::operator<(const ObjectId &other) const
+{
+   const auto cmp = std::memcmp(mData.data(), other.mData.data(), SHA256_SIZE);
+
+   return cmp != 0 ? cmp < 0 : mSize < other.mSize;
+}
+
+uint qHash(const ObjectId &id, uint seed)
+{
+   // The id is already a cryptographic hash, so its first bytes are evenly distributed.
+   uint value = 0;
+   std::memcpy(&value, id.data(), sizeof(value));
+
+   return value ^ seed;
+}
+
+QDataStream &operator<<(QDataStream &stream, const ObjectId &id)
+{
+   stream << id.mSize;
+   stream.writeRawData(reinterpret_cast<const char *>(id.mData.data()), id.mSize);
+
+   return stream;
+}
+
+QDataStream &operator>>(QDataStream &stream, ObjectId &id)
+{
+   id = ObjectId();
+   stream >> id.mSize;
+
+   if (id.mSize > SHA256_SIZE
+       || stream.readRawData(reinterpret_cast<char *>(id.mData.data()), id.mSize) != static_cast<int>(id.mSize))
+   {
+      id = ObjectId();
+      stream.setStatus(QDataStream::ReadCorruptData);
+   }
+
+   return stream;
+}
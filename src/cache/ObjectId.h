@@ -0,0 +1,95 @@
+#pragma once
+
+/****************************************************************************************
+ ** GitQlient is an application to manage and operate one or several Git repositories. With
+ ** GitQlient you will be able to add commits, branches and manage all the options Git provides.
+ ** Copyright (C) 2020  Francesc Martinez
+ **
+ ** LinkedIn: www.linkedin.com/in/cescmm/
+ ** Web: www.francescmm.com
+ **
+ ** This program is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public
+ ** License as published by the Free Software Foundation; either
+ ** version 2 of the License, or (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this library; if not, write to the Free Software
+ ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ***************************************************************************************/
+
+#include <QString>
+#include <QByteArray>
+
+#include <array>
+
+class QDataStream;
+
+/**
+ * @brief The ObjectId class is the binary form of the SHA of a Git object. It holds both SHA-1 (20 bytes) and SHA-256
+ * (32 bytes) ids without any heap allocation, so it can be copied, compared and hashed cheaply. The text form is only
+ * built when it has to be shown or passed to Git.
+ *
+ * @class ObjectId ObjectId.h "ObjectId.h"
+ */
+class ObjectId
+{
+public:
+   static constexpr int SHA1_SIZE = 20;
+   static constexpr int SHA256_SIZE = 32;
+
+   ObjectId() = default;
+   /**
+    * @brief Builds the id from its hexadecimal form.
+    *
+    * @param hex The 40 or 64 hexadecimal digits of the SHA. Any other text results in a null id.
+    */
+   explicit ObjectId(const QString &hex);
+
+   /**
+    * @brief Parses the id directly from the raw output of Git.
+    *
+    * @param hex The pointer to the first hexadecimal digit.
+    * @param length The number of digits, 40 or 64.
+    * @return ObjectId The id or a null id if the data is not valid.
+    */
+   static ObjectId fromHex(const char *hex, int length);
+
+   bool isNull() const { return mSize == 0; }
+   int size() const { return mSize; }
+   const uchar *data() const { return mData.data(); }
+
+   /**
+    * @brief Returns the lowercase hexadecimal form of the id.
+    */
+   QString toString() const;
+   /**
+    * @brief Checks if the hexadecimal form of the id starts with the given text, without building it.
+    *
+    * @param hexPrefix The prefix, case insensitive.
+    * @return True if the id starts with the prefix.
+    */
+   bool startsWith(const QString &hexPrefix) const;
+   /**
+    * @brief Returns the first 64 bits of the id. Sorting by them sorts the ids by their hexadecimal prefix.
+    */
+   quint64 prefix64() const;
+
+   bool operator==(const ObjectId &other) const { return mSize == other.mSize && mData == other.mData; }
+   bool operator!=(const ObjectId &other) const { return !(*this == other); }
+   bool operator<(const ObjectId &other) const;
+
+   friend QDataStream &operator<<(QDataStream &stream, const ObjectId &id);
+   friend QDataStream &operator>>(QDataStream &stream, ObjectId &id);
+
+private:
+   std::array<uchar, SHA256_SIZE> mData {};
+   quint8 mSize = 0;
+};
+
+uint qHash(const ObjectId &id, uint seed = 0);
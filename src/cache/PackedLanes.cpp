@@ -0,0 +1,135 @@
+#include "PackedLanes.h"
+
+#include <LaneType.h>
+
+namespace
+{
+// The numbers are stored in 7 bits per byte, with the high bit set in all the bytes but the last one.
+void appendNumber(QByteArray &data, int number)
+{
+   auto value = static_cast<quint32>(number);
+
+   while (value >= 0x80)
+   {
+      data.append(static_cast<char>((value & 0x7F) | 0x80));
+      value >>= 7;
+   }
+
+   data.append(static_cast<char>(value));
+}
+
+int readNumber(const char *&data)
+{
+   quint32 value = 0;
+   auto shift = 0;
+   uchar byte = 0;
+
+   do
+   {
+      byte = static_cast<uchar>(*data++);
+      value |= static_cast<quint32>(byte & 0x7F) << shift;
+      shift += 7;
+   } while (byte & 0x80);
+
+   return static_cast<int>(value);
+}
+
+Lane readLane(const char *&data)
+{
+   return Lane(static_cast<LaneType>(static_cast<uchar>(*data++)));
+}
+}
+
+void PackedLanes::append(const QVector<Lane> &lanes)
+{
+   const auto isKeyRow = mRowOffsets.count() % KEY_ROW_INTERVAL == 0;
+
+   mRowOffsets.append(mData.size());
+   appendNumber(mData, lanes.count());
+
+   if (isKeyRow)
+   {
+      for (const auto &lane : lanes)
+         mData.append(static_cast<char>(lane.getType()));
+   }
+   else
+   {
+      const auto changed = [this, &lanes](int i) {
+         return i >= mLastLanes.count() || !(mLastLanes.at(i) == lanes.at(i));
+      };
+      auto changes = 0;
+
+      for (auto i = 0; i < lanes.count(); ++i)
+         changes += changed(i);
+
+      appendNumber(mData, changes);
+
+      // The positions are stored as the distance to the previous change, so they take a single byte.
+      auto lastPosition = 0;
+
+      for (auto i = 0; i < lanes.count(); ++i)
+      {
+         if (changed(i))
+         {
+            appendNumber(mData, i - lastPosition);
+            mData.append(static_cast<char>(lanes.at(i).getType()));
+            lastPosition = i;
+         }
+      }
+   }
+
+   mLastLanes = lanes;
+}
+
+QVector<Lane> PackedLanes::at(int row) const
+{
+   QVector<Lane> lanes;
+
+   if (row < 0 || row >= mRowOffsets.count())
+      return lanes;
+
+   const auto keyRow = row - row % KEY_ROW_INTERVAL;
+   auto data = mData.constData() + mRowOffsets.at(keyRow);
+   const auto keyLanesCount = readNumber(data);
+
+   lanes.reserve(keyLanesCount);
+
+   for (auto i = 0; i < keyLanesCount; ++i)
+      lanes.append(readLane(data));
+
+   // The rows are stored one after the other, so the data of the next row starts where the previous one ends.
+   for (auto currentRow = keyRow + 1; currentRow <= row; ++currentRow)
+   {
+      const auto lanesCount = readNumber(data);
+
+      if (lanesCount < lanes.count())
+         lanes.erase(lanes.begin() + lanesCount, lanes.end());
+
+      while (lanes.count() < lanesCount)
+         lanes.append(Lane(LaneType::EMPTY));
+
+      const auto changes = readNumber(data);
+      auto position = 0;
+
+      for (auto i = 0; i < changes; ++i)
+      {
+         position += readNumber(data);
+         lanes[position] = readLane(data);
+      }
+   }
+
+   return lanes;
+}
+
+void PackedLanes::squeeze()
+{
+   mData.squeeze();
+   mRowOffsets.squeeze();
+   mLastLanes.clear();
+}
+
+int PackedLanes::memorySize() const
+{
+   return static_cast<int>(sizeof(PackedLanes) + 2 * sizeof(QArrayData)) + mData.capacity()
+       + mRowOffsets.capacity() * static_cast<int>(sizeof(int));
+}
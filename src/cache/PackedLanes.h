@@ -0,0 +1,71 @@
+#pragma once
+
+/****************************************************************************************
+ ** GitQlient is an application to manage and operate one or several Git repositories. With
+ ** GitQlient you will be able to add commits, branches and manage all the options Git provides.
+ ** Copyright (C) 2020  Francesc Martinez
+ **
+ ** LinkedIn: www.linkedin.com/in/cescmm/
+ ** Web: www.francescmm.com
+ **
+ ** This program is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public
+ ** License as published by the Free Software Foundation; either
+ ** version 2 of the License, or (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this library; if not, write to the Free Software
+ ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ***************************************************************************************/
+
+#include <Lane.h>
+
+#include <QByteArray>
+#include <QVector>
+
+/**
+ * @brief The PackedLanes class stores the lanes of consecutive rows of the graph in a single buffer. Every row is
+ * encoded as its differences with the row above: the number of lanes followed by the position and the type of the
+ * lanes that changed. Consecutive rows usually differ in one or two lanes, so most rows take a few bytes instead of a
+ * vector with one byte per lane.
+ *
+ * Every KEY_ROW_INTERVAL rows the row is stored whole, so reading a row decodes at most KEY_ROW_INTERVAL rows.
+ *
+ * @class PackedLanes PackedLanes.h "PackedLanes.h"
+ */
+class PackedLanes
+{
+public:
+   static constexpr int KEY_ROW_INTERVAL = 32;
+
+   /**
+    * @brief Adds the lanes of the next row.
+    */
+   void append(const QVector<Lane> &lanes);
+   /**
+    * @brief Returns the number of rows.
+    */
+   int count() const { return mRowOffsets.count(); }
+   /**
+    * @brief Decodes the lanes of the row.
+    */
+   QVector<Lane> at(int row) const;
+   /**
+    * @brief Releases the memory that is only needed to append rows. Rows can still be appended afterwards.
+    */
+   void squeeze();
+   /**
+    * @brief Returns the bytes of memory used by the encoded rows.
+    */
+   int memorySize() const;
+
+private:
+   QByteArray mData;
+   QVector<int> mRowOffsets;
+   QVector<Lane> mLastLanes;
+};
@@ -11,6 +11,37 @@ bool RevisionFiles::operator!=(const RevisionFiles &revFiles) const
    return !(*this == revFiles);
 }
 
+QStringList RevisionFiles::getFiles() const
+{
+   const auto &pool = FilePathPool::instance();
+   QStringList files;
+   files.reserve(mFiles.count());
+
+   for (const auto &file : mFiles)
+      files.append(pool.path(file));
+
+   return files;
+}
+
+int RevisionFiles::indexOf(const QString &fileName) const
+{
+   const auto id = FilePathPool::instance().find(fileName);
+
+   return id.isValid() ? mFiles.indexOf(id) : -1;
+}
+
+int RevisionFiles::memorySize() const
+{
+   auto size = static_cast<int>(sizeof(RevisionFiles) + sizeof(FilePathPool::PathId) * mFiles.capacity()
+                                + sizeof(int) * (mFileStatus.capacity() + mergeParent.capacity())
+                                + sizeof(QString) * mRenamedFiles.capacity());
+
+   for (const auto &renamedFile : mRenamedFiles)
+      size += renamedFile.size() * static_cast<int>(sizeof(QChar));
+
+   return size;
+}
+
 bool RevisionFiles::statusCmp(int idx, RevisionFiles::StatusFlag sf) const
 {
    if (idx >= mFileStatus.count())
@@ -31,7 +62,12 @@ const QString RevisionFiles::extendedStatus(int idx) const
 
 void RevisionFiles::setStatus(const QString &rowSt)
 {
-   switch (rowSt.at(0).toLatin1())
+   setStatus(rowSt.at(0).toLatin1());
+}
+
+void RevisionFiles::setStatus(char status)
+{
+   switch (status)
    {
       case 'M':
       case 'T':
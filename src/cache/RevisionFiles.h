@@ -1,5 +1,7 @@
 #pragma once
 
+#include <FilePathPool.h>
+
 #include <QByteArray>
 #include <QVector>
 #include <QStringList>
@@ -24,13 +26,13 @@ public:
    bool operator!=(const RevisionFiles &revFiles) const;
 
    QVector<int> mergeParent;
-   QVector<QString> mFiles;
 
    // helper functions
    int count() const { return mFiles.count(); }
    bool statusCmp(int idx, StatusFlag sf) const;
    const QString extendedStatus(int idx) const;
    void setStatus(const QString &rowSt);
+   void setStatus(char status);
    void setStatus(RevisionFiles::StatusFlag flag);
    void setStatus(int pos, RevisionFiles::StatusFlag flag);
    void appendStatus(int pos, RevisionFiles::StatusFlag flag);
@@ -38,9 +40,14 @@ public:
    void setOnlyModified(bool onlyModified) { mOnlyModified = onlyModified; }
    int getFilesCount() const { return mFileStatus.size(); }
    void appendExtStatus(const QString &file) { mRenamedFiles.append(file); }
-   QString getFile(int index) const { return mFiles.at(index); }
-   QStringList getFiles() const { return mFiles.toList(); }
-   bool containsFile(const QString &fileName) { return mFiles.contains(fileName); }
+   QString getFile(int index) const { return FilePathPool::instance().path(mFiles.at(index)); }
+   FilePathPool::PathId getFileId(int index) const { return mFiles.at(index); }
+   QStringList getFiles() const;
+   bool containsFile(const QString &fileName) const { return indexOf(fileName) != -1; }
+   int indexOf(const QString &fileName) const;
+   void appendFile(const QString &fileName) { mFiles.append(FilePathPool::instance().intern(fileName)); }
+   void appendFile(FilePathPool::PathId file) { mFiles.append(file); }
+   int memorySize() const;
 
 private:
    // Status information is splitted in a flags vector and in a string
@@ -54,6 +61,8 @@ private:
    // When status of all the files is 'modified' then onlyModified is
    // set, this let us to do some optimization in this common case
    bool mOnlyModified = true;
+   // The paths are interned in the FilePathPool, so every file only takes the size of its identifier.
+   QVector<FilePathPool::PathId> mFiles;
    QVector<int> mFileStatus;
    QVector<QString> mRenamedFiles;
 };
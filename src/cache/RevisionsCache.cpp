@@ -1,33 +1,70 @@
 #include "RevisionsCache.h"
 
+#include <LanesBuilder.h>
+
 #include <QLogger.h>
 
+#include <QTimer>
+
 using namespace QLogger;
 
-RevisionsCache::RevisionsCache(QObject *parent)
-   : QObject(parent)
+namespace
 {
-}
+// Size in KiB of the packed lanes kept in memory. It's the cost unit of the lanes cache.
+const auto MAX_CACHED_LANES_KB = 4 * 1024;
+
+// Size in KiB of the file patches kept in memory. It's the cost unit of the patches cache.
+const auto MAX_CACHED_PATCHES_KB = 64 * 1024;
+
+// Default memory in bytes for the files of the revisions.
+const auto DEFAULT_REVISION_FILES_BUDGET = 64 * 1024 * 1024;
+
+// Size in KiB of the file blames kept in memory. It's the cost unit of the blames cache.
+const auto MAX_CACHED_BLAMES_KB = 32 * 1024;
 
-RevisionsCache::~RevisionsCache()
+// Time in milliseconds the search index spends indexing commits every time the GUI thread is idle.
+const auto SEARCH_INDEX_SLICE_MS = 5;
+
+// Number of hexadecimal digits of the SHA that are stored in the prefix index.
+const auto INDEXED_PREFIX_LENGTH = 16;
+
+bool shaPrefixKey(const QString &shaPrefix, quint64 &key)
 {
-   for (auto commit : mCommits)
-      delete commit;
+   auto ok = false;
 
-   mCommits.clear();
-   mCommitsMap.clear();
-   mReferences.clear();
+   key = shaPrefix.leftRef(INDEXED_PREFIX_LENGTH).toULongLong(&ok, 16);
+
+   if (ok && shaPrefix.length() < INDEXED_PREFIX_LENGTH)
+      key <<= 4 * (INDEXED_PREFIX_LENGTH - shaPrefix.length());
+
+   return ok;
+}
+}
+
+RevisionsCache::RevisionsCache(QObject *parent)
+   : QObject(parent)
+   , mSearchIndex(mCommits)
+   , mSearchIndexTimer(new QTimer(this))
+{
+   // A zero interval runs the slices whenever the event loop has no other events to process.
+   mSearchIndexTimer->setInterval(0);
+   connect(mSearchIndexTimer, &QTimer::timeout, this, &RevisionsCache::indexPendingSearchCommits);
+
+   mLanesChunks.setMaxCost(MAX_CACHED_LANES_KB);
+   mFilePatches.setMaxCost(MAX_CACHED_PATCHES_KB);
+   mFileBlames.setMaxCost(MAX_CACHED_BLAMES_KB);
+   mRevisionFilesStats.budget = DEFAULT_REVISION_FILES_BUDGET;
 }
 
 void RevisionsCache::configure(int numElementsToStore)
 {
    QLog_Debug("Git", QString("Configuring the cache for {%1} elements.").arg(numElementsToStore));
 
-   if (mCommits.isEmpty())
+   if (mCommits.count() == 0)
    {
       // We reserve 1 extra slots for the ZERO_SHA (aka WIP commit)
+      mCommits.reserve(numElementsToStore + 1);
       mCommits.resize(numElementsToStore + 1);
-      mCommitsMap.reserve(numElementsToStore + 1);
    }
 
    mCacheLocked = false;
@@ -35,119 +72,333 @@ void RevisionsCache::configure(int numElementsToStore)
 
 CommitInfo RevisionsCache::getCommitInfoByRow(int row) const
 {
-   const auto commit = row >= 0 && row < mCommits.count() ? mCommits.at(row) : nullptr;
+   auto commit = commitAt(row);
 
-   return commit ? *commit : CommitInfo();
+   if (commit.isValid() && row > 0)
+      commit.setLanes(lanesForRow(row));
+
+   return commit;
 }
 
-int RevisionsCache::getCommitPos(const QString &sha) const
+CommitInfo RevisionsCache::getCommitInfoByRowWithoutLanes(int row) const
 {
-   const auto commit = mCommitsMap.value(sha, nullptr);
-   return mCommits.indexOf(commit);
+   return commitAt(row);
 }
 
-CommitInfo RevisionsCache::getCommitInfoByField(CommitInfo::Field field, const QString &text, int startingPoint)
+int RevisionsCache::getCommitPos(const QString &sha) const
 {
-   auto commitIter = searchCommit(field, text, startingPoint);
+   const auto row = mCommits.row(ObjectId(sha));
 
-   if (commitIter == mCommits.constEnd() && startingPoint > 0)
-      commitIter = searchCommit(field, text);
+   return row == -1 && !sha.isEmpty() ? findByShaPrefix(sha) : row;
+}
 
-   return commitIter != mCommits.constEnd() ? **commitIter : CommitInfo();
+CommitGraph RevisionsCache::commitGraph() const
+{
+   return mCommits.graph();
+}
+
+QVector<int> RevisionsCache::searchCommits(const QString &query)
+{
+   return mSearchIndex.search(query);
 }
 
 CommitInfo RevisionsCache::getCommitInfo(const QString &sha) const
 {
    if (!sha.isEmpty())
    {
-      const auto c = mCommitsMap.value(sha, nullptr);
+      auto row = mCommits.row(ObjectId(sha));
 
-      if (c == nullptr)
-      {
-         const auto shas = mCommitsMap.keys();
-         const auto it = std::find_if(shas.cbegin(), shas.cend(),
-                                      [sha](const QString &shaToCompare) { return shaToCompare.startsWith(sha); });
+      if (row == -1)
+         row = findByShaPrefix(sha);
 
-         if (it != shas.cend())
-            return *mCommitsMap.value(*it);
+      return commitAt(row);
+   }
 
-         return CommitInfo();
-      }
+   return CommitInfo();
+}
+
+QByteArray RevisionsCache::getFilePatch(const QString &sha, const QString &parentSha, const QString &file) const
+{
+   const auto patch = mFilePatches.object(filePatchKey(sha, parentSha, file));
+
+   return patch ? *patch : QByteArray();
+}
+
+bool RevisionsCache::insertFilePatch(const QString &sha, const QString &parentSha, const QString &file,
+                                     const QByteArray &patch)
+{
+   const auto cost = std::max(1, patch.size() / 1024);
 
-      return *c;
+   // QCache deletes the object if it's too big to be stored.
+   return mFilePatches.insert(filePatchKey(sha, parentSha, file), new QByteArray(patch), cost);
+}
+
+void RevisionsCache::removeFilePatches(const QString &sha)
+{
+   const auto prefix = sha + '\n';
+   const auto keys = mFilePatches.keys();
+
+   for (const auto &key : keys)
+   {
+      if (key.startsWith(prefix))
+         mFilePatches.remove(key);
    }
+}
 
-   return CommitInfo();
+FileBlame RevisionsCache::getFileBlame(const QString &sha, const QString &file) const
+{
+   const auto blame = mFileBlames.object(QString("%1\n%2").arg(sha, file));
+
+   return blame ? *blame : FileBlame();
+}
+
+bool RevisionsCache::insertFileBlame(const QString &sha, const QString &file, const FileBlame &blame)
+{
+   const auto cost = std::max(1, blame.memorySize() / 1024);
+
+   // QCache deletes the object if it's too big to be stored.
+   return mFileBlames.insert(QString("%1\n%2").arg(sha, file), new FileBlame(blame), cost);
+}
+
+bool RevisionsCache::containsFileBlame(const QString &sha, const QString &file) const
+{
+   return mFileBlames.contains(QString("%1\n%2").arg(sha, file));
 }
 
 RevisionFiles RevisionsCache::getRevisionFile(const QString &sha1, const QString &sha2) const
 {
-   return mRevisionFilesMap.value(qMakePair(sha1, sha2));
+   const auto iter = mRevisionFilesMap.constFind(qMakePair(sha1, sha2));
+
+   if (iter == mRevisionFilesMap.cend())
+   {
+      ++mRevisionFilesStats.misses;
+      return RevisionFiles();
+   }
+
+   ++mRevisionFilesStats.hits;
+
+   if (sha1 != CommitInfo::ZERO_SHA)
+      mRevisionFilesLru.splice(mRevisionFilesLru.begin(), mRevisionFilesLru, iter.value().lruPosition);
+
+   return iter.value().files;
 }
 
 void RevisionsCache::insertCommitInfo(CommitInfo rev, int orderIdx)
 {
    if (mCacheLocked)
       QLog_Warning("Git", QString("The cache is currently locked."));
-   else if (mCommitsMap.contains(rev.sha()))
+   else if (mCommits.row(rev.id()) != -1)
       QLog_Info("Git", QString("The commit with SHA {%1} is already in the cache.").arg(rev.sha()));
    else
    {
-      rev.setLanes(calculateLanes(rev));
-
-      const auto commit = new CommitInfo(rev);
-
       if (orderIdx >= mCommits.count())
       {
-         QLog_Debug("Git", QString("Adding commit with sha {%1}.").arg(commit->sha()));
+         QLog_Debug("Git", QString("Adding commit with sha {%1}.").arg(rev.sha()));
 
-         mCommits.append(commit);
+         orderIdx = mCommits.count();
+         mCommits.resize(orderIdx + 1);
       }
-      else if (!(mCommits[orderIdx] && *mCommits[orderIdx] == *commit))
-      {
-         QLog_Trace("Git", QString("Overwriting commit with sha {%1}.").arg(commit->sha()));
+      else
+         QLog_Trace("Git", QString("Overwriting commit with sha {%1}.").arg(rev.sha()));
 
-         if (mCommits[orderIdx])
-            delete mCommits[orderIdx];
+      // The table keeps the data of the row if it already holds the same commit from a previous load.
+      mCommits.setCommit(orderIdx, rev);
+      mLanesChunks.remove(lanesChunk(orderIdx));
+      indexCommit(orderIdx);
 
-         mCommits[orderIdx] = commit;
-      }
+      if (mCommits.row(rev.parentId(0)) != -1)
+         mCommits.unmapId(rev.parentId(0));
+   }
+}
+
+int RevisionsCache::insertCommitsOnTop(const QVector<CommitInfo> &commits, const QString &headSha)
+{
+   static const auto MAX_RECALCULATED_ROWS = 1000;
+
+   // Without a WIP parent the lanes of the top rows can't be replayed.
+   if (mCacheLocked || headSha.isEmpty() || !mCommits.hasCommit(0) || mLanesWipParentId.isNull())
+      return -1;
+
+   const auto oldRows = std::min(mCommits.count() - 1, MAX_RECALCULATED_ROWS);
+
+   // The lanes of a row depend on all the rows above, so the state of the lanes after each of the top rows is
+   // replayed as it was calculated in the last load. The WIP could be on another HEAD already, so the replay starts
+   // from the parent the lanes were calculated with.
+   QVector<Lanes> previousStates;
+   previousStates.reserve(oldRows);
+
+   Lanes lanes;
+   lanes.init(CommitInfo::ZERO_ID);
+   lanes.advance(CommitInfo::ZERO_ID, { mLanesWipParentId });
+
+   for (auto row = 1; row <= oldRows; ++row)
+   {
+      lanes.advance(mCommits.id(row), mCommits.parentIds(row));
+      previousStates.append(lanes);
+   }
+
+   Lanes newLanes;
+   newLanes.init(CommitInfo::ZERO_ID);
+
+   const auto wipLanes = newLanes.processCommit(CommitInfo::ZERO_ID, { ObjectId(headSha) });
+   const auto firstCheckpoint = newLanes;
+
+   for (const auto &commit : commits)
+      newLanes.advance(commit.id(), commit.parentIds());
+
+   // Once the state of the lanes is the same than it was for an old row, the rows below it don't change.
+   auto updatedRows = 0;
+   auto converged = false;
+
+   for (auto row = 1; row <= oldRows && !converged; ++row)
+   {
+      newLanes.advance(mCommits.id(row), mCommits.parentIds(row));
+      converged = newLanes == previousStates.at(row - 1);
+      ++updatedRows;
+   }
+
+   if (!converged && oldRows < mCommits.count() - 1)
+   {
+      QLog_Debug("Git", "The new commits change too many lanes. A full reload is needed.");
+      return -1;
+   }
+
+   mWipLanes = wipLanes;
+   mLanesWipParentId = ObjectId(headSha);
+
+   // The checkpoints after the updated rows are still valid, they only move down.
+   QMap<int, Lanes> checkpoints;
+   checkpoints.insert(1, firstCheckpoint);
+
+   for (auto it = mLanesCheckpoints.cbegin(); it != mLanesCheckpoints.cend(); ++it)
+   {
+      if (it.key() > updatedRows)
+         checkpoints.insert(it.key() + commits.count(), it.value());
+   }
+
+   mLanesCheckpoints = checkpoints;
+   mLanesChunks.clear();
 
-      mCommitsMap.insert(rev.sha(), commit);
+   // The rows below the WIP move down in the table and in the indexes.
+   mCommits.insertRows(1, commits.count());
+   mSearchIndex.insertRows(1, commits.count());
+
+   for (auto prefixes : { &mShaPrefixIndex, &mPendingShaPrefixes })
+   {
+      for (auto &entry : *prefixes)
+      {
+         if (entry.second >= 1)
+            entry.second += commits.count();
+      }
+   }
 
-      if (mCommitsMap.contains(rev.parent(0)))
-         mCommitsMap.remove(rev.parent(0));
+   for (auto i = 0; i < commits.count(); ++i)
+   {
+      mCommits.setCommit(i + 1, commits.at(i));
+      indexCommit(i + 1);
    }
+
+   QLog_Debug("Git",
+              QString("Added {%1} commits on top, {%2} rows updated.").arg(commits.count()).arg(updatedRows));
+
+   return updatedRows;
 }
 
 bool RevisionsCache::insertRevisionFile(const QString &sha1, const QString &sha2, const RevisionFiles &file)
 {
+   if (sha1.isEmpty() || sha2.isEmpty())
+      return false;
+
    const auto key = qMakePair(sha1, sha2);
+   const auto isWip = sha1 == CommitInfo::ZERO_SHA;
+   auto iter = mRevisionFilesMap.find(key);
+
+   if (iter != mRevisionFilesMap.end() && iter.value().files == file)
+      return false;
 
-   if (!sha1.isEmpty() && !sha2.isEmpty() && mRevisionFilesMap.value(key) != file)
+   QLog_Debug("Git", QString("Adding the revisions files between {%1} and {%2}.").arg(sha1, sha2));
+
+   // The key is accounted as well since it's stored both in the map and in the LRU list.
+   const auto keySize = 2 * (sha1.size() + sha2.size()) * static_cast<qint64>(sizeof(QChar));
+   const auto size = isWip ? 0 : file.memorySize() + keySize;
+
+   if (size > mRevisionFilesStats.budget)
    {
-      QLog_Debug("Git", QString("Adding the revisions files between {%1} and {%2}.").arg(sha1, sha2));
+      if (iter != mRevisionFilesMap.end())
+      {
+         mRevisionFilesStats.bytes -= iter.value().size;
+         mRevisionFilesLru.erase(iter.value().lruPosition);
+         mRevisionFilesMap.erase(iter);
+      }
+
+      return false;
+   }
 
-      mRevisionFilesMap.insert(key, file);
+   if (iter == mRevisionFilesMap.end())
+   {
+      iter = mRevisionFilesMap.insert(key, RevisionFilesEntry());
 
-      return true;
+      if (!isWip)
+         iter.value().lruPosition = mRevisionFilesLru.insert(mRevisionFilesLru.begin(), key);
    }
+   else if (!isWip)
+      mRevisionFilesLru.splice(mRevisionFilesLru.begin(), mRevisionFilesLru, iter.value().lruPosition);
+
+   mRevisionFilesStats.bytes += size - iter.value().size;
+   iter.value().files = file;
+   iter.value().size = size;
+
+   evictRevisionFiles();
+
+   return true;
+}
+
+void RevisionsCache::setRevisionFilesBudget(qint64 bytes)
+{
+   mRevisionFilesStats.budget = bytes;
+
+   evictRevisionFiles();
+}
+
+RevisionsCache::RevisionFilesStats RevisionsCache::revisionFilesStats() const
+{
+   auto stats = mRevisionFilesStats;
+   stats.entries = mRevisionFilesMap.count();
+
+   return stats;
+}
+
+void RevisionsCache::evictRevisionFiles()
+{
+   while (mRevisionFilesStats.bytes > mRevisionFilesStats.budget && !mRevisionFilesLru.empty())
+   {
+      const auto iter = mRevisionFilesMap.find(mRevisionFilesLru.back());
 
-   return false;
+      mRevisionFilesStats.bytes -= iter.value().size;
+      ++mRevisionFilesStats.evictions;
+
+      mRevisionFilesMap.erase(iter);
+      mRevisionFilesLru.pop_back();
+   }
 }
 
 void RevisionsCache::insertReference(const QString &sha, References::Type type, const QString &reference)
 {
    QLog_Debug("Git", QString("Adding a new reference with SHA {%1}.").arg(sha));
 
-   auto commit = mCommitsMap[sha];
+   const auto id = ObjectId(sha);
 
-   if (commit)
+   if (mCommits.row(id) != -1)
    {
-      commit->addReference(type, reference);
+      auto refs = mReferences.find(id);
 
-      if (!mReferences.contains(mCommitsMap[sha]))
-         mReferences.append(mCommitsMap[sha]);
+      if (refs == mReferences.end())
+      {
+         refs = mReferences.insert(id, References());
+         mReferencedCommits.append(id);
+      }
+
+      refs->addReference(type, reference);
    }
 }
 
@@ -156,47 +407,48 @@ void RevisionsCache::insertLocalBranchDistances(const QString &name, const Local
    mLocalBranchDistances[name] = distances;
 }
 
-void RevisionsCache::updateWipCommit(const QString &parentSha, const QString &diffIndex, const QString &diffIndexCache)
+void RevisionsCache::updateWipCommit(const QString &parentSha, const RevisionFiles &files,
+                                     const QVector<QString> &untrackedFiles)
 {
    QLog_Debug("Git", QString("Updating the WIP commit. The actual parent has SHA {%1}.").arg(parentSha));
 
-   const auto key = qMakePair(CommitInfo::ZERO_SHA, parentSha);
-   const auto fakeRevFile = fakeWorkDirRevFile(diffIndex, diffIndexCache);
+   mUntrackedfiles = untrackedFiles;
 
-   insertRevisionFile(CommitInfo::ZERO_SHA, parentSha, fakeRevFile);
+   insertRevisionFile(CommitInfo::ZERO_SHA, parentSha, files);
 
    if (!mCacheLocked)
    {
       const QString longLog;
       const auto author = QString("-");
       const auto log
-          = fakeRevFile.count() == mUntrackedfiles.count() ? QString("No local changes") : QString("Local changes");
+          = files.count() == mUntrackedfiles.count() ? QString("No local changes") : QString("Local changes");
       CommitInfo c(CommitInfo::ZERO_SHA, { parentSha }, author, QDateTime::currentDateTime().toSecsSinceEpoch(), log,
                    longLog);
 
       if (mLanes.isEmpty())
-         mLanes.init(c.sha());
-
-      c.setLanes(calculateLanes(c));
-
-      if (mCommits[0])
-         c.setLanes(mCommits[0]->getLanes());
+         mLanes.init(c.id());
 
-      const auto sha = c.sha();
-      const auto commit = new CommitInfo(std::move(c));
+      const auto lanes = calculateLanes(c);
 
-      if (mCommits[0])
-         delete mCommits[0];
+      // Once the WIP is in the table its lanes are only updated with the graph.
+      if (!mCommits.hasCommit(0))
+         mWipLanes = lanes;
 
-      mCommits[0] = commit;
-
-      mCommitsMap.insert(sha, commit);
+      mCommits.setCommit(0, c);
    }
 }
 
 void RevisionsCache::removeReference(const QString &sha)
 {
-   mCommitsMap[sha]->addReferences(References());
+   if (const auto refs = mReferences.find(ObjectId(sha)); refs != mReferences.end())
+      *refs = References();
+}
+
+void RevisionsCache::clearReferences()
+{
+   mReferences.clear();
+   mReferencedCommits.clear();
+   mLocalBranchDistances.clear();
 }
 
 bool RevisionsCache::containsRevisionFile(const QString &sha1, const QString &sha2) const
@@ -206,319 +458,265 @@ bool RevisionsCache::containsRevisionFile(const QString &sha1, const QString &sh
 
 QVector<Lane> RevisionsCache::calculateLanes(const CommitInfo &c)
 {
-   const auto sha = c.sha();
-
-   QLog_Trace("Git", QString("Updating the lanes for SHA {%1}.").arg(sha));
-
-   bool isDiscontinuity;
-   bool isFork = mLanes.isFork(sha, isDiscontinuity);
-   bool isMerge = c.parentsCount() > 1;
-
-   if (isDiscontinuity)
-      mLanes.changeActiveLane(sha); // uses previous isBoundary state
-
-   if (isFork)
-      mLanes.setFork(sha);
-   if (isMerge)
-      mLanes.setMerge(c.parents());
-   if (c.parentsCount() == 0)
-      mLanes.setInitial();
-
-   const auto lanes = mLanes.getLanes();
-
-   resetLanes(c, isFork);
+   QLog_Trace("Git", QString("Updating the lanes for SHA {%1}.").arg(c.sha()));
 
-   return lanes;
+   return mLanes.processCommit(c.id(), c.parentIds());
 }
 
-RevisionFiles RevisionsCache::parseDiffFormat(const QString &buf, FileNamesLoader &fl)
+bool RevisionsCache::pendingLocalChanges() const
 {
-   RevisionFiles rf;
-   auto parNum = 1;
-   const auto lines = buf.split("\n", QString::SkipEmptyParts);
+   auto localChanges = false;
 
-   for (auto line : lines)
+   if (!mCacheLocked)
    {
-      if (line[0] == ':') // avoid sha's in merges output
+      if (const auto row = mCommits.row(CommitInfo::ZERO_ID); row != -1)
       {
-         if (line[1] == ':')
-         { // it's a combined merge
-            /* For combined merges rename/copy information is useless
-             * because nor the original file name, nor similarity info
-             * is given, just the status tracks that in the left/right
-             * branch a renamed/copy occurred (as example status could
-             * be RM or MR). For visualization purposes we could consider
-             * the file as modified
-             */
-            if (fl.rf != &rf)
-            {
-               flushFileNames(fl);
-               fl.rf = &rf;
-            }
-            appendFileName(line.section('\t', -1), fl);
-            rf.setStatus("M");
-            rf.mergeParent.append(parNum);
-         }
-         else
-         {
-            if (line.at(98) == '\t') // Faster parsing in normal case
-            {
-               if (fl.rf != &rf)
-               {
-                  flushFileNames(fl);
-                  fl.rf = &rf;
-               }
-               appendFileName(line.mid(99), fl);
-               rf.setStatus(line.at(97));
-               rf.mergeParent.append(parNum);
-            }
-            else // It's a rename or a copy, we are not in fast path now!
-               setExtStatus(rf, line.mid(97), parNum, fl);
-         }
+         const auto rf = getRevisionFile(CommitInfo::ZERO_SHA, mCommits.commit(row).parent(0));
+         localChanges = rf.count() == mUntrackedfiles.count();
       }
-      else
-         ++parNum;
    }
 
-   return rf;
+   return localChanges;
 }
 
-void RevisionsCache::appendFileName(const QString &name, FileNamesLoader &fl)
+QVector<QPair<QString, QStringList>> RevisionsCache::getBranches(References::Type type) const
 {
-   int idx = name.lastIndexOf('/') + 1;
-   const QString &dr = name.left(idx);
-   const QString &nm = name.mid(idx);
+   QVector<QPair<QString, QStringList>> branches;
 
-   auto it = mDirNames.indexOf(dr);
-   if (it == -1)
-   {
-      int idx = mDirNames.count();
-      mDirNames.append(dr);
-      fl.rfDirs.append(idx);
-   }
-   else
-      fl.rfDirs.append(it);
+   for (const auto &id : mReferencedCommits)
+      branches.append(QPair<QString, QStringList>(id.toString(), mReferences.value(id).getReferences(type)));
+
+   return branches;
+}
 
-   it = mFileNames.indexOf(nm);
-   if (it == -1)
+QVector<QPair<QString, QStringList>> RevisionsCache::getTags() const
+{
+   QVector<QPair<QString, QStringList>> tags;
+
+   for (const auto &id : mReferencedCommits)
    {
-      int idx = mFileNames.count();
-      mFileNames.append(nm);
-      fl.rfNames.append(idx);
+      tags.append(
+          QPair<QString, QStringList>(id.toString(), mReferences.value(id).getReferences(References::Type::Tag)));
    }
-   else
-      fl.rfNames.append(it);
 
-   fl.files.append(name);
+   return tags;
 }
 
-void RevisionsCache::flushFileNames(FileNamesLoader &fl)
+QString RevisionsCache::getCommitForBranch(const QString &branch, bool local) const
 {
-   if (!fl.rf)
-      return;
+   QString sha;
 
-   for (auto i = 0; i < fl.rfNames.count(); ++i)
+   for (const auto &id : mReferencedCommits)
    {
-      const auto dirName = mDirNames.at(fl.rfDirs.at(i));
-      const auto fileName = mFileNames.at(fl.rfNames.at(i));
+      const auto branches = mReferences.value(id).getReferences(local ? References::Type::LocalBranch
+                                                                      : References::Type::RemoteBranches);
 
-      if (!fl.rf->mFiles.contains(dirName + fileName))
-         fl.rf->mFiles.append(dirName + fileName);
+      if (branches.contains(branch))
+      {
+         sha = id.toString();
+         break;
+      }
    }
 
-   fl.rfNames.clear();
-   fl.rfDirs.clear();
-   fl.rf = nullptr;
+   return sha;
 }
 
-bool RevisionsCache::pendingLocalChanges() const
+void RevisionsCache::clear()
 {
-   auto localChanges = false;
+   clearReferences();
 
-   if (!mCacheLocked)
-   {
-      const auto commit = mCommitsMap.value(CommitInfo::ZERO_SHA);
-      const auto rf = getRevisionFile(CommitInfo::ZERO_SHA, commit->parent(0));
-      localChanges = rf.count() == mUntrackedfiles.count();
-   }
-
-   return localChanges;
+   mCacheLocked = true;
+   mRevisionFilesMap.clear();
+   mRevisionFilesLru.clear();
+   mRevisionFilesStats.bytes = 0;
+   mLanes.clear();
+   // The rows are kept and shown until the next load overwrites them, but the commits are not found by id anymore.
+   mCommits.unmapIds();
+   mShaPrefixIndex.clear();
+   mPendingShaPrefixes.clear();
+   mSearchIndex.clear();
+   mSearchIndexTimer->stop();
+   mLanesCheckpoints.clear();
+   mLanesWipParentId = ObjectId();
+   mLanesChunks.clear();
 }
 
-QVector<QPair<QString, QStringList>> RevisionsCache::getBranches(References::Type type) const
+void RevisionsCache::truncate(int numElements)
 {
-   QVector<QPair<QString, QStringList>> branches;
+   // Rows from a previous load that were not overwritten by the current one are stale.
+   if (numElements < mCommits.count())
+      mCommits.resize(numElements);
 
-   for (auto commit : mReferences)
-      branches.append(QPair<QString, QStringList>(commit->sha(), commit->getReferences(type)));
+   mCommits.squeeze();
 
-   return branches;
+   while (!mLanesCheckpoints.isEmpty() && mLanesCheckpoints.lastKey() >= numElements)
+      mLanesCheckpoints.remove(mLanesCheckpoints.lastKey());
+
+   mLanesChunks.clear();
 }
 
-QVector<QPair<QString, QStringList>> RevisionsCache::getTags() const
+void RevisionsCache::insertLanesCheckpoint(int row, const Lanes &lanes)
 {
-   QVector<QPair<QString, QStringList>> tags;
-
-   for (auto commit : mReferences)
-      tags.append(QPair<QString, QStringList>(commit->sha(), commit->getReferences(References::Type::Tag)));
+   mLanesCheckpoints.insert(row, lanes);
+}
 
-   return tags;
+int RevisionsCache::lanesChunk(int row)
+{
+   return (row - 1) / LanesBuilder::CHECKPOINT_INTERVAL;
 }
 
-QString RevisionsCache::getCommitForBranch(const QString &branch, bool local) const
+QVector<Lane> RevisionsCache::lanesForRow(int row) const
 {
-   QString sha;
+   const auto chunk = lanesChunk(row);
+   const auto chunkStart = 1 + chunk * LanesBuilder::CHECKPOINT_INTERVAL;
+   const auto chunkEnd = std::min(chunkStart + LanesBuilder::CHECKPOINT_INTERVAL, mCommits.count());
+
+   if (const auto rows = mLanesChunks.object(chunk); rows && row - chunkStart < rows->count())
+      return rows->at(row - chunkStart);
+
+   auto checkpoint = mLanesCheckpoints.upperBound(chunkStart);
 
-   for (auto commit : mReferences)
+   if (checkpoint == mLanesCheckpoints.begin())
+      return {};
+
+   --checkpoint;
+
+   auto lanes = checkpoint.value();
+   auto currentRow = checkpoint.key();
+
+   // The chunks between the checkpoint and the requested one get their own checkpoints, so coming back is cheap.
+   for (; currentRow < chunkStart; ++currentRow)
    {
-      const auto branches
-          = commit->getReferences(local ? References::Type::LocalBranch : References::Type::RemoteBranches);
+      if (!mCommits.hasCommit(currentRow))
+         return {};
 
-      if (branches.contains(branch))
-      {
-         sha = commit->sha();
-         break;
-      }
+      if ((currentRow - 1) % LanesBuilder::CHECKPOINT_INTERVAL == 0)
+         mLanesCheckpoints.insert(currentRow, lanes);
+
+      lanes.advance(mCommits.id(currentRow), mCommits.parentIds(currentRow));
    }
 
-   return sha;
+   const auto rows = new PackedLanes();
+
+   for (; currentRow < chunkEnd && mCommits.hasCommit(currentRow); ++currentRow)
+      rows->append(lanes.processCommit(mCommits.id(currentRow), mCommits.parentIds(currentRow)));
+
+   rows->squeeze();
+
+   if (currentRow == chunkStart + LanesBuilder::CHECKPOINT_INTERVAL)
+      mLanesCheckpoints.insert(currentRow, lanes);
+
+   const auto rowLanes = row - chunkStart < rows->count() ? rows->at(row - chunkStart) : QVector<Lane>();
+
+   mLanesChunks.insert(chunk, rows, std::max(1, rows->memorySize() / 1024));
+
+   return rowLanes;
 }
 
-void RevisionsCache::setExtStatus(RevisionFiles &rf, const QString &rowSt, int parNum, FileNamesLoader &fl)
+CommitInfo RevisionsCache::commitAt(int row) const
 {
-   const QStringList sl(rowSt.split('\t', QString::SkipEmptyParts));
-   if (sl.count() != 3)
-      return;
+   auto commit = mCommits.commit(row);
 
-   // we want store extra info with format "orig --> dest (Rxx%)"
-   // but git give us something like "Rxx\t<orig>\t<dest>"
-   QString type = sl[0];
-   type.remove(0, 1);
-   const QString &orig = sl[1];
-   const QString &dest = sl[2];
-   const QString extStatusInfo(orig + " --> " + dest + " (" + QString::number(type.toInt()) + "%)");
-
-   /*
-    NOTE: we set rf.extStatus size equal to position of latest
-          copied/renamed file. So it can have size lower then
-          rf.count() if after copied/renamed file there are
-          others. Here we have no possibility to know final
-          dimension of this RefFile. We are still in parsing.
- */
-
-   // simulate new file
-   if (fl.rf != &rf)
+   if (commit.isValid())
    {
-      flushFileNames(fl);
-      fl.rf = &rf;
-   }
-   appendFileName(dest, fl);
-   rf.mergeParent.append(parNum);
-   rf.setStatus(RevisionFiles::NEW);
-   rf.appendExtStatus(extStatusInfo);
-
-   // simulate deleted orig file only in case of rename
-   if (type.at(0) == 'R')
-   { // renamed file
-      if (fl.rf != &rf)
-      {
-         flushFileNames(fl);
-         fl.rf = &rf;
-      }
-      appendFileName(orig, fl);
-      rf.mergeParent.append(parNum);
-      rf.setStatus(RevisionFiles::DELETED);
-      rf.appendExtStatus(extStatusInfo);
+      commit.addReferences(mReferences.value(commit.id()));
+
+      if (row == 0)
+         commit.setLanes(mWipLanes);
    }
-   rf.setOnlyModified(false);
-}
 
-QVector<CommitInfo *>::const_iterator RevisionsCache::searchCommit(CommitInfo::Field field, const QString &text,
-                                                                   const int startingPoint) const
-{
-   return std::find_if(mCommits.constBegin() + startingPoint, mCommits.constEnd(),
-                       [field, text](CommitInfo *info) { return info->getFieldStr(field).contains(text); });
+   return commit;
 }
 
-void RevisionsCache::resetLanes(const CommitInfo &c, bool isFork)
+void RevisionsCache::indexCommit(int row)
 {
-   const auto nextSha = c.parentsCount() == 0 ? QString() : c.parent(0);
+   const auto id = mCommits.id(row);
 
-   mLanes.nextParent(nextSha);
+   // The WIP commit is replaced every time the status changes and it is always found by its full SHA.
+   if (id == CommitInfo::ZERO_ID)
+      return;
 
-   if (c.parentsCount() > 1)
-      mLanes.afterMerge();
-   if (isFork)
-      mLanes.afterFork();
-   if (mLanes.isBranch())
-      mLanes.afterBranch();
-}
+   mPendingShaPrefixes.append(qMakePair(id.prefix64(), row));
+   mSearchIndex.addCommit(row);
 
-void RevisionsCache::clear()
-{
-   mCacheLocked = true;
-   mDirNames.clear();
-   mFileNames.clear();
-   mRevisionFilesMap.clear();
-   mLanes.clear();
-   mCommitsMap.clear();
-   mReferences.clear();
+   if (!mSearchIndexTimer->isActive())
+      mSearchIndexTimer->start();
 }
 
-int RevisionsCache::count() const
+void RevisionsCache::indexPendingSearchCommits()
 {
-   return mCommits.count();
+   if (mSearchIndex.indexPendingCommits(SEARCH_INDEX_SLICE_MS))
+      mSearchIndexTimer->stop();
 }
 
-RevisionFiles RevisionsCache::fakeWorkDirRevFile(const QString &diffIndex, const QString &diffIndexCache)
+int RevisionsCache::findByShaPrefix(const QString &shaPrefix) const
 {
-   FileNamesLoader fl;
-   auto rf = parseDiffFormat(diffIndex, fl);
-   fl.rf = &rf;
-   rf.setOnlyModified(false);
+   quint64 key = 0;
 
-   for (const auto &it : qAsConst(mUntrackedfiles))
+   if (!shaPrefixKey(shaPrefix, key))
+      return -1;
+
+   // The commits inserted since the last search are merged at once, so loading the history doesn't pay for sorting.
+   if (!mPendingShaPrefixes.isEmpty())
    {
-      if (fl.rf != &rf)
-      {
-         flushFileNames(fl);
-         fl.rf = &rf;
-      }
+      const auto byKey = [](const QPair<quint64, int> &a, const QPair<quint64, int> &b) {
+         return a.first < b.first;
+      };
+      const auto sortedCount = mShaPrefixIndex.count();
+
+      std::sort(mPendingShaPrefixes.begin(), mPendingShaPrefixes.end(), byKey);
+      mShaPrefixIndex.append(mPendingShaPrefixes);
+      mPendingShaPrefixes.clear();
 
-      appendFileName(it, fl);
-      rf.setStatus(RevisionFiles::UNKNOWN);
-      rf.mergeParent.append(1);
+      std::inplace_merge(mShaPrefixIndex.begin(), mShaPrefixIndex.begin() + sortedCount, mShaPrefixIndex.end(), byKey);
    }
 
-   RevisionFiles cachedFiles = parseDiffFormat(diffIndexCache, fl);
-   flushFileNames(fl);
+   const auto unusedBits = 4 * std::max(0, INDEXED_PREFIX_LENGTH - shaPrefix.length());
+   const auto lastKey = unusedBits == 0 ? key : key | ((quint64(1) << unusedBits) - 1);
+   auto it = std::lower_bound(mShaPrefixIndex.cbegin(), mShaPrefixIndex.cend(), key,
+                              [](const QPair<quint64, int> &entry, quint64 k) { return entry.first < k; });
 
-   for (auto i = 0; i < rf.count(); i++)
+   for (; it != mShaPrefixIndex.cend() && it->first <= lastKey; ++it)
    {
-      if (cachedFiles.mFiles.indexOf(rf.getFile(i)) != -1)
-      {
-         if (cachedFiles.statusCmp(i, RevisionFiles::CONFLICT))
-            rf.appendStatus(i, RevisionFiles::CONFLICT);
-
-         rf.appendStatus(i, RevisionFiles::IN_INDEX);
-      }
+      if (mCommits.id(it->second).startsWith(shaPrefix))
+         return it->second;
    }
 
-   return rf;
+   return -1;
 }
 
-RevisionFiles RevisionsCache::parseDiff(const QString &logDiff)
+int RevisionsCache::count() const
 {
-   FileNamesLoader fl;
-
-   auto rf = parseDiffFormat(logDiff, fl);
-   fl.rf = &rf;
-   flushFileNames(fl);
+   return mCommits.count();
+}
 
-   return rf;
+QString RevisionsCache::memoryReport() const
+{
+   const auto commitsUsage = mCommits.memoryUsage();
+   const auto indexUsage
+       = static_cast<size_t>(mShaPrefixIndex.capacity() + mPendingShaPrefixes.capacity()) * sizeof(QPair<quint64, int>);
+   const auto toKb = [](size_t bytes) { return QString::number(static_cast<double>(bytes) / 1024.0, 'f', 1); };
+
+   const auto stats = revisionFilesStats();
+
+   return QString("{%1} commits use {%2} KB ({%3} bytes per commit) plus {%4} KB of indexes. The lanes use {%5} "
+                  "checkpoints and {%6} KB of packed rows. The files of {%7} revisions use {%8} KB of {%9} KB ({%10} "
+                  "hits, {%11} misses, {%12} evictions).")
+       .arg(mCommits.count())
+       .arg(toKb(commitsUsage))
+       .arg(mCommits.count() == 0 ? 0 : commitsUsage / static_cast<size_t>(mCommits.count()))
+       .arg(toKb(indexUsage))
+       .arg(mLanesCheckpoints.count())
+       .arg(mLanesChunks.totalCost())
+       .arg(stats.entries)
+       .arg(toKb(static_cast<size_t>(stats.bytes)))
+       .arg(toKb(static_cast<size_t>(stats.budget)))
+       .arg(stats.hits)
+       .arg(stats.misses)
+       .arg(stats.evictions);
 }
 
-void RevisionsCache::setUntrackedFilesList(const QVector<QString> &untrackedFiles)
+QString RevisionsCache::filePatchKey(const QString &sha, const QString &parentSha, const QString &file)
 {
-   mUntrackedfiles = untrackedFiles;
+   return sha + '\n' + parentSha + '\n' + file;
 }
@@ -26,11 +26,22 @@
 #include <RevisionFiles.h>
 #include <lanes.h>
 #include <CommitInfo.h>
+#include <CommitsSearchIndex.h>
+#include <CommitsTable.h>
+#include <CommitGraph.h>
+#include <FileBlame.h>
+#include <PackedLanes.h>
 
 #include <QObject>
+#include <QCache>
 #include <QHash>
+#include <QMap>
+#include <QSet>
+
+#include <list>
 
 struct WorkingDirInfo;
+class QTimer;
 
 class RevisionsCache : public QObject
 {
@@ -49,34 +60,54 @@ public:
    };
 
    explicit RevisionsCache(QObject *parent = nullptr);
-   ~RevisionsCache();
 
    void configure(int numElementsToStore);
    void clear();
+   void truncate(int numElements);
 
    int count() const;
+   /**
+    * @brief Describes the memory used by the commits and by the files of the revisions. It's shown in the diagnostics
+    * dialog.
+    */
+   QString memoryReport() const;
 
    CommitInfo getCommitInfo(const QString &sha) const;
    CommitInfo getCommitInfoByRow(int row) const;
+   CommitInfo getCommitInfoByRowWithoutLanes(int row) const;
    int getCommitPos(const QString &sha) const;
-   CommitInfo getCommitInfoByField(CommitInfo::Field field, const QString &text, int startingPoint = 0);
+   QVector<int> searchCommits(const QString &query);
+   CommitGraph commitGraph() const;
    RevisionFiles getRevisionFile(const QString &sha1, const QString &sha2) const;
+   QByteArray getFilePatch(const QString &sha, const QString &parentSha, const QString &file) const;
+   FileBlame getFileBlame(const QString &sha, const QString &file) const;
 
    void insertCommitInfo(CommitInfo rev, int orderIdx);
+   int insertCommitsOnTop(const QVector<CommitInfo> &commits, const QString &headSha);
+   void insertLanesCheckpoint(int row, const Lanes &lanes);
+   /**
+    * @brief Sets the parent of the WIP that the lanes of the loaded commits are calculated from. It's null if the
+    * lanes start with the first commit.
+    */
+   void setLanesWipParent(const ObjectId &wipParentId) { mLanesWipParentId = wipParentId; }
 
    bool insertRevisionFile(const QString &sha1, const QString &sha2, const RevisionFiles &file);
+   bool insertFilePatch(const QString &sha, const QString &parentSha, const QString &file, const QByteArray &patch);
+   void removeFilePatches(const QString &sha);
+   bool insertFileBlame(const QString &sha, const QString &file, const FileBlame &blame);
    void insertReference(const QString &sha, References::Type type, const QString &reference);
    void insertLocalBranchDistances(const QString &name, const LocalBranchDistances &distances);
    LocalBranchDistances getLocalBranchDistances(const QString &name) { return mLocalBranchDistances.value(name); }
-   void updateWipCommit(const QString &parentSha, const QString &diffIndex, const QString &diffIndexCache);
+   void updateWipCommit(const QString &parentSha, const RevisionFiles &files, const QVector<QString> &untrackedFiles);
 
    void removeReference(const QString &sha);
+   void clearReferences();
 
    bool containsRevisionFile(const QString &sha1, const QString &sha2) const;
+   void setRevisionFilesBudget(qint64 bytes);
+   RevisionFilesStats revisionFilesStats() const;
+   bool containsFileBlame(const QString &sha, const QString &file) const;
 
-   RevisionFiles parseDiff(const QString &logDiff);
-
-   void setUntrackedFilesList(const QVector<QString> &untrackedFiles);
    bool pendingLocalChanges() const;
 
    QVector<QPair<QString, QStringList>> getBranches(References::Type type) const;
@@ -86,36 +117,49 @@ public:
 
 private:
    bool mCacheLocked = true;
-   QVector<CommitInfo *> mCommits;
-   QHash<QString, CommitInfo *> mCommitsMap;
-   QHash<QPair<QString, QString>, RevisionFiles> mRevisionFilesMap;
-   QVector<CommitInfo *> mReferences;
+   CommitsTable mCommits;
+   // The lanes of the WIP commit, the only row whose lanes are not calculated on demand.
+   QVector<Lane> mWipLanes;
+   // The rows of the commits sorted by the first digits of their SHA.
+   mutable QVector<QPair<quint64, int>> mShaPrefixIndex;
+   mutable QVector<QPair<quint64, int>> mPendingShaPrefixes;
+   CommitsSearchIndex mSearchIndex;
+   QTimer *mSearchIndexTimer = nullptr;
+   mutable QMap<int, Lanes> mLanesCheckpoints;
+   ObjectId mLanesWipParentId;
+   mutable QCache<int, PackedLanes> mLanesChunks;
+   // The patches of the files shown in the commit diffs. Only used from the GUI thread.
+   mutable QCache<QString, QByteArray> mFilePatches;
+   // The blames of the files shown in the blame view, by commit and file. Only used from the GUI thread.
+   mutable QCache<QString, FileBlame> mFileBlames;
+   using RevisionFilesKey = QPair<QString, QString>;
+
+   struct RevisionFilesEntry
+   {
+      RevisionFiles files;
+      qint64 size = 0;
+      std::list<RevisionFilesKey>::iterator lruPosition;
+   };
+
+   // The files of the revisions, evicted in LRU order when they use more memory than the budget. The WIP entries are
+   // never evicted nor accounted since the UI always expects them to be there.
+   QHash<RevisionFilesKey, RevisionFilesEntry> mRevisionFilesMap;
+   mutable std::list<RevisionFilesKey> mRevisionFilesLru;
+   mutable RevisionFilesStats mRevisionFilesStats;
+   // The references of the commits, and the commits that have them in the order they were added.
+   QHash<ObjectId, References> mReferences;
+   QVector<ObjectId> mReferencedCommits;
    QMap<QString, LocalBranchDistances> mLocalBranchDistances;
    Lanes mLanes;
-   QVector<QString> mDirNames;
-   QVector<QString> mFileNames;
    QVector<QString> mUntrackedfiles;
 
-   struct FileNamesLoader
-   {
-      FileNamesLoader()
-         : rf(nullptr)
-      {
-      }
-
-      RevisionFiles *rf;
-      QVector<int> rfDirs;
-      QVector<int> rfNames;
-      QVector<QString> files;
-   };
-
-   RevisionFiles fakeWorkDirRevFile(const QString &diffIndex, const QString &diffIndexCache);
+   CommitInfo commitAt(int row) const;
+   void indexCommit(int row);
+   void indexPendingSearchCommits();
+   static int lanesChunk(int row);
+   static QString filePatchKey(const QString &sha, const QString &parentSha, const QString &file);
+   void evictRevisionFiles();
+   QVector<Lane> lanesForRow(int row) const;
+   int findByShaPrefix(const QString &shaPrefix) const;
    QVector<Lane> calculateLanes(const CommitInfo &c);
-   RevisionFiles parseDiffFormat(const QString &buf, FileNamesLoader &fl);
-   void appendFileName(const QString &name, FileNamesLoader &fl);
-   void flushFileNames(FileNamesLoader &fl);
-   void setExtStatus(RevisionFiles &rf, const QString &rowSt, int parNum, FileNamesLoader &fl);
-   QVector<CommitInfo *>::const_iterator searchCommit(CommitInfo::Field field, const QString &text,
-                                                      int startingPoint = 0) const;
-   void resetLanes(const CommitInfo &c, bool isFork);
 };
@@ -0,0 +1,343 @@
+#include "RevisionsDiskCache.h"
+
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDir>
+#include <QFile>
+#include <QSaveFile>
+#include <QStandardPaths>
+
+#include <QLogger.h>
+
+using namespace QLogger;
+
+namespace
+{
+const quint32 CACHE_MAGIC = 0x47514331; // GQC1
+const quint32 TOP_CACHE_MAGIC = 0x47515431; // GQT1
+// Increase it every time the format of the files or the serialization of CommitInfo changes.
+const quint32 CACHE_VERSION = 4;
+// The commits on top can be up to a tenth of the rest before the whole history is written again.
+const auto MAX_TOP_COMMITS_RATIO = 10;
+}
+
+RevisionsDiskCache::RevisionsDiskCache(const QString &workingDir, const QString &logMode)
+   : mLogMode(logMode)
+{
+   const auto cacheDir = QString("%1/revisions").arg(QStandardPaths::writableLocation(QStandardPaths::CacheLocation));
+   const auto repoId = QCryptographicHash::hash(workingDir.toUtf8(), QCryptographicHash::Sha1).toHex();
+
+   QDir().mkpath(cacheDir);
+
+   mFilePath = QString("%1/%2.cache").arg(cacheDir, QString::fromLatin1(repoId));
+   mTopFilePath = QString("%1/%2.top.cache").arg(cacheDir, QString::fromLatin1(repoId));
+}
+
+QStringList RevisionsDiskCache::getTips() const
+{
+   QFile file(mFilePath);
+   QStringList tips;
+
+   if (file.open(QIODevice::ReadOnly))
+   {
+      QDataStream stream(&file);
+      quint32 commitsCount = 0;
+
+      if (!readHeader(stream, tips, commitsCount))
+         return QStringList();
+
+      QFile topFile(mTopFilePath);
+
+      if (topFile.open(QIODevice::ReadOnly))
+      {
+         QDataStream topStream(&topFile);
+         QStringList topTips;
+
+         if (readTopHeader(topStream, tips, topTips, commitsCount))
+            tips = topTips;
+      }
+   }
+
+   return tips;
+}
+
+int RevisionsDiskCache::commitsCount() const
+{
+   QFile file(mFilePath);
+
+   if (!file.open(QIODevice::ReadOnly))
+      return 0;
+
+   QDataStream stream(&file);
+   QStringList tips;
+   quint32 commitsCount = 0;
+
+   if (!readHeader(stream, tips, commitsCount))
+      return 0;
+
+   QFile topFile(mTopFilePath);
+   quint32 topCommitsCount = 0;
+
+   if (topFile.open(QIODevice::ReadOnly))
+   {
+      QDataStream topStream(&topFile);
+      QStringList topTips;
+
+      if (!readTopHeader(topStream, tips, topTips, topCommitsCount))
+         topCommitsCount = 0;
+   }
+
+   return static_cast<int>(commitsCount + topCommitsCount);
+}
+
+bool RevisionsDiskCache::canWriteOnTop(int commits) const
+{
+   QFile file(mFilePath);
+
+   if (!file.open(QIODevice::ReadOnly))
+      return false;
+
+   QDataStream stream(&file);
+   QStringList tips;
+   quint32 commitsCount = 0;
+
+   if (!readHeader(stream, tips, commitsCount))
+      return false;
+
+   QFile topFile(mTopFilePath);
+   quint32 topCommitsCount = 0;
+
+   if (topFile.open(QIODevice::ReadOnly))
+   {
+      QDataStream topStream(&topFile);
+      QStringList topTips;
+
+      if (!readTopHeader(topStream, tips, topTips, topCommitsCount))
+         topCommitsCount = 0;
+   }
+
+   return topCommitsCount + static_cast<quint32>(commits) <= commitsCount / MAX_TOP_COMMITS_RATIO;
+}
+
+bool RevisionsDiskCache::read(const std::function<void(const QVector<CommitInfo> &)> &batchReady, int batchSize,
+                              CommitStringsPool *stringsPool) const
+{
+   QFile file(mFilePath);
+
+   if (!file.open(QIODevice::ReadOnly))
+      return false;
+
+   QDataStream stream(&file);
+   QStringList tips;
+   quint32 commitsCount = 0;
+
+   if (!readHeader(stream, tips, commitsCount))
+      return false;
+
+   QVector<CommitInfo> batch;
+   batch.reserve(batchSize);
+
+   // The commits on top are newer, so they go first.
+   QFile topFile(mTopFilePath);
+
+   if (topFile.open(QIODevice::ReadOnly))
+   {
+      QDataStream topStream(&topFile);
+      QStringList topTips;
+      quint32 topCommitsCount = 0;
+
+      if (readTopHeader(topStream, tips, topTips, topCommitsCount)
+          && !readCommits(topStream, topCommitsCount, batchReady, batchSize, stringsPool, batch))
+      {
+         QLog_Warning("Git", QString("The revisions cache {%1} is corrupted.").arg(mTopFilePath));
+         return false;
+      }
+   }
+
+   if (!readCommits(stream, commitsCount, batchReady, batchSize, stringsPool, batch))
+   {
+      QLog_Warning("Git", QString("The revisions cache {%1} is corrupted.").arg(mFilePath));
+      return false;
+   }
+
+   if (!batch.isEmpty())
+      batchReady(batch);
+
+   return true;
+}
+
+bool RevisionsDiskCache::write(const QStringList &tips, const QVector<CommitInfo> &commits) const
+{
+   QSaveFile file(mFilePath);
+
+   if (!file.open(QIODevice::WriteOnly))
+   {
+      QLog_Warning("Git", QString("Unable to write the revisions cache {%1}.").arg(mFilePath));
+      return false;
+   }
+
+   QDataStream stream(&file);
+   stream.setVersion(QDataStream::Qt_5_12);
+   stream << CACHE_MAGIC << CACHE_VERSION << mLogMode << tips << static_cast<quint32>(commits.count());
+
+   for (const auto &commit : commits)
+      stream << commit;
+
+   const auto ok = stream.status() == QDataStream::Ok && file.commit();
+
+   if (ok)
+   {
+      // The commits on top of the previous history are part of this one.
+      QFile::remove(mTopFilePath);
+
+      QLog_Debug("Git", QString("Revisions cache written with {%1} commits.").arg(commits.count()));
+   }
+
+   return ok;
+}
+
+bool RevisionsDiskCache::writeOnTop(const QStringList &previousTips, const QStringList &tips,
+                                    const QVector<CommitInfo> &commits) const
+{
+   QFile baseFile(mFilePath);
+
+   if (!baseFile.open(QIODevice::ReadOnly))
+      return false;
+
+   QDataStream baseStream(&baseFile);
+   QStringList baseTips;
+   quint32 baseCommitsCount = 0;
+
+   if (!readHeader(baseStream, baseTips, baseCommitsCount))
+      return false;
+
+   // The commits that were already on top are written again below the new ones.
+   QVector<CommitInfo> previousCommits;
+   auto storedTips = baseTips;
+   QFile previousFile(mTopFilePath);
+
+   if (previousFile.open(QIODevice::ReadOnly))
+   {
+      QDataStream previousStream(&previousFile);
+      QStringList topTips;
+      quint32 previousCommitsCount = 0;
+
+      if (readTopHeader(previousStream, baseTips, topTips, previousCommitsCount))
+      {
+         storedTips = topTips;
+
+         // They are read in a single batch.
+         QVector<CommitInfo> batch;
+         batch.reserve(static_cast<int>(previousCommitsCount));
+
+         const auto ok = readCommits(
+             previousStream, previousCommitsCount,
+             [&previousCommits](const QVector<CommitInfo> &commits) { previousCommits = commits; },
+             static_cast<int>(previousCommitsCount), nullptr, batch);
+
+         if (!ok)
+            return false;
+      }
+
+      previousFile.close();
+   }
+
+   // Any commit between the stored ones and the new ones would be missing.
+   if (storedTips != previousTips)
+      return false;
+
+   QSaveFile file(mTopFilePath);
+
+   if (!file.open(QIODevice::WriteOnly))
+   {
+      QLog_Warning("Git", QString("Unable to write the revisions cache {%1}.").arg(mTopFilePath));
+      return false;
+   }
+
+   QDataStream stream(&file);
+   stream.setVersion(QDataStream::Qt_5_12);
+   stream << TOP_CACHE_MAGIC << CACHE_VERSION << mLogMode << baseTips << tips
+          << static_cast<quint32>(commits.count() + previousCommits.count());
+
+   for (const auto &commit : commits)
+      stream << commit;
+
+   for (const auto &commit : qAsConst(previousCommits))
+      stream << commit;
+
+   const auto ok = stream.status() == QDataStream::Ok && file.commit();
+
+   if (ok)
+   {
+      QLog_Debug("Git",
+                 QString("Revisions cache updated with {%1} commits on top of {%2}.")
+                     .arg(commits.count() + previousCommits.count())
+                     .arg(baseCommitsCount));
+   }
+
+   return ok;
+}
+
+bool RevisionsDiskCache::readHeader(QDataStream &stream, QStringList &tips, quint32 &commitsCount) const
+{
+   quint32 magic = 0;
+   quint32 version = 0;
+   QString logMode;
+
+   stream.setVersion(QDataStream::Qt_5_12);
+   stream >> magic >> version;
+
+   if (magic != CACHE_MAGIC || version != CACHE_VERSION)
+      return false;
+
+   stream >> logMode >> tips >> commitsCount;
+
+   return stream.status() == QDataStream::Ok && logMode == mLogMode;
+}
+
+bool RevisionsDiskCache::readTopHeader(QDataStream &stream, const QStringList &baseTips, QStringList &tips,
+                                       quint32 &commitsCount) const
+{
+   quint32 magic = 0;
+   quint32 version = 0;
+   QString logMode;
+   QStringList storedBaseTips;
+
+   stream.setVersion(QDataStream::Qt_5_12);
+   stream >> magic >> version;
+
+   if (magic != TOP_CACHE_MAGIC || version != CACHE_VERSION)
+      return false;
+
+   stream >> logMode >> storedBaseTips >> tips >> commitsCount;
+
+   // They are only valid on top of the history they were written for.
+   return stream.status() == QDataStream::Ok && logMode == mLogMode && storedBaseTips == baseTips;
+}
+
+bool RevisionsDiskCache::readCommits(QDataStream &stream, quint32 commitsCount,
+                                     const std::function<void(const QVector<CommitInfo> &)> &batchReady,
+                                     int batchSize, CommitStringsPool *stringsPool, QVector<CommitInfo> &batch) const
+{
+   for (auto i = 0U; i < commitsCount; ++i)
+   {
+      CommitInfo commit;
+      stream >> commit;
+
+      if (stream.status() != QDataStream::Ok)
+         return false;
+
+      if (stringsPool)
+         commit.shareStrings(*stringsPool);
+
+      batch.append(std::move(commit));
+
+      if (batch.count() == batchSize)
+      {
+         batchReady(batch);
+         batch.clear();
+      }
+   }
+
+   return true;
+}
@@ -0,0 +1,114 @@
+#pragma once
+
+/****************************************************************************************
+ ** GitQlient is an application to manage and operate one or several Git repositories. With
+ ** GitQlient you will be able to add commits, branches and manage all the options Git provides.
+ ** Copyright (C) 2020  Francesc Martinez
+ **
+ ** LinkedIn: www.linkedin.com/in/cescmm/
+ ** Web: www.francescmm.com
+ **
+ ** This program is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public
+ ** License as published by the Free Software Foundation; either
+ ** version 2 of the License, or (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this library; if not, write to the Free Software
+ ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ***************************************************************************************/
+
+#include <CommitInfo.h>
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+#include <functional>
+
+class QDataStream;
+
+/**
+ * @brief The RevisionsDiskCache class stores in disk the commits of a repository already parsed. Every
+ * file is versioned and keyed by the log mode (all branches or the current one) and the tips of the
+ * references when it was written, so the loader can decide if it can reuse it as it is or if it only needs to ask git
+ * for the commits that are new since then.
+ *
+ * The commits that are new since the whole history was written are kept in a second file, so a refresh that only
+ * brings a few commits doesn't rewrite the rest. Once they are too many compared to the rest, the whole history has
+ * to be written again.
+ *
+ * @class RevisionsDiskCache RevisionsDiskCache.h "RevisionsDiskCache.h"
+ */
+class RevisionsDiskCache
+{
+public:
+   /**
+    * @brief Default constructor.
+    *
+    * @param workingDir The working directory of the repository.
+    * @param logMode The revisions passed to git log (i.e. --all or the current branch).
+    */
+   explicit RevisionsDiskCache(const QString &workingDir, const QString &logMode);
+
+   /**
+    * @brief Gets the tips of the references stored in the cache.
+    *
+    * @return QStringList The sorted list of tips or an empty list if there is no valid cache for the log mode.
+    */
+   QStringList getTips() const;
+   /**
+    * @brief Gets the number of commits stored in the cache.
+    */
+   int commitsCount() const;
+   /**
+    * @brief Tells if some new commits can be stored on top of the ones in the cache with @ref writeOnTop or if the
+    * whole history has to be written with @ref write.
+    *
+    * @param commits The number of new commits.
+    */
+   bool canWriteOnTop(int commits) const;
+   /**
+    * @brief Reads all the commits stored in the cache.
+    *
+    * @param batchReady Function called for every batch of commits read.
+    * @param batchSize The maximum number of commits for every batch.
+    * @param stringsPool If set, the commits share their repeated strings through it.
+    * @return True if the whole file was read, false otherwise.
+    */
+   bool read(const std::function<void(const QVector<CommitInfo> &)> &batchReady, int batchSize,
+             CommitStringsPool *stringsPool = nullptr) const;
+   /**
+    * @brief Writes the commits in the cache replacing the previous content.
+    *
+    * @param tips The tips of the references that the commits belong to.
+    * @param commits The commits, without the WIP.
+    * @return True if the file was written, false otherwise.
+    */
+   bool write(const QStringList &tips, const QVector<CommitInfo> &commits) const;
+   /**
+    * @brief Writes the commits that are newer than the ones stored in the cache, keeping them.
+    *
+    * @param previousTips The tips the new commits were loaded from. They must be the ones stored in the cache.
+    * @param tips The tips of the references that all the commits belong to.
+    * @param commits The new commits, without the WIP.
+    * @return True if the file was written, false otherwise.
+    */
+   bool writeOnTop(const QStringList &previousTips, const QStringList &tips, const QVector<CommitInfo> &commits) const;
+
+private:
+   QString mFilePath;
+   QString mTopFilePath;
+   QString mLogMode;
+
+   bool readHeader(QDataStream &stream, QStringList &tips, quint32 &commitsCount) const;
+   bool readTopHeader(QDataStream &stream, const QStringList &baseTips, QStringList &tips, quint32 &commitsCount) const;
+   bool readCommits(QDataStream &stream, quint32 commitsCount,
+                    const std::function<void(const QVector<CommitInfo> &)> &batchReady, int batchSize,
+                    CommitStringsPool *stringsPool, QVector<CommitInfo> &batch) const;
+};
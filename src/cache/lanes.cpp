@@ -8,40 +8,92 @@
 */
 #include "lanes.h"
 
-#include <QStringList>
 
-void Lanes::init(const QString &expectedSha)
+void Lanes::init(const ObjectId &expectedSha)
 {
    clear();
    activeLane = 0;
-   add(LaneType::BRANCH, expectedSha, activeLane);
+   add(LaneType::BRANCH, expectedSha, pendingId(expectedSha), activeLane);
+}
+
+bool Lanes::operator==(const Lanes &lanes) const
+{
+   return activeLane == lanes.activeLane && typeVec == lanes.typeVec && nextShaVec == lanes.nextShaVec;
 }
 
 void Lanes::clear()
 {
    typeVec.clear();
    nextShaVec.clear();
+   nextIdVec.clear();
+   pendingIds.clear();
+   nextId = 0;
+}
+
+QVector<Lane> Lanes::processCommit(const ObjectId &sha, const QVector<ObjectId> &parents)
+{
+   QVector<Lane> lanes;
+
+   process(sha, parents, &lanes);
+
+   return lanes;
+}
+
+void Lanes::advance(const ObjectId &sha, const QVector<ObjectId> &parents)
+{
+   process(sha, parents, nullptr);
+}
+
+void Lanes::process(const ObjectId &sha, const QVector<ObjectId> &parents, QVector<Lane> *lanes)
+{
+   const auto shaId = takePendingId(sha);
+   bool isDiscontinuity;
+   const auto fork = isFork(shaId, isDiscontinuity);
+   const auto merge = parents.count() > 1;
+
+   if (isDiscontinuity)
+      changeActiveLane(sha, shaId); // uses previous isBoundary state
+
+   if (fork)
+      setFork(shaId);
+   if (merge)
+      setMerge(parents);
+   if (parents.isEmpty())
+      setInitial();
+
+   // Copying the row is only needed when it is displayed.
+   if (lanes)
+      *lanes = typeVec;
+
+   nextParent(parents.isEmpty() ? ObjectId() : parents.first());
+
+   if (merge)
+      afterMerge();
+   if (fork)
+      afterFork();
+   if (isBranch())
+      afterBranch();
 }
 
-bool Lanes::isFork(const QString &sha, bool &isDiscontinuity)
+bool Lanes::isFork(int shaId, bool &isDiscontinuity)
 {
-   int pos = findNextSha(sha, 0);
+   int pos = findNextSha(shaId, 0);
    isDiscontinuity = activeLane != pos;
 
-   return pos == -1 ? false : findNextSha(sha, pos + 1) != -1;
+   return pos == -1 ? false : findNextSha(shaId, pos + 1) != -1;
 }
 
-void Lanes::setFork(const QString &sha)
+void Lanes::setFork(int shaId)
 {
    auto rangeEnd = 0;
    auto idx = 0;
-   auto rangeStart = rangeEnd = idx = findNextSha(sha, 0);
+   auto rangeStart = rangeEnd = idx = findNextSha(shaId, 0);
 
    while (idx != -1)
    {
       rangeEnd = idx;
       typeVec[idx].setType(LaneType::TAIL);
-      idx = findNextSha(sha, idx + 1);
+      idx = findNextSha(shaId, idx + 1);
    }
 
    typeVec[activeLane].setType(NODE);
@@ -77,7 +129,7 @@ void Lanes::setFork(const QString &sha)
    }
 }
 
-void Lanes::setMerge(const QStringList &parents)
+void Lanes::setMerge(const QVector<ObjectId> &parents)
 {
    auto &t = typeVec[activeLane];
    auto wasFork = t.equals(NODE);
@@ -90,11 +142,12 @@ void Lanes::setMerge(const QStringList &parents)
 
    auto rangeStart = activeLane;
    auto rangeEnd = activeLane;
-   QStringList::const_iterator it(parents.constBegin());
+   auto it = parents.constBegin();
 
    for (++it; it != parents.constEnd(); ++it)
    { // skip first parent
-      int idx = findNextSha(*it, 0);
+      const auto parentId = pendingId(*it);
+      int idx = findNextSha(parentId, 0);
 
       if (idx != -1)
       {
@@ -113,7 +166,7 @@ void Lanes::setMerge(const QStringList &parents)
          typeVec[idx].setType(LaneType::JOIN);
       }
       else
-         rangeEnd = add(LaneType::HEAD, *it, rangeEnd + 1);
+         rangeEnd = add(LaneType::HEAD, *it, parentId, rangeEnd + 1);
    }
 
    auto &startT = typeVec[rangeStart];
@@ -158,7 +211,7 @@ void Lanes::setInitial()
       t.setType(LaneType::INITIAL);
 }
 
-void Lanes::changeActiveLane(const QString &sha)
+void Lanes::changeActiveLane(const ObjectId &sha, int shaId)
 {
    auto &t = typeVec[activeLane];
 
@@ -167,11 +220,11 @@ void Lanes::changeActiveLane(const QString &sha)
    else
       t.setType(LaneType::NOT_ACTIVE);
 
-   int idx = findNextSha(sha, 0); // find first sha
+   int idx = findNextSha(shaId, 0); // find first sha
    if (idx != -1)
       typeVec[idx].setType(LaneType::ACTIVE); // called before setBoundary()
    else
-      idx = add(LaneType::BRANCH, sha, activeLane); // new branch
+      idx = add(LaneType::BRANCH, sha, shaId, activeLane); // new branch
 
    activeLane = idx;
 }
@@ -210,6 +263,7 @@ void Lanes::afterFork()
    {
       typeVec.pop_back();
       nextShaVec.pop_back();
+      nextIdVec.pop_back();
    }
 }
 
@@ -223,22 +277,50 @@ void Lanes::afterBranch()
    typeVec[activeLane].setType(LaneType::ACTIVE); // TODO test with boundaries
 }
 
-void Lanes::nextParent(const QString &sha)
+void Lanes::nextParent(const ObjectId &sha)
 {
    nextShaVec[activeLane] = sha;
+   nextIdVec[activeLane] = sha.isNull() ? -1 : pendingId(sha);
 }
 
-int Lanes::findNextSha(const QString &next, int pos)
+int Lanes::findNextSha(int next, int pos) const
 {
-   for (int i = pos; i < nextShaVec.count(); i++)
+   const auto ids = nextIdVec.constData();
+   const auto count = nextIdVec.count();
+
+   for (int i = pos; i < count; i++)
    {
-      if (nextShaVec[i] == next)
+      if (ids[i] == next)
          return i;
    }
 
    return -1;
 }
 
+int Lanes::pendingId(const ObjectId &sha)
+{
+   auto it = pendingIds.constFind(sha);
+
+   if (it == pendingIds.constEnd())
+      it = pendingIds.insert(sha, nextId++);
+
+   return *it;
+}
+
+int Lanes::takePendingId(const ObjectId &sha)
+{
+   // The ids are never reused, so the lanes that still point to a processed commit don't match any other.
+   const auto it = pendingIds.find(sha);
+
+   if (it == pendingIds.end())
+      return nextId++;
+
+   const auto id = *it;
+   pendingIds.erase(it);
+
+   return id;
+}
+
 int Lanes::findType(const LaneType type, int pos)
 {
    const auto typeVecCount = typeVec.count();
@@ -252,7 +334,7 @@ int Lanes::findType(const LaneType type, int pos)
    return -1;
 }
 
-int Lanes::add(const LaneType type, const QString &next, int pos)
+int Lanes::add(const LaneType type, const ObjectId &next, int nextShaId, int pos)
 {
    // first check empty lanes starting from pos
    if (pos < typeVec.count())
@@ -262,6 +344,7 @@ int Lanes::add(const LaneType type, const QString &next, int pos)
       {
          typeVec[pos].setType(type);
          nextShaVec[pos] = next;
+         nextIdVec[pos] = nextShaId;
          return pos;
       }
    }
@@ -269,6 +352,7 @@ int Lanes::add(const LaneType type, const QString &next, int pos)
    // if all lanes are occupied add a new lane
    typeVec.append(type);
    nextShaVec.append(next);
+   nextIdVec.append(nextShaId);
    return typeVec.count() - 1;
 }
 
@@ -7,11 +7,14 @@
 #ifndef LANES_H
 #define LANES_H
 
+#include <QHash>
+#include <QMetaType>
 #include <QString>
 #include <QVector>
 
 #include <LaneType.h>
 #include <Lane.h>
+#include <ObjectId.h>
 
 //
 //  At any given time, the Lanes class represents a single revision (row) of the history graph.
@@ -23,39 +26,55 @@
 //
 //  The ListView class is responsible for rendering the glyphs.
 //
+//  The lanes are searched by the next commit on every revision, so each pending commit gets an integer id the first
+//  time it appears as a parent. The search compares those ids, and the id is released once the commit is processed
+//  since Git never shows a parent before all its children.
+//
 
 class Lanes
 {
 public:
    Lanes() { } // init() will setup us later, when data is available
+   bool operator==(const Lanes &lanes) const;
+   bool operator!=(const Lanes &lanes) const { return !(*this == lanes); }
    bool isEmpty() { return typeVec.empty(); }
-   void init(const QString &expectedSha);
+   void init(const ObjectId &expectedSha);
    void clear();
-   bool isFork(const QString &sha, bool &isDiscontinuity);
-   void setFork(const QString &sha);
-   void setMerge(const QStringList &parents);
+   QVector<Lane> processCommit(const ObjectId &sha, const QVector<ObjectId> &parents);
+   void advance(const ObjectId &sha, const QVector<ObjectId> &parents);
+   bool isFork(int shaId, bool &isDiscontinuity);
+   void setFork(int shaId);
+   void setMerge(const QVector<ObjectId> &parents);
    void setInitial();
-   void changeActiveLane(const QString &sha);
+   void changeActiveLane(const ObjectId &sha, int shaId);
    void afterMerge();
    void afterFork();
    bool isBranch();
    void afterBranch();
-   void nextParent(const QString &sha);
+   void nextParent(const ObjectId &sha);
    void setLanes(QVector<Lane> &ln) { ln = typeVec; } // O(1) vector is implicitly shared
    QVector<Lane> getLanes() const { return typeVec; }
 
 private:
-   int findNextSha(const QString &next, int pos);
+   void process(const ObjectId &sha, const QVector<ObjectId> &parents, QVector<Lane> *lanes);
+   int findNextSha(int next, int pos) const;
+   int pendingId(const ObjectId &sha);
+   int takePendingId(const ObjectId &sha);
    int findType(LaneType type, int pos);
-   int add(LaneType type, const QString &next, int pos);
+   int add(LaneType type, const ObjectId &next, int nextShaId, int pos);
    bool isNode(Lane lane) const;
 
-   int activeLane;
+   int activeLane = 0;
    QVector<Lane> typeVec; // Describes which glyphs should be drawn.
-   QVector<QString> nextShaVec; // The sha1 hashes of the next commit to appear in each lane (column).
+   QVector<ObjectId> nextShaVec; // The sha1 hashes of the next commit to appear in each lane (column).
+   QVector<int> nextIdVec; // The pending ids of nextShaVec. They are only valid inside this object.
+   QHash<ObjectId, int> pendingIds;
+   int nextId = 0;
    LaneType NODE = LaneType::MERGE_FORK;
    LaneType NODE_R = LaneType::MERGE_FORK_R;
    LaneType NODE_L = LaneType::MERGE_FORK_L;
 };
 
+Q_DECLARE_METATYPE(Lanes)
+
 #endif
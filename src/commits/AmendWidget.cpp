@@ -39,7 +39,14 @@ void AmendWidget::configure(const QString &sha)
    }
 
    const auto files = mCache->getRevisionFile(CommitInfo::ZERO_SHA, sha);
-   const auto amendFiles = mCache->getRevisionFile(sha, commit.parent(0));
+   auto amendFiles = mCache->getRevisionFile(sha, commit.parent(0));
+
+   // The files of the commit might have been evicted from the cache.
+   if (!mCache->containsRevisionFile(sha, commit.parent(0))
+       && mGit->diffTree()->files(sha, commit.parent(0), amendFiles))
+   {
+      mCache->insertRevisionFile(sha, commit.parent(0), amendFiles);
+   }
 
    if (mCurrentSha != sha)
    {
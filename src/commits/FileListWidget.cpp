@@ -3,7 +3,6 @@
 #include <FileContextMenu.h>
 #include <RevisionFiles.h>
 #include <FileListDelegate.h>
-#include <GitHistory.h>
 #include <GitQlientStyles.h>
 #include <RevisionsCache.h>
 #include <GitBase.h>
@@ -63,20 +62,12 @@ void FileListWidget::insertFiles(const QString &currentSha, const QString &compa
 {
    clear();
 
-   RevisionFiles files;
+   auto files = mCache->getRevisionFile(currentSha, compareToSha);
 
-   if (mCache->containsRevisionFile(currentSha, compareToSha))
-      files = mCache->getRevisionFile(currentSha, compareToSha);
-   else if (!compareToSha.isEmpty())
+   if (!mCache->containsRevisionFile(currentSha, compareToSha) && !compareToSha.isEmpty()
+       && mGit->diffTree()->files(currentSha, compareToSha, files))
    {
-      QScopedPointer<GitHistory> git(new GitHistory(mGit));
-      const auto ret = git->getDiffFiles(currentSha, compareToSha);
-
-      if (ret.success)
-      {
-         files = mCache->parseDiff(ret.output.toString());
-         mCache->insertRevisionFile(currentSha, compareToSha, files);
-      }
+      mCache->insertRevisionFile(currentSha, compareToSha, files);
    }
 
    if (files.count() != 0)
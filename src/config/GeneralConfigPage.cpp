@@ -24,6 +24,7 @@ GeneralConfigPage::GeneralConfigPage(QWidget *parent)
    , mStatusLabel(new QLabel())
    , mExternalEditor(new QLineEdit())
    , mStylesSchema(new QComboBox())
+   , mRevisionFilesCache(new QSpinBox())
    , mReset(new QPushButton(tr("Reset")))
    , mApply(new QPushButton(tr("Apply")))
 
@@ -68,6 +69,12 @@ GeneralConfigPage::GeneralConfigPage(QWidget *parent)
    mStylesSchema->addItems({ "dark", "bright" });
    mStylesSchema->setCurrentText(settings.value("colorSchema", "bright").toString());
 
+   mRevisionFilesCache->setRange(8, 1024);
+   mRevisionFilesCache->setSuffix(tr(" MB"));
+   mRevisionFilesCache->setToolTip(tr("Memory used to keep the files of the visited commits. It's applied when a "
+                                      "repository is opened."));
+   mRevisionFilesCache->setValue(settings.value("revisionFilesCacheMB", 64).toInt());
+
    mStatusLabel->setObjectName("configLabel");
 
    connect(mReset, &QPushButton::clicked, this, &GeneralConfigPage::resetChanges);
@@ -101,6 +108,8 @@ GeneralConfigPage::GeneralConfigPage(QWidget *parent)
    layout->addWidget(mExternalEditor, row, 1);
    layout->addWidget(new QLabel(tr("Styles schema")), ++row, 0);
    layout->addWidget(mStylesSchema, row, 1);
+   layout->addWidget(new QLabel(tr("Commit files cache")), ++row, 0);
+   layout->addWidget(mRevisionFilesCache, row, 1);
    layout->addItem(new QSpacerItem(1, 1, QSizePolicy::Expanding, QSizePolicy::Expanding), ++row, 0, 1, 2);
    layout->addLayout(buttonsLayout, ++row, 0, 1, 2);
 }
@@ -116,6 +125,7 @@ void GeneralConfigPage::resetChanges()
    mExternalEditor->setText(
        settings.value(GitQlientSettings::ExternalEditorKey, GitQlientSettings::ExternalEditorValue).toString());
    mStylesSchema->setCurrentText(settings.value("colorSchema", "bright").toString());
+   mRevisionFilesCache->setValue(settings.value("revisionFilesCacheMB", 64).toInt());
 
    QTimer::singleShot(3000, mStatusLabel, &QLabel::clear);
 
@@ -132,6 +142,7 @@ void GeneralConfigPage::applyChanges()
    settings.setValue("autoFormat", mAutoFormat->isChecked());
    settings.setValue(GitQlientSettings::ExternalEditorKey, mExternalEditor->text());
    settings.setValue("colorSchema", mStylesSchema->currentText());
+   settings.setValue("revisionFilesCacheMB", mRevisionFilesCache->value());
 
    QTimer::singleShot(3000, mStatusLabel, &QLabel::clear);
    mStatusLabel->setText(tr("Changes applied! \n Reset is needed if the color schema changed."));
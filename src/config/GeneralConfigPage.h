@@ -39,6 +39,7 @@ following:
 - Auto-prune: The user can configure the interval where GitQlient performs a prune.
 - Disable logs: The user can enable or disable logs.
 - Log level: The user can configure the level of the logs for GitQlient.
+- Commit files cache: The user can configure the memory used to keep the files of the visited commits.
 
 */
 class GeneralConfigPage : public QFrame
@@ -62,6 +63,7 @@ private:
    QLabel *mStatusLabel = nullptr;
    QLineEdit *mExternalEditor = nullptr;
    QComboBox *mStylesSchema = nullptr;
+   QSpinBox *mRevisionFilesCache = nullptr;
    QPushButton *mReset = nullptr;
    QPushButton *mApply = nullptr;
 
@@ -4,8 +4,10 @@ HEADERS += \
     $$PWD/CommitDiffWidget.h \
     $$PWD/DiffButton.h \
     $$PWD/DiffInfoPanel.h \
+    $$PWD/DiffLineStore.h \
+    $$PWD/FileBlameView.h \
     $$PWD/FileBlameWidget.h \
-    $$PWD/FileDiffHighlighter.h \
+    $$PWD/FileDiffHunks.h \
     $$PWD/FileDiffView.h \
     $$PWD/FileDiffWidget.h \
     $$PWD/FullDiffWidget.h
@@ -14,8 +16,10 @@ SOURCES += \
     $$PWD/CommitDiffWidget.cpp \
     $$PWD/DiffButton.cpp \
     $$PWD/DiffInfoPanel.cpp \
+    $$PWD/DiffLineStore.cpp \
+    $$PWD/FileBlameView.cpp \
     $$PWD/FileBlameWidget.cpp \
-    $$PWD/FileDiffHighlighter.cpp \
+    $$PWD/FileDiffHunks.cpp \
     $$PWD/FileDiffView.cpp \
     $$PWD/FileDiffWidget.cpp \
     $$PWD/FullDiffWidget.cpp
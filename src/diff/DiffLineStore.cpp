@@ -0,0 +1,228 @@
+#include "DiffLineStore.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace
+{
+bool startsWith(const char *line, int length, const char *prefix)
+{
+   const auto prefixLength = static_cast<int>(strlen(prefix));
+
+   return length >= prefixLength && memcmp(line, prefix, prefixLength) == 0;
+}
+
+bool isChange(DiffLineStore::LineType type)
+{
+   return type == DiffLineStore::LineType::Addition || type == DiffLineStore::LineType::Deletion;
+}
+}
+
+void DiffLineStore::clear()
+{
+   mData.clear();
+   mLineStarts.clear();
+   mLineTypes.clear();
+   mFileLines.clear();
+   mHunkLines.clear();
+   mChangeLines.clear();
+   mIndexedBytes = 0;
+   mLastLineEnd = 0;
+   mCurrentColumns = 0;
+   mMaxLineLength = 0;
+   mInFileHeader = false;
+   mFinished = false;
+}
+
+void DiffLineStore::truncate(int lineCount)
+{
+   if (lineCount <= 0)
+   {
+      clear();
+      return;
+   }
+
+   if (lineCount >= mLineStarts.count())
+      return;
+
+   const auto removeFrom = [lineCount](QVector<int> &anchors) {
+      anchors.erase(std::lower_bound(anchors.begin(), anchors.end(), lineCount), anchors.end());
+   };
+
+   mData.truncate(mLineStarts.at(lineCount));
+   mLineStarts.resize(lineCount);
+   mLineTypes.resize(lineCount);
+   removeFrom(mFileLines);
+   removeFrom(mHunkLines);
+   removeFrom(mChangeLines);
+   mIndexedBytes = mData.size();
+   mLastLineEnd = mData.size() - 1;
+   mCurrentColumns = 0;
+   mFinished = false;
+
+   const auto lastType = lineType(lineCount - 1);
+   mInFileHeader = lastType == LineType::FileHeader || lastType == LineType::Header;
+}
+
+void DiffLineStore::append(const QByteArray &chunk)
+{
+   const auto scannedBytes = mData.size();
+   mData.append(chunk);
+
+   const auto data = mData.constData();
+   const auto size = mData.size();
+   auto lineStart = mIndexedBytes;
+
+   // The columns of the incomplete line are kept between chunks, so every byte is only visited once.
+   for (auto i = scannedBytes; i < size; ++i)
+   {
+      const auto byte = static_cast<uchar>(data[i]);
+
+      if (byte == '\n')
+      {
+         indexLine(lineStart, i);
+         lineStart = i + 1;
+      }
+      else if (byte == '\t')
+         mCurrentColumns += TAB_SIZE - mCurrentColumns % TAB_SIZE;
+      else if ((byte & 0xC0) != 0x80)
+         ++mCurrentColumns;
+   }
+
+   mIndexedBytes = lineStart;
+}
+
+void DiffLineStore::finish()
+{
+   if (!mFinished && mIndexedBytes < mData.size())
+   {
+      indexLine(mIndexedBytes, mData.size());
+      mIndexedBytes = mData.size();
+   }
+
+   mFinished = true;
+}
+
+QString DiffLineStore::line(int index) const
+{
+   const auto start = mLineStarts.at(index);
+   auto end = lineEnd(index);
+
+   if (end > start && mData.at(end - 1) == '\r')
+      --end;
+
+   return QString::fromUtf8(mData.constData() + start, end - start);
+}
+
+QString DiffLineStore::text(int first, int last) const
+{
+   const auto start = mLineStarts.at(first);
+   const auto end = lineEnd(last);
+
+   return QString::fromUtf8(mData.constData() + start, end - start);
+}
+
+QString DiffLineStore::fileName(int fileIndex) const
+{
+   const auto header = line(mFileLines.at(fileIndex));
+   const auto newFile = header.lastIndexOf(" b/");
+
+   if (newFile != -1)
+      return header.mid(newFile + 3);
+
+   // Combined diffs of merges only have one name: "diff --cc <file>".
+   return header.section(' ', 2);
+}
+
+int DiffLineStore::nextAnchor(const QVector<int> &anchors, int line)
+{
+   const auto iter = std::upper_bound(anchors.cbegin(), anchors.cend(), line);
+
+   return iter != anchors.cend() ? *iter : -1;
+}
+
+int DiffLineStore::previousAnchor(const QVector<int> &anchors, int line)
+{
+   const auto iter = std::lower_bound(anchors.cbegin(), anchors.cend(), line);
+
+   return iter != anchors.cbegin() ? *(iter - 1) : -1;
+}
+
+QString DiffLineStore::expandTabs(const QString &text)
+{
+   if (!text.contains('\t'))
+      return text;
+
+   QString expanded;
+   expanded.reserve(text.size() + TAB_SIZE * 4);
+
+   for (const auto &character : text)
+   {
+      if (character == '\t')
+         expanded.append(QString(TAB_SIZE - expanded.size() % TAB_SIZE, QLatin1Char(' ')));
+      else
+         expanded.append(character);
+   }
+
+   return expanded;
+}
+
+int DiffLineStore::lineEnd(int index) const
+{
+   return index + 1 < mLineStarts.count() ? mLineStarts.at(index + 1) - 1 : mLastLineEnd;
+}
+
+void DiffLineStore::indexLine(int start, int end)
+{
+   const auto index = mLineStarts.count();
+   const auto type = classify(mData.constData() + start, end - start);
+
+   mLineStarts.append(start);
+   mLineTypes.append(static_cast<quint8>(type));
+   mLastLineEnd = end;
+   mMaxLineLength = qMax(mMaxLineLength, mCurrentColumns);
+   mCurrentColumns = 0;
+
+   if (type == LineType::FileHeader)
+      mFileLines.append(index);
+   else if (type == LineType::Hunk)
+      mHunkLines.append(index);
+   else if (isChange(type) && (index == 0 || !isChange(lineType(index - 1))))
+      mChangeLines.append(index);
+}
+
+DiffLineStore::LineType DiffLineStore::classify(const char *line, int length)
+{
+   if (length == 0)
+      return LineType::Context;
+
+   if (startsWith(line, length, "diff --git ") || startsWith(line, length, "diff --cc ")
+       || startsWith(line, length, "diff --combined "))
+   {
+      mInFileHeader = true;
+      return LineType::FileHeader;
+   }
+
+   if (startsWith(line, length, EXPANDER_PREFIX))
+      return LineType::Expander;
+
+   if (line[0] == '@' && startsWith(line, length, "@@"))
+   {
+      mInFileHeader = false;
+      return LineType::Hunk;
+   }
+
+   // Until the first hunk, the lines after "diff --git" are the extended header, including the "---" and "+++" lines.
+   if (mInFileHeader)
+      return LineType::Header;
+
+   switch (line[0])
+   {
+      case '+':
+         return LineType::Addition;
+      case '-':
+         return LineType::Deletion;
+      default:
+         return LineType::Context;
+   }
+}
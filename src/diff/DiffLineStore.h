@@ -0,0 +1,159 @@
+#pragma once
+
+/****************************************************************************************
+ ** GitQlient is an application to manage and operate one or several Git repositories. With
+ ** GitQlient you will be able to add commits, branches and manage all the options Git provides.
+ ** Copyright (C) 2020  Francesc Martinez
+ **
+ ** LinkedIn: www.linkedin.com/in/cescmm/
+ ** Web: www.francescmm.com
+ **
+ ** This program is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public
+ ** License as published by the Free Software Foundation; either
+ ** version 2 of the License, or (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this library; if not, write to the Free Software
+ ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ***************************************************************************************/
+
+#include <QByteArray>
+#include <QString>
+#include <QVector>
+
+/**
+ * @brief The DiffLineStore class keeps the raw output of a git diff and an index with the offset where every line
+ * starts, so any line can be read without splitting the whole text. The data can be appended in chunks as it's read
+ * from git: the lines are indexed as soon as they are complete.
+ *
+ * While indexing, every line is classified and the lines that start a file, a hunk or a block of changes are stored
+ * so the views can jump between them.
+ *
+ * @class DiffLineStore DiffLineStore.h "DiffLineStore.h"
+ */
+class DiffLineStore
+{
+public:
+   /**
+    * @brief The kind of a diff line. It's enough to know how to paint it.
+    */
+   enum class LineType : quint8
+   {
+      Context,
+      Addition,
+      Deletion,
+      Hunk,
+      FileHeader,
+      Header,
+      Expander
+   };
+
+   /**
+    * @brief The prefix of the lines that stand for a collapsed region of unchanged lines. No line of a git diff starts
+    * with it, so they are never taken for a hunk.
+    */
+   static constexpr const char *EXPANDER_PREFIX = "\xE2\x8B\xAF "; // U+22EF, midline horizontal ellipsis.
+
+
+   /**
+    * @brief Removes all the data.
+    */
+   void clear();
+   /**
+    * @brief Removes the lines from @p lineCount to the end, so new data can be appended after the lines that are kept.
+    * The longest line length isn't recalculated.
+    *
+    * @param lineCount The number of lines to keep.
+    */
+   void truncate(int lineCount);
+   /**
+    * @brief Appends a chunk of the diff and indexes the lines it completes.
+    *
+    * @param chunk The raw data read from git.
+    */
+   void append(const QByteArray &chunk);
+   /**
+    * @brief Indexes the last line even if it doesn't end with a new line. Must be called once all the data was
+    * appended.
+    */
+   void finish();
+
+   bool isEmpty() const { return mLineStarts.isEmpty(); }
+   int lineCount() const { return mLineStarts.count(); }
+   /**
+    * @brief Returns the raw data appended so far.
+    */
+   const QByteArray &data() const { return mData; }
+   /**
+    * @brief Returns the text of a line without the end of line.
+    */
+   QString line(int index) const;
+   LineType lineType(int index) const { return static_cast<LineType>(mLineTypes.at(index)); }
+   /**
+    * @brief Returns the text of a range of lines, both included, joined with new lines.
+    */
+   QString text(int first, int last) const;
+   /**
+    * @brief Returns the length in characters of the longest line, with the tabs already expanded.
+    */
+   int maxLineLength() const { return mMaxLineLength; }
+
+   /**
+    * @brief Returns the lines that start a file diff (the "diff --git" lines).
+    */
+   const QVector<int> &fileLines() const { return mFileLines; }
+   /**
+    * @brief Returns the name of the file whose diff starts at the position @p fileIndex of @ref fileLines.
+    */
+   QString fileName(int fileIndex) const;
+   /**
+    * @brief Returns the lines that start a hunk (the "@@" lines).
+    */
+   const QVector<int> &hunkLines() const { return mHunkLines; }
+   /**
+    * @brief Returns the first line of every block of consecutive additions and deletions.
+    */
+   const QVector<int> &changeLines() const { return mChangeLines; }
+
+   /**
+    * @brief Returns the first anchor of @p anchors after @p line, or -1 if there is none.
+    */
+   static int nextAnchor(const QVector<int> &anchors, int line);
+   /**
+    * @brief Returns the last anchor of @p anchors before @p line, or -1 if there is none.
+    */
+   static int previousAnchor(const QVector<int> &anchors, int line);
+
+   /**
+    * @brief The number of columns a tab takes.
+    */
+   static const int TAB_SIZE = 4;
+   /**
+    * @brief Replaces the tabs of @p text by spaces up to the next tab stop.
+    */
+   static QString expandTabs(const QString &text);
+
+private:
+   QByteArray mData;
+   QVector<int> mLineStarts;
+   QVector<quint8> mLineTypes;
+   QVector<int> mFileLines;
+   QVector<int> mHunkLines;
+   QVector<int> mChangeLines;
+   int mIndexedBytes = 0;
+   int mLastLineEnd = 0;
+   int mCurrentColumns = 0;
+   int mMaxLineLength = 0;
+   bool mInFileHeader = false;
+   bool mFinished = false;
+
+   int lineEnd(int index) const;
+   void indexLine(int start, int end);
+   LineType classify(const char *line, int length);
+};
@@ -0,0 +1,363 @@
+#include "FileBlameView.h"
+
+#include <CommitInfo.h>
+#include <DiffLineStore.h>
+#include <FileBlame.h>
+#include <GitQlientStyles.h>
+
+#include <QApplication>
+#include <QClipboard>
+#include <QDateTime>
+#include <QHelpEvent>
+#include <QKeyEvent>
+#include <QPainter>
+#include <QScrollBar>
+#include <QToolTip>
+
+#include <array>
+
+namespace
+{
+const auto TEXT_MARGIN = 4;
+const auto GUIDE_WIDTH = 5;
+
+// Width in characters of the columns of the commit information.
+const auto DATE_COLUMNS = 18;
+const auto AUTHOR_COLUMNS = 18;
+const auto SUMMARY_COLUMNS = 40;
+
+const std::array<QColor, 8> AGE_COLORS { QColor(25, 65, 99),    QColor(36, 95, 146),  QColor(44, 116, 177),
+                                         QColor(56, 136, 205),  QColor(87, 155, 213), QColor(118, 174, 221),
+                                         QColor(150, 192, 221), QColor(197, 220, 240) };
+
+const QColor WIP_COLOR("#D89000");
+
+QString relativeDate(qint64 secsSinceEpoch)
+{
+   const auto dateTime = QDateTime::fromSecsSinceEpoch(secsSinceEpoch);
+   const auto now = QDateTime::currentDateTime();
+   const auto days = dateTime.daysTo(now);
+   const auto secs = dateTime.secsTo(now);
+
+   if (days > 365)
+      return QObject::tr("more than 1 year ago");
+   else if (days > 1)
+      return QObject::tr("%1 days ago").arg(days);
+   else if (days == 1)
+      return QObject::tr("yesterday");
+   else if (secs > 3600)
+      return QObject::tr("%1 hours ago").arg(secs / 3600);
+   else if (secs == 3600)
+      return QObject::tr("1 hour ago");
+   else if (secs > 60)
+      return QObject::tr("%1 minutes ago").arg(secs / 60);
+   else if (secs == 60)
+      return QObject::tr("1 minute ago");
+
+   return QObject::tr("%1 secs ago").arg(secs);
+}
+}
+
+FileBlameView::FileBlameView(QWidget *parent)
+   : QAbstractScrollArea(parent)
+{
+   setFocusPolicy(Qt::StrongFocus);
+   viewport()->setMouseTracking(true);
+
+   QFont font;
+   font.setFamily(QString::fromUtf8("Ubuntu Mono"));
+   font.setStyleHint(QFont::Monospace);
+   font.setPointSize(10);
+   setFont(font);
+
+   mInfoFont.setPointSize(9);
+
+   updateScrollBars();
+}
+
+void FileBlameView::setBlame(const FileBlame *blame)
+{
+   mBlame = blame;
+   mSelectionAnchor = -1;
+   mSelectionEnd = -1;
+
+   verticalScrollBar()->setValue(0);
+   horizontalScrollBar()->setValue(0);
+
+   updateBlame();
+}
+
+void FileBlameView::updateBlame()
+{
+   updateScrollBars();
+   viewport()->update();
+}
+
+void FileBlameView::paintEvent(QPaintEvent *)
+{
+   if (!mBlame)
+      return;
+
+   QPainter painter(viewport());
+
+   const auto metrics = fontMetrics();
+   const auto infoMetrics = QFontMetrics(mInfoFont);
+   const auto lineHeight = metrics.height();
+   const auto charWidth = characterWidth();
+   const auto infoCharWidth = infoMetrics.averageCharWidth();
+   const auto infoWidth = annotationWidth();
+   const auto numbersWidth = lineNumberAreaWidth();
+   const auto codeX = infoWidth + numbersWidth;
+   const auto viewportRect = viewport()->rect();
+   const auto codeRect = viewportRect.adjusted(codeX, 0, 0, 0);
+   const auto first = verticalScrollBar()->value();
+   const auto last = qMin(mBlame->lineCount() - 1, first + viewportRect.height() / lineHeight + 1);
+   const auto selectionFirst = qMin(mSelectionAnchor, mSelectionEnd);
+   const auto selectionLast = qMax(mSelectionAnchor, mSelectionEnd);
+   const auto infoY = (lineHeight - infoMetrics.height()) / 2 + infoMetrics.ascent();
+
+   // Only the columns that fit in the view are painted, so very long lines don't slow down the painting.
+   const auto scroll = horizontalScrollBar()->value();
+   const auto firstColumn = scroll / charWidth;
+   const auto visibleColumns = codeRect.width() / charWidth + 2;
+   const auto textX = codeX + TEXT_MARGIN - scroll % charWidth;
+
+   painter.fillRect(0, 0, codeX, viewportRect.height(), GitQlientStyles::getBackgroundColor());
+
+   for (auto i = first; i <= last; ++i)
+   {
+      const auto y = (i - first) * lineHeight;
+      const auto commitIndex = mBlame->lineCommit(i);
+      const auto startsBlock = mBlame->startsBlock(i);
+
+      if (startsBlock && i != 0)
+      {
+         painter.setPen(palette().color(QPalette::Mid));
+         painter.drawLine(0, y, infoWidth, y);
+      }
+
+      // The first visible line always shows its commit, so the information doesn't scroll out of the view.
+      if (commitIndex != -1 && (startsBlock || i == first))
+      {
+         const auto &commit = mBlame->commit(commitIndex);
+         const auto isWip = commit.sha == CommitInfo::ZERO_SHA;
+         const auto date = isWip ? QString() : relativeDate(commit.authorTime);
+         const auto summary = isWip ? tr("Local changes") : commit.summary;
+         auto x = TEXT_MARGIN;
+
+         painter.setFont(mInfoFont);
+         painter.setPen(GitQlientStyles::getTextColor());
+         painter.drawText(x, y + infoY,
+                          infoMetrics.elidedText(date, Qt::ElideRight, DATE_COLUMNS * infoCharWidth - TEXT_MARGIN));
+         x += DATE_COLUMNS * infoCharWidth;
+         painter.drawText(x, y + infoY,
+                          infoMetrics.elidedText(commit.author, Qt::ElideRight,
+                                                 AUTHOR_COLUMNS * infoCharWidth - TEXT_MARGIN));
+         x += AUTHOR_COLUMNS * infoCharWidth;
+         painter.drawText(x, y + infoY,
+                          infoMetrics.elidedText(summary, Qt::ElideRight,
+                                                 SUMMARY_COLUMNS * infoCharWidth - TEXT_MARGIN));
+      }
+
+      if (commitIndex != -1)
+         painter.fillRect(infoWidth, y, GUIDE_WIDTH, lineHeight, ageColor(commitIndex));
+
+      painter.setFont(font());
+      painter.setPen(GitQlientStyles::getTextColor());
+      painter.drawText(infoWidth + GUIDE_WIDTH, y, numbersWidth - GUIDE_WIDTH - TEXT_MARGIN, lineHeight,
+                       Qt::AlignRight, QString::number(i + 1));
+
+      if (i >= selectionFirst && i <= selectionLast)
+         painter.fillRect(QRect(codeX, y, codeRect.width(), lineHeight), GitQlientStyles::getGraphSelectionColor());
+
+      painter.setClipRect(codeRect);
+      painter.drawText(textX, y + metrics.ascent(),
+                       DiffLineStore::expandTabs(mBlame->line(i)).mid(firstColumn, visibleColumns));
+      painter.setClipping(false);
+   }
+
+   painter.setPen(palette().color(QPalette::Mid));
+   painter.drawLine(codeX - 1, 0, codeX - 1, viewportRect.height());
+}
+
+void FileBlameView::resizeEvent(QResizeEvent *event)
+{
+   QAbstractScrollArea::resizeEvent(event);
+
+   updateScrollBars();
+}
+
+void FileBlameView::keyPressEvent(QKeyEvent *event)
+{
+   if (mBlame && event->matches(QKeySequence::Copy) && mSelectionAnchor != -1)
+   {
+      QStringList lines;
+
+      for (auto i = qMin(mSelectionAnchor, mSelectionEnd); i <= qMax(mSelectionAnchor, mSelectionEnd); ++i)
+         lines.append(mBlame->line(i));
+
+      QApplication::clipboard()->setText(lines.join('\n'));
+   }
+   else if (mBlame && event->matches(QKeySequence::SelectAll) && mBlame->lineCount() > 0)
+   {
+      mSelectionAnchor = 0;
+      mSelectionEnd = mBlame->lineCount() - 1;
+      viewport()->update();
+   }
+   else
+      QAbstractScrollArea::keyPressEvent(event);
+}
+
+void FileBlameView::mousePressEvent(QMouseEvent *event)
+{
+   const auto line = lineAt(event->pos());
+
+   if (event->button() == Qt::LeftButton && line != -1)
+   {
+      if (event->pos().x() < annotationWidth())
+      {
+         const auto commitIndex = mBlame->lineCommit(line);
+
+         if (commitIndex != -1)
+            emit signalCommitSelected(mBlame->commit(commitIndex).sha);
+      }
+      else
+      {
+         if (!(event->modifiers() & Qt::ShiftModifier) || mSelectionAnchor == -1)
+            mSelectionAnchor = line;
+
+         mSelectionEnd = line;
+         viewport()->update();
+      }
+   }
+
+   QAbstractScrollArea::mousePressEvent(event);
+}
+
+void FileBlameView::mouseMoveEvent(QMouseEvent *event)
+{
+   const auto line = lineAt(event->pos());
+
+   if ((event->buttons() & Qt::LeftButton) && mSelectionAnchor != -1)
+   {
+      // Dragging out of the view scrolls to extend the selection.
+      if (event->pos().y() < 0)
+         verticalScrollBar()->triggerAction(QAbstractSlider::SliderSingleStepSub);
+      else if (event->pos().y() > viewport()->height())
+         verticalScrollBar()->triggerAction(QAbstractSlider::SliderSingleStepAdd);
+
+      if (line != -1)
+      {
+         mSelectionEnd = line;
+         viewport()->update();
+      }
+   }
+
+   const auto overCommit = line != -1 && event->pos().x() < annotationWidth() && mBlame->lineCommit(line) != -1;
+   viewport()->setCursor(overCommit ? Qt::PointingHandCursor : Qt::ArrowCursor);
+
+   QAbstractScrollArea::mouseMoveEvent(event);
+}
+
+bool FileBlameView::viewportEvent(QEvent *event)
+{
+   if (event->type() != QEvent::ToolTip)
+      return QAbstractScrollArea::viewportEvent(event);
+
+   const auto helpEvent = static_cast<QHelpEvent *>(event);
+   const auto line = lineAt(helpEvent->pos());
+   const auto commitIndex = line != -1 && helpEvent->pos().x() < annotationWidth() ? mBlame->lineCommit(line) : -1;
+
+   if (commitIndex != -1)
+   {
+      const auto &commit = mBlame->commit(commitIndex);
+      const auto isWip = commit.sha == CommitInfo::ZERO_SHA;
+      const auto date = QDateTime::fromSecsSinceEpoch(commit.authorTime).toString("dd/MM/yyyy hh:mm");
+
+      QToolTip::showText(helpEvent->globalPos(),
+                         QString("<p>%1</p><p>%2</p><p>%3 - %4</p>")
+                             .arg(commit.sha, (isWip ? tr("Local changes") : commit.summary).toHtmlEscaped(),
+                                  commit.author.toHtmlEscaped(), date),
+                         viewport());
+   }
+   else
+      QToolTip::hideText();
+
+   return true;
+}
+
+void FileBlameView::updateScrollBars()
+{
+   const auto lineCount = mBlame ? mBlame->lineCount() : 0;
+   const auto lineHeight = fontMetrics().height();
+   const auto visibleLines = qMax(1, viewport()->height() / lineHeight);
+
+   verticalScrollBar()->setPageStep(visibleLines);
+   verticalScrollBar()->setRange(0, qMax(0, lineCount - visibleLines));
+
+   const auto textWidth = (mBlame ? mBlame->maxLineLength() : 0) * characterWidth() + 2 * TEXT_MARGIN;
+   const auto availableWidth = viewport()->width() - annotationWidth() - lineNumberAreaWidth();
+
+   horizontalScrollBar()->setSingleStep(characterWidth());
+   horizontalScrollBar()->setPageStep(availableWidth);
+   horizontalScrollBar()->setRange(0, qMax(0, textWidth - availableWidth));
+}
+
+int FileBlameView::annotationWidth() const
+{
+   return (DATE_COLUMNS + AUTHOR_COLUMNS + SUMMARY_COLUMNS) * QFontMetrics(mInfoFont).averageCharWidth()
+       + 2 * TEXT_MARGIN;
+}
+
+int FileBlameView::lineNumberAreaWidth() const
+{
+   auto digits = 1;
+   auto max = std::max(1, mBlame ? mBlame->lineCount() : 0);
+
+   while (max >= 10)
+   {
+      max /= 10;
+      ++digits;
+   }
+
+   return GUIDE_WIDTH + 2 * TEXT_MARGIN + characterWidth() * digits;
+}
+
+int FileBlameView::characterWidth() const
+{
+   int width;
+
+#if QT_VERSION >= QT_VERSION_CHECK(5, 11, 0)
+   width = fontMetrics().horizontalAdvance(QLatin1Char('9'));
+#else
+   width = fontMetrics().boundingRect(QLatin1Char('9')).width();
+#endif
+
+   return qMax(1, width);
+}
+
+int FileBlameView::lineAt(const QPoint &pos) const
+{
+   if (!mBlame || mBlame->lineCount() == 0)
+      return -1;
+
+   const auto line = verticalScrollBar()->value() + pos.y() / fontMetrics().height();
+
+   return pos.y() >= 0 && line < mBlame->lineCount() ? line : -1;
+}
+
+QColor FileBlameView::ageColor(int commitIndex) const
+{
+   const auto &commit = mBlame->commit(commitIndex);
+
+   if (commit.sha == CommitInfo::ZERO_SHA)
+      return WIP_COLOR;
+
+   const auto newest = mBlame->newestTime();
+   const auto range = qMax<qint64>(1, newest - mBlame->oldestTime());
+   const auto lastColor = static_cast<int>(AGE_COLORS.size()) - 1;
+   const auto age = qBound<qint64>(0, newest - commit.authorTime, range);
+   const auto index = static_cast<int>(age * lastColor / range);
+
+   return AGE_COLORS.at(static_cast<size_t>(index));
+}
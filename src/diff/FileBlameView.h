@@ -0,0 +1,111 @@
+#pragma once
+
+/****************************************************************************************
+ ** GitQlient is an application to manage and operate one or several Git repositories. With
+ ** GitQlient you will be able to add commits, branches and manage all the options Git provides.
+ ** Copyright (C) 2020  Francesc Martinez
+ **
+ ** LinkedIn: www.linkedin.com/in/cescmm/
+ ** Web: www.francescmm.com
+ **
+ ** This program is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public
+ ** License as published by the Free Software Foundation; either
+ ** version 2 of the License, or (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this library; if not, write to the Free Software
+ ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ***************************************************************************************/
+
+#include <QAbstractScrollArea>
+#include <QFont>
+
+class FileBlame;
+
+/*!
+ \brief The FileBlameView shows the blame of a file. On the left side, every group of consecutive lines that were last
+ modified by the same commit shows the date, the author and the title of that commit. A color guide next to the line
+ numbers tells the age of each line and the local changes are marked in orange. On the right side it is shown the code
+ of the file.
+
+ The view paints only the visible lines directly from a FileBlame, so its cost doesn't depend on the size of the file,
+ and it can be updated while the blame is still being produced.
+
+ \class FileBlameView FileBlameView.h "FileBlameView.h"
+*/
+class FileBlameView : public QAbstractScrollArea
+{
+   Q_OBJECT
+
+signals:
+   /*!
+    \brief Signal triggered when the user clicks on the information of a commit.
+
+    \param sha The SHA of the commit.
+   */
+   void signalCommitSelected(const QString &sha);
+
+public:
+   /*!
+    \brief Default constructor.
+
+    \param parent The parent widget if needed.
+   */
+   explicit FileBlameView(QWidget *parent = nullptr);
+
+   /*!
+    \brief Sets the blame to show. The view doesn't take the ownership and the blame must outlive it or be replaced.
+
+    \param blame The blame to show. It can be null to clear the view.
+   */
+   void setBlame(const FileBlame *blame);
+   /*!
+    \brief Notifies that the blame changed. It must be called when git blames more lines.
+   */
+   void updateBlame();
+
+protected:
+   void paintEvent(QPaintEvent *event) override;
+   void resizeEvent(QResizeEvent *event) override;
+   void keyPressEvent(QKeyEvent *event) override;
+   void mousePressEvent(QMouseEvent *event) override;
+   void mouseMoveEvent(QMouseEvent *event) override;
+   bool viewportEvent(QEvent *event) override;
+
+private:
+   const FileBlame *mBlame = nullptr;
+   QFont mInfoFont;
+   int mSelectionAnchor = -1;
+   int mSelectionEnd = -1;
+
+   /*!
+    \brief Updates the range of the scroll bars after the data or the size change.
+   */
+   void updateScrollBars();
+   /*!
+    \brief Returns the width of the area with the information of the commits.
+   */
+   int annotationWidth() const;
+   /*!
+    \brief Returns the width of the line number area, including the color guide.
+   */
+   int lineNumberAreaWidth() const;
+   /*!
+    \brief Returns the width of a character of the monospace font.
+   */
+   int characterWidth() const;
+   /*!
+    \brief Returns the line at a point of the viewport or -1 if there is no line.
+   */
+   int lineAt(const QPoint &pos) const;
+   /*!
+    \brief Returns the color of the guide for the commit @p commitIndex of the blame.
+   */
+   QColor ageColor(int commitIndex) const;
+};
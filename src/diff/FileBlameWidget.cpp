@@ -1,58 +1,35 @@
-﻿#include "FileBlameWidget.h"
+#include "FileBlameWidget.h"
 
-#include <RevisionsCache.h>
-#include <FileDiffView.h>
-#include <GitHistory.h>
 #include <CommitInfo.h>
-#include <ClickableFrame.h>
+#include <FileBlameView.h>
+#include <GitBase.h>
+#include <GitCatFile.h>
+#include <GitFuture.h>
+#include <GitHistory.h>
+#include <RevisionsCache.h>
 
+#include <QDir>
+#include <QFile>
 #include <QGridLayout>
 #include <QLabel>
-#include <QScrollArea>
-#include <QtMath>
 #include <QMessageBox>
+#include <QVBoxLayout>
 
-#include <array>
+#include <QLogger.h>
 
-namespace
-{
-const int kTotalColors = 8;
-const std::array<QString, kTotalColors> kBorderColors { "25, 65, 99",    "36, 95, 146",  "44, 116, 177",
-                                                        "56, 136, 205",  "87, 155, 213", "118, 174, 221",
-                                                        "150, 192, 221", "197, 220, 240" };
-qint64 kSecondsNewest = 0;
-qint64 kSecondsOldest = QDateTime::currentDateTime().toSecsSinceEpoch();
-qint64 kIncrementSecs = 0;
-}
+using namespace QLogger;
 
 FileBlameWidget::FileBlameWidget(const QSharedPointer<RevisionsCache> &cache, const QSharedPointer<GitBase> &git,
                                  QWidget *parent)
    : QFrame(parent)
    , mCache(cache)
    , mGit(git)
-   , mAnotation(new QFrame())
    , mCurrentSha(new QLabel())
    , mPreviousSha(new QLabel())
+   , mView(new FileBlameView())
 {
    setAttribute(Qt::WA_DeleteOnClose);
 
-   mAnotation->setObjectName("AnnotationFrame");
-
-   auto initialLayout = new QGridLayout(mAnotation);
-   initialLayout->addItem(new QSpacerItem(1, 1, QSizePolicy::Expanding, QSizePolicy::Expanding), 0, 0);
-   initialLayout->addWidget(new QLabel("Select a file to blame"), 1, 1);
-   initialLayout->addItem(new QSpacerItem(1, 1, QSizePolicy::Expanding, QSizePolicy::Expanding), 2, 2);
-
-   mInfoFont.setPointSize(9);
-
-   mCodeFont = QFont(mInfoFont);
-   mCodeFont.setFamily("Ubuntu Mono");
-   mCodeFont.setPointSize(10);
-
-   mScrollArea = new QScrollArea();
-   mScrollArea->setWidget(mAnotation);
-   mScrollArea->setWidgetResizable(true);
-
    const auto lSha = new QLabel(tr("Current SHA:"));
    const auto lSha2 = new QLabel(tr("Previous SHA:"));
 
@@ -73,30 +50,50 @@ FileBlameWidget::FileBlameWidget(const QSharedPointer<RevisionsCache> &cache, co
    layout->setContentsMargins(10, 10, 10, 0);
    layout->setSpacing(10);
    layout->addLayout(shasLayout);
-   layout->addWidget(mScrollArea);
+   layout->addWidget(mView);
+
+   connect(mView, &FileBlameView::signalCommitSelected, this, &FileBlameWidget::signalCommitSelected);
+}
+
+FileBlameWidget::~FileBlameWidget()
+{
+   cancelBlame();
 }
 
 void FileBlameWidget::setup(const QString &fileName, const QString &currentSha, const QString &previousSha)
 {
-   mCurrentFile = fileName;
-   QScopedPointer<GitHistory> git(new GitHistory(mGit));
-   const auto ret = git->blame(mCurrentFile, currentSha);
+   cancelBlame();
 
-   if (ret.success && !ret.output.toString().startsWith("fatal:"))
-   {
-      delete mAnotation;
-      mAnotation = nullptr;
+   mCurrentFile = fileName;
+   mFilePath = QDir(mGit->getWorkingDir()).relativeFilePath(fileName);
 
-      mCurrentSha->setText(currentSha);
-      mPreviousSha->setText(previousSha);
+   // The blame of the WIP changes with every edit, so it's never cached.
+   const auto cached = currentSha != CommitInfo::ZERO_SHA && mCache->containsFileBlame(currentSha, mFilePath);
+   QByteArray contents;
 
-      const auto annotations = processBlame(ret.output.toString());
-      formatAnnotatedFile(annotations);
-   }
-   else
+   if (!cached && !readContents(currentSha, contents))
+   {
       QMessageBox::warning(
           this, tr("File not in Git"),
           tr("The file {%1} is not under Git control version. You cannot blame it.").arg(mCurrentFile));
+      return;
+   }
+
+   mCurrentSha->setText(currentSha);
+   mPreviousSha->setText(previousSha);
+
+   if (cached)
+      mBlame = mCache->getFileBlame(currentSha, mFilePath);
+   else
+   {
+      mBlame = FileBlame();
+      mBlame.setContents(contents);
+   }
+
+   mView->setBlame(&mBlame);
+
+   if (!cached)
+      startBlame(currentSha);
 }
 
 void FileBlameWidget::reload(const QString &currentSha, const QString &previousSha)
@@ -109,212 +106,68 @@ QString FileBlameWidget::getCurrentSha() const
    return mCurrentSha->text();
 }
 
-QVector<FileBlameWidget::Annotation> FileBlameWidget::processBlame(const QString &blame)
-{
-   const auto lines = blame.split("\n", QString::SkipEmptyParts);
-   QVector<Annotation> annotations;
-
-   for (const auto &line : lines)
-   {
-      auto start = 0;
-      auto indexOfTab = line.indexOf('\t');
-      const auto shortSha = line.mid(start, indexOfTab);
-      const auto revision = mCache->getCommitInfo(shortSha);
-
-      start = indexOfTab + 1;
-      indexOfTab = line.indexOf('\t', start);
-      const auto name = line.mid(start, indexOfTab - start).remove("(");
-
-      start = indexOfTab + 1;
-      indexOfTab = line.indexOf('\t', start);
-      const auto dtValue = line.mid(start, indexOfTab - start);
-      const auto dt = QDateTime::fromString(dtValue, Qt::ISODate);
-
-      start = indexOfTab + 1;
-
-      const auto lineNumAndContent = line.mid(start);
-      const auto divisorChar = lineNumAndContent.indexOf(")");
-      const auto lineText = lineNumAndContent.mid(0, divisorChar);
-      const auto content = lineNumAndContent.mid(divisorChar + 1, lineNumAndContent.count() - lineText.count() - 1);
-
-      annotations.append({ revision.sha(), name, dt, lineText.toInt(), content });
-
-      if (revision.sha() != CommitInfo::ZERO_SHA)
-      {
-         const auto dtSinceEpoch = dt.toSecsSinceEpoch();
-
-         if (kSecondsNewest < dtSinceEpoch)
-            kSecondsNewest = dtSinceEpoch;
-
-         if (kSecondsOldest > dtSinceEpoch)
-            kSecondsOldest = dtSinceEpoch;
-      }
-   }
-
-   kIncrementSecs = kSecondsNewest != kSecondsOldest ? (kSecondsNewest - kSecondsOldest) / (kTotalColors - 1) : 1;
-
-   return annotations;
-}
-
-void FileBlameWidget::formatAnnotatedFile(const QVector<Annotation> &annotations)
+bool FileBlameWidget::readContents(const QString &sha, QByteArray &contents) const
 {
-   auto labelRow = 0;
-   auto labelRowSpan = 1;
-   QLabel *dateLabel = nullptr;
-   QLabel *authorLabel = nullptr;
-   ClickableFrame *messageLabel = nullptr;
-
-   const auto annotationLayout = new QGridLayout();
-   annotationLayout->setContentsMargins(QMargins());
-   annotationLayout->setSpacing(0);
-
-   const auto totalAnnot = annotations.count();
-   for (auto row = 0; row < totalAnnot; ++row)
+   if (sha == CommitInfo::ZERO_SHA)
    {
-      const auto &lastAnnotation = row == 0 ? Annotation() : annotations.at(row - 1);
-
-      if (lastAnnotation.sha != annotations.at(row).sha)
-      {
-         if (dateLabel)
-            annotationLayout->addWidget(dateLabel, labelRow, 0);
-
-         if (authorLabel)
-            annotationLayout->addWidget(authorLabel, labelRow, 1);
-
-         if (messageLabel)
-            annotationLayout->addWidget(messageLabel, labelRow, 2);
-
-         dateLabel = createDateLabel(annotations.at(row), row == 0);
-         authorLabel = createAuthorLabel(annotations.at(row).author, row == 0);
-         messageLabel = createMessageLabel(annotations.at(row).sha, row == 0);
-
-         labelRow = row;
-         labelRowSpan = 1;
-      }
-      else
-         ++labelRowSpan;
-
-      annotationLayout->addWidget(createNumLabel(annotations.at(row), row), row, 3);
-      annotationLayout->addWidget(createCodeLabel(annotations.at(row).content), row, 4);
-   }
-
-   // Adding the last row
-   if (dateLabel)
-      annotationLayout->addWidget(dateLabel, labelRow, 0);
+      QFile file(QString("%1/%2").arg(mGit->getWorkingDir(), mFilePath));
 
-   if (authorLabel)
-      annotationLayout->addWidget(authorLabel, labelRow, 1);
+      if (!file.open(QIODevice::ReadOnly))
+         return false;
 
-   if (messageLabel)
-      annotationLayout->addWidget(messageLabel, labelRow, 2);
+      contents = file.readAll();
 
-   annotationLayout->addItem(new QSpacerItem(1, 1, QSizePolicy::Expanding, QSizePolicy::Expanding), totalAnnot, 4);
-
-   mAnotation = new QFrame();
-   mAnotation->setObjectName("AnnotationFrame");
-   mAnotation->setLayout(annotationLayout);
-
-   mScrollArea->setWidget(mAnotation);
-   mScrollArea->setWidgetResizable(true);
-}
-
-QLabel *FileBlameWidget::createDateLabel(const Annotation &annotation, bool isFirst)
-{
-   auto isWip = annotation.sha == CommitInfo::ZERO_SHA;
-   QString when;
-
-   if (!isWip)
-   {
-      const auto days = annotation.dateTime.daysTo(QDateTime::currentDateTime());
-      const auto secs = annotation.dateTime.secsTo(QDateTime::currentDateTime());
-      if (days > 365)
-         when.append("more than 1 year ago");
-      else if (days > 1)
-         when.append(QString::number(days)).append(" days ago");
-      else if (days == 1)
-         when.append("yesterday");
-      else if (secs > 3600)
-         when.append(QString::number(secs / 3600)).append(" hours ago");
-      else if (secs == 3600)
-         when.append("1 hour ago");
-      else if (secs > 60)
-         when.append(QString::number(secs / 60)).append(" minutes ago");
-      else if (secs == 60)
-         when.append("1 minute ago");
-      else
-         when.append(QString::number(secs)).append(" secs ago");
+      return true;
    }
 
-   const auto dateLabel = new QLabel(when);
-   dateLabel->setObjectName(isFirst ? QString("authorPrimusInterPares") : QString("authorFirstOfItsName"));
-   dateLabel->setToolTip(annotation.dateTime.toString("dd/MM/yyyy hh:mm"));
-   dateLabel->setFont(mInfoFont);
-   dateLabel->setAlignment(Qt::AlignTop | Qt::AlignLeft);
+   GitCatFile::ObjectInfo info;
+   contents = mGit->catFile()->contents(QString("%1:%2").arg(sha, mFilePath), &info);
 
-   return dateLabel;
+   return info.isValid();
 }
 
-QLabel *FileBlameWidget::createAuthorLabel(const QString &author, bool isFirst)
+void FileBlameWidget::startBlame(const QString &sha)
 {
-   const auto authorLabel = new QLabel(author);
-   authorLabel->setObjectName(isFirst ? QString("authorPrimusInterPares") : QString("authorFirstOfItsName"));
-   authorLabel->setFont(mInfoFont);
-   authorLabel->setAlignment(Qt::AlignTop | Qt::AlignLeft);
+   const auto path = mFilePath;
 
-   return authorLabel;
-}
+   mParser.reset(&mBlame);
 
-ClickableFrame *FileBlameWidget::createMessageLabel(const QString &sha, bool isFirst)
-{
-   const auto revision = mCache->getCommitInfo(sha);
-   auto commitMsg = QString("Local changes");
+   GitHistory git(mGit);
+   mBlameFuture = mGit->runAsync(git.getBlameCommand(path, sha), GitFuture::Priority::Interactive, false);
 
-   if (!revision.sha().isEmpty())
-   {
-      auto log = revision.shortLog();
+   connect(mBlameFuture.data(), &GitFuture::signalOutputReady, this, [this](const QByteArray &chunk) {
+      if (mParser.processChunk(chunk))
+         mView->updateBlame();
+   });
 
-      if (log.count() > 47)
-         log = log.left(47) + QString("...");
+   mBlameFuture->then(this, [this, sha, path](const GitExecResult &result) {
+      if (sha != mCurrentSha->text() || path != mFilePath)
+         return;
 
-      commitMsg = log;
-   }
+      mBlameFuture.reset();
 
-   const auto messageLabel = new ClickableFrame(commitMsg, Qt::AlignTop | Qt::AlignLeft);
-   messageLabel->setObjectName(isFirst ? QString("primusInterPares") : QString("firstOfItsName"));
-   messageLabel->setToolTip(QString("<p>%1</p><p>%2</p>").arg(sha, commitMsg));
-   messageLabel->setFont(mInfoFont);
+      if (!result.success)
+      {
+         QLog_Warning("UI", QString("The blame of the file {%1} in {%2} couldn't be loaded.").arg(path, sha));
+         return;
+      }
 
-   connect(messageLabel, &ClickableFrame::clicked, this, [this, sha]() { emit signalCommitSelected(sha); });
+      mParser.finish();
+      mView->updateBlame();
 
-   return messageLabel;
+      if (sha != CommitInfo::ZERO_SHA)
+         mCache->insertFileBlame(sha, path, mBlame);
+   });
 }
 
-QLabel *FileBlameWidget::createNumLabel(const Annotation &annotation, int row)
+void FileBlameWidget::cancelBlame()
 {
-   const auto numberLabel = new QLabel(QString::number(row + 1));
-   numberLabel->setFont(mCodeFont);
-   numberLabel->setSizePolicy(QSizePolicy::Preferred, QSizePolicy::MinimumExpanding);
-   numberLabel->setObjectName("numberLabel");
-   numberLabel->setAlignment(Qt::AlignVCenter | Qt::AlignRight);
-
-   if (annotation.sha != CommitInfo::ZERO_SHA)
+   if (mBlameFuture)
    {
-      const auto dtSinceEpoch = annotation.dateTime.toSecsSinceEpoch();
-      const auto colorIndex = qCeil((kSecondsNewest - dtSinceEpoch) / kIncrementSecs);
-      numberLabel->setStyleSheet(
-          QString("QLabel { border-left: 5px solid rgb(%1) }").arg(kBorderColors.at(colorIndex)));
+      mBlameFuture->disconnect(this);
+      mBlameFuture->cancel();
+      mBlameFuture.reset();
    }
-   else
-      numberLabel->setStyleSheet("QLabel { border-left: 5px solid #D89000 }");
-
-   return numberLabel;
-}
-
-QLabel *FileBlameWidget::createCodeLabel(const QString &content)
-{
-   const auto contentLabel = new QLabel(content);
-   contentLabel->setFont(mCodeFont);
-   contentLabel->setObjectName("normalLabel");
 
-   return contentLabel;
+   mParser.reset(nullptr);
 }
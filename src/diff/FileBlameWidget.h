@@ -23,20 +23,21 @@
  ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
  ***************************************************************************************/
 
+#include <FileBlame.h>
+#include <GitBlameParser.h>
+
 #include <QFrame>
-#include <QDateTime>
 
 class GitBase;
-class QScrollArea;
-class ClickableFrame;
+class GitFuture;
+class FileBlameView;
 class QLabel;
 class RevisionsCache;
 
 /*!
- \brief The FileBalmeWidget class is the widget that creates the view for the blame of a file. It is formed by two
- parts: in the right side it is shown the code of the file. In the right and for every different line, it is shown the
- information of the commit with a color guide. The bright color indicates the more recent changes whereas the darkest
- color indicates the oldest.
+ \brief The FileBalmeWidget class is the widget that shows the blame of a file. The blame is produced by git blame
+ --incremental and the view is updated as the lines are blamed. The finished blames are stored in the cache, so going
+ back to a commit that was already blamed is instant.
 
 */
 class FileBlameWidget : public QFrame
@@ -61,6 +62,10 @@ public:
    */
    explicit FileBlameWidget(const QSharedPointer<RevisionsCache> &cache, const QSharedPointer<GitBase> &git,
                             QWidget *parent = nullptr);
+   /*!
+    \brief Destructor that cancels the blame if it's still running.
+   */
+   ~FileBlameWidget() override;
 
    /*!
     \brief Sets up the widget by providing the file to blame and the last commit SHA where the file was modified. The
@@ -95,79 +100,31 @@ public:
 private:
    QSharedPointer<RevisionsCache> mCache;
    QSharedPointer<GitBase> mGit;
-   QFrame *mAnotation = nullptr;
    QLabel *mCurrentSha = nullptr;
    QLabel *mPreviousSha = nullptr;
-   QScrollArea *mScrollArea = nullptr;
-   QFont mInfoFont;
-   QFont mCodeFont;
+   FileBlameView *mView = nullptr;
    QString mCurrentFile;
+   QString mFilePath;
+   FileBlame mBlame;
+   GitBlameParser mParser;
+   QSharedPointer<GitFuture> mBlameFuture;
 
    /*!
-    \brief Private class that stores data of a annotation. An annotation is the informatio regarding when a line was
-    last modified.
-
-   */
-   struct Annotation
-   {
-      QString sha;
-      QString author;
-      QDateTime dateTime;
-      int line = 0;
-      QString content;
-   };
-
-   /*!
-    \brief Processes a blame converting the git output into a vector of annotations per each line.
-
-    \param blame The git blame output.
-    \return QVector<Annotation> Vector of the annotations for every line.
-   */
-   QVector<Annotation> processBlame(const QString &blame);
-   /*!
-    \brief Process all the \p annotations and creates the view of the file with that information.
-
-    \param annotations The annotations to process.
-   */
-   void formatAnnotatedFile(const QVector<Annotation> &annotations);
-   /*!
-    \brief Factory method that creates a label with the date and time based on an annotation.
-
-    \param annotation The annotation to process.
-    \param isFirst Indicates if it's the first item in the blame.
-    \return QLabel Returns a newly created QLabel.
-   */
-   QLabel *createDateLabel(const Annotation &annotation, bool isFirst);
-   /*!
-    \brief Factory method that creates a label with the author information based on an annotation.
+    \brief Reads the contents of the file in the commit \p sha, or in the working directory for the WIP.
 
-    \param author The author to be shown.
-    \param isFirst Indicates if it's the first item in the blame.
-    \return QLabel Returns a newly created QLabel.
+    \param sha The commit SHA.
+    \param contents The contents of the file.
+    \return bool True if the file could be read.
    */
-   QLabel *createAuthorLabel(const QString &author, bool isFirst);
+   bool readContents(const QString &sha, QByteArray &contents) const;
    /*!
-    \brief Factory method that creates a Clickable frame with the informatio of the commit (SHA and title).
+    \brief Runs git blame for the commit \p sha and updates the view as the lines are blamed.
 
-    \param sha The sha to show.
-    \param isFirst Indicates if it's the first item in the blame.
-    \return ClickableFrame Returns a newly created ClickableFrame.
+    \param sha The commit SHA.
    */
-   ClickableFrame *createMessageLabel(const QString &sha, bool isFirst);
+   void startBlame(const QString &sha);
    /*!
-    \brief Factory method that creates a label with the number of line. Uses the \p annotation parameter to display a
-    visual help about when the change was done.
-
-    \param annotation The annotation to process.
-    \param row The row to display.
-    \return QLabel Returns a newly created QLabel.
-   */
-   QLabel *createNumLabel(const Annotation &annotation, int row);
-   /*!
-    \brief Factory method that creates a label with the code line to be displayed.
-
-    \param content The code line to display.
-    \return QLabel Returns a newly created QLable.
+    \brief Cancels the running blame, if any.
    */
-   QLabel *createCodeLabel(const QString &content);
+   void cancelBlame();
 };
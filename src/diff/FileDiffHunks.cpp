@@ -0,0 +1,176 @@
+#include "FileDiffHunks.h"
+
+#include <DiffLineStore.h>
+
+namespace
+{
+// The context lines git adds around the changes by default.
+const auto DEFAULT_CONTEXT_LINES = 3;
+
+bool isFileHeader(const QByteArray &line)
+{
+   return line.startsWith("diff --git ") || line.startsWith("index ") || line.startsWith("--- ")
+       || line.startsWith("+++ ");
+}
+}
+
+void FileDiffHunks::parse(const QByteArray &diff)
+{
+   mPreamble.clear();
+   mHunks.clear();
+   mNewFileMissing = false;
+
+   auto position = 0;
+
+   while (position < diff.size())
+   {
+      auto end = diff.indexOf('\n', position);
+      end = end == -1 ? diff.size() : end + 1;
+
+      const auto line = diff.mid(position, end - position);
+
+      // A deleted file has no lines to show after the hunk.
+      if (mHunks.isEmpty() && (line.startsWith("deleted file mode ") || line.startsWith("+++ /dev/null")))
+         mNewFileMissing = true;
+
+      if (line.startsWith("@@"))
+      {
+         // "@@ -<old start>[,<old count>] +<new start>[,<new count>] @@"
+         const auto rangeStart = line.indexOf(" +") + 2;
+         const auto range = line.mid(rangeStart, line.indexOf(' ', rangeStart) - rangeStart);
+         const auto comma = range.indexOf(',');
+         const auto start = (comma == -1 ? range : range.left(comma)).toInt();
+         const auto count = comma == -1 ? 1 : range.mid(comma + 1).toInt();
+
+         // A hunk without lines in the new file starts after the line it refers to.
+         Hunk hunk;
+         hunk.newStart = count == 0 ? start + 1 : start;
+         hunk.newEnd = hunk.newStart + count;
+         hunk.text = line;
+
+         mHunks.append(hunk);
+      }
+      else if (!mHunks.isEmpty())
+         mHunks.last().text.append(line);
+      else if (!isFileHeader(line))
+         mPreamble.append(line);
+
+      position = end;
+   }
+
+   if (!mPreamble.isEmpty() && !mPreamble.endsWith('\n'))
+      mPreamble.append('\n');
+
+   for (auto &hunk : mHunks)
+   {
+      if (!hunk.text.endsWith('\n'))
+         hunk.text.append('\n');
+   }
+
+   mLastHunkAtEnd = !mHunks.isEmpty() && reachesEndOfFile(mHunks.constLast().text);
+   mExpanded.fill(false, regionsCount());
+}
+
+void FileDiffHunks::setExpanded(int region, bool expanded)
+{
+   if (region >= 0 && region < mExpanded.count())
+      mExpanded[region] = expanded;
+}
+
+void FileDiffHunks::setAllExpanded(bool expanded)
+{
+   mExpanded.fill(expanded);
+}
+
+QByteArray FileDiffHunks::render(const QList<QByteArray> *fileLines, QHash<int, int> &markers) const
+{
+   markers.clear();
+
+   auto data = mPreamble;
+   auto lineCount = mPreamble.count('\n');
+
+   // Without hunks (binary files, mode changes) there is nothing to expand.
+   if (mHunks.isEmpty())
+      return data;
+
+   const auto fileLinesCount = fileLines ? fileLines->count() : -1;
+
+   for (auto region = 0; region < regionsCount(); ++region)
+   {
+      const auto range = regionRange(region, fileLinesCount);
+      auto hiddenLines = range.second == -1 ? -1 : range.second - range.first;
+
+      // Nothing is hidden after the last hunk if it already shows the end of the file.
+      if (region == mHunks.count() && (mNewFileMissing || mLastHunkAtEnd))
+         hiddenLines = 0;
+
+      if (hiddenLines > 0 && fileLines && mExpanded.at(region))
+      {
+         for (auto line = range.first; line < range.second && line <= fileLinesCount; ++line)
+         {
+            data.append(' ').append(fileLines->at(line - 1)).append('\n');
+            ++lineCount;
+         }
+      }
+      else if (hiddenLines > 0 || hiddenLines == -1)
+      {
+         markers.insert(lineCount, region);
+         ++lineCount;
+
+         data.append(DiffLineStore::EXPANDER_PREFIX);
+
+         if (hiddenLines == -1)
+            data.append("Click to show the rest of the file\n");
+         else
+            data.append(QString("%1 unchanged lines hidden, click to show them\n").arg(hiddenLines).toUtf8());
+      }
+
+      if (region < mHunks.count())
+      {
+         const auto &text = mHunks.at(region).text;
+
+         data.append(text);
+         lineCount += text.count('\n');
+      }
+   }
+
+   return data;
+}
+
+QPair<int, int> FileDiffHunks::regionRange(int region, int fileLinesCount) const
+{
+   const auto start = region == 0 ? 1 : mHunks.at(region - 1).newEnd;
+
+   if (region < mHunks.count())
+      return qMakePair(start, mHunks.at(region).newStart);
+
+   return qMakePair(start, fileLinesCount == -1 ? -1 : fileLinesCount + 1);
+}
+
+bool FileDiffHunks::reachesEndOfFile(const QByteArray &hunk)
+{
+   const auto lines = hunk.split('\n');
+   auto contextLines = 0;
+
+   // The last element is the empty string after the final new line.
+   for (auto i = lines.count() - 2; i > 0; --i)
+   {
+      const auto &line = lines.at(i);
+
+      // "\ No newline at end of file" after a line of the new file.
+      if (line.startsWith('\\'))
+      {
+         if (i == lines.count() - 2 && !lines.at(i - 1).startsWith('-'))
+            return true;
+
+         continue;
+      }
+
+      if (!line.startsWith(' ') && !line.isEmpty())
+         break;
+
+      ++contextLines;
+   }
+
+   return contextLines < DEFAULT_CONTEXT_LINES;
+}
@@ -0,0 +1,91 @@
+#pragma once
+
+/****************************************************************************************
+ ** GitQlient is an application to manage and operate one or several Git repositories. With
+ ** GitQlient you will be able to add commits, branches and manage all the options Git provides.
+ ** Copyright (C) 2020  Francesc Martinez
+ **
+ ** LinkedIn: www.linkedin.com/in/cescmm/
+ ** Web: www.francescmm.com
+ **
+ ** This program is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public
+ ** License as published by the Free Software Foundation; either
+ ** version 2 of the License, or (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this library; if not, write to the Free Software
+ ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ***************************************************************************************/
+
+#include <QByteArray>
+#include <QHash>
+#include <QList>
+#include <QVector>
+
+/**
+ * @brief The FileDiffHunks class holds the hunks of the diff of a single file, fetched with the default context, and
+ * renders them with the unchanged regions between them collapsed. Every region can be expanded independently with the
+ * lines of the new version of the file, which are only needed once the user expands something.
+ *
+ * The regions are numbered from 0: the region N is the one before the hunk N and the last one is the region after the
+ * last hunk.
+ *
+ * @class FileDiffHunks FileDiffHunks.h "FileDiffHunks.h"
+ */
+class FileDiffHunks
+{
+public:
+   /**
+    * @brief Parses the output of git diff for a single file. The lines before the first hunk are kept as the preamble.
+    *
+    * @param diff The raw diff.
+    */
+   void parse(const QByteArray &diff);
+
+   bool isEmpty() const { return mHunks.isEmpty() && mPreamble.isEmpty(); }
+   int regionsCount() const { return mHunks.count() + 1; }
+
+   void setExpanded(int region, bool expanded);
+   void setAllExpanded(bool expanded);
+
+   /**
+    * @brief Renders the diff.
+    *
+    * @param fileLines The lines of the new version of the file, or null if they are not loaded. The regions are
+    * collapsed until the lines are loaded.
+    * @param markers Receives the line of every collapsed region with the region it represents.
+    * @return QByteArray The diff as it's shown.
+    */
+   QByteArray render(const QList<QByteArray> *fileLines, QHash<int, int> &markers) const;
+
+private:
+   struct Hunk
+   {
+      int newStart = 0;
+      int newEnd = 0;
+      QByteArray text;
+   };
+
+   QByteArray mPreamble;
+   QVector<Hunk> mHunks;
+   QVector<bool> mExpanded;
+   bool mNewFileMissing = false;
+   bool mLastHunkAtEnd = false;
+
+   /**
+    * @brief Returns the range of lines of the new file, 1-based and end excluded, hidden in a region. The end is -1 if
+    * the region reaches the end of the file and its length is unknown.
+    */
+   QPair<int, int> regionRange(int region, int fileLinesCount) const;
+   /**
+    * @brief Returns true if the last hunk reaches the end of the new file: it has less trailing context lines than git
+    * adds by default, or the new file has no new line at its end.
+    */
+   static bool reachesEndOfFile(const QByteArray &hunk);
+};
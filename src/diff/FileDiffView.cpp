@@ -2,108 +2,391 @@
 
 #include <GitQlientStyles.h>
 
+#include <QApplication>
+#include <QClipboard>
+#include <QKeyEvent>
+#include <QMenu>
 #include <QPainter>
-#include <QTextBlock>
+#include <QScrollBar>
+
+namespace
+{
+const auto TEXT_MARGIN = 4;
+}
 
 FileDiffView::FileDiffView(QWidget *parent)
-   : QPlainTextEdit(parent)
-   , mLineNumberArea(new LineNumberArea(this))
+   : QAbstractScrollArea(parent)
 {
    setAttribute(Qt::WA_DeleteOnClose);
-   setReadOnly(true);
+   setFocusPolicy(Qt::StrongFocus);
 
-   connect(this, &FileDiffView::blockCountChanged, this, &FileDiffView::updateLineNumberAreaWidth);
-   connect(this, &FileDiffView::updateRequest, this, &FileDiffView::updateLineNumberArea);
+   QFont font;
+   font.setFamily(QString::fromUtf8("Ubuntu Mono"));
+   font.setStyleHint(QFont::Monospace);
+   setFont(font);
 
-   updateLineNumberAreaWidth(0);
+   // Any scroll made by the user cancels the pending restore of the previous position.
+   connect(verticalScrollBar(), &QScrollBar::actionTriggered, this, [this]() {
+      mRestoreLine = -1;
+      mCurrentLine = -1;
+   });
+
+   updateScrollBars();
 }
 
-int FileDiffView::lineNumberAreaWidth()
+void FileDiffView::clear()
 {
-   auto digits = 1;
-   auto max = std::max(1, blockCount());
+   if (mRestoreLine == -1)
+      mRestoreLine = verticalScrollBar()->value();
 
-   while (max >= 10)
+   mLines.clear();
+   mCurrentLine = -1;
+   mSelectionAnchor = -1;
+   mSelectionEnd = -1;
+
+   updateScrollBars();
+   viewport()->update();
+}
+
+void FileDiffView::truncateData(int lineCount)
+{
+   if (mRestoreLine == -1)
+      mRestoreLine = verticalScrollBar()->value();
+
+   mLines.truncate(lineCount);
+
+   if (mCurrentLine >= lineCount)
+      mCurrentLine = -1;
+
+   if (mSelectionAnchor >= lineCount || mSelectionEnd >= lineCount)
    {
-      max /= 10;
-      ++digits;
+      mSelectionAnchor = -1;
+      mSelectionEnd = -1;
    }
 
-   int width;
+   updateScrollBars();
+   viewport()->update();
+}
 
-#if QT_VERSION >= QT_VERSION_CHECK(5, 11, 0)
-   width = fontMetrics().horizontalAdvance(QLatin1Char('9'));
-#else
-   width = fontMetrics().boundingRect(QLatin1Char('9')).width();
-#endif
+void FileDiffView::appendData(const QByteArray &chunk)
+{
+   const auto previousCount = mLines.lineCount();
+
+   mLines.append(chunk);
+
+   if (mLines.lineCount() != previousCount)
+   {
+      updateScrollBars();
 
-   return 8 + width * digits;
+      if (previousCount <= verticalScrollBar()->value() + verticalScrollBar()->pageStep())
+         viewport()->update();
+   }
 }
 
-void FileDiffView::updateLineNumberAreaWidth(int /* newBlockCount */)
+void FileDiffView::finishData()
 {
-   setViewportMargins(lineNumberAreaWidth(), 0, 0, 0);
+   mLines.finish();
+
+   updateScrollBars();
+
+   if (mRestoreLine != -1)
+   {
+      verticalScrollBar()->setValue(mRestoreLine);
+      mRestoreLine = -1;
+   }
+
+   viewport()->update();
 }
 
-void FileDiffView::updateLineNumberArea(const QRect &rect, int dy)
+void FileDiffView::setData(const QByteArray &data)
 {
-   if (dy != 0)
-      mLineNumberArea->scroll(0, dy);
-   else
-      mLineNumberArea->update(0, rect.y(), mLineNumberArea->width(), rect.height());
+   clear();
+   appendData(data);
+   finishData();
+}
+
+void FileDiffView::setShowLineNumbers(bool show)
+{
+   mShowLineNumbers = show;
+
+   updateScrollBars();
+   viewport()->update();
+}
+
+void FileDiffView::goToLine(int line)
+{
+   mRestoreLine = -1;
+   mCurrentLine = line;
+
+   verticalScrollBar()->setValue(line);
+}
+
+bool FileDiffView::goToNext(const QVector<int> &anchors)
+{
+   const auto line = DiffLineStore::nextAnchor(anchors, mCurrentLine != -1 ? mCurrentLine : firstVisibleLine());
+
+   if (line == -1)
+      return false;
 
-   if (rect.contains(viewport()->rect()))
-      updateLineNumberAreaWidth(0);
+   goToLine(line);
+
+   return true;
 }
 
-void FileDiffView::resizeEvent(QResizeEvent *e)
+bool FileDiffView::goToPrevious(const QVector<int> &anchors)
 {
-   QPlainTextEdit::resizeEvent(e);
+   const auto line = DiffLineStore::previousAnchor(anchors, mCurrentLine != -1 ? mCurrentLine : firstVisibleLine());
+
+   if (line == -1)
+      return false;
 
-   const auto cr = contentsRect();
+   goToLine(line);
+
+   return true;
+}
 
-   mLineNumberArea->setGeometry(QRect(cr.left(), cr.top(), lineNumberAreaWidth(), cr.height()));
+int FileDiffView::firstVisibleLine() const
+{
+   return verticalScrollBar()->value();
 }
 
-void FileDiffView::lineNumberAreaPaintEvent(QPaintEvent *event)
+void FileDiffView::paintEvent(QPaintEvent *)
 {
-   QPainter painter(mLineNumberArea);
-   painter.fillRect(event->rect(), QColor(GitQlientStyles::getBackgroundColor()));
+   QPainter painter(viewport());
+   painter.setFont(font());
+
+   const auto metrics = fontMetrics();
+   const auto lineHeight = metrics.height();
+   const auto charWidth = characterWidth();
+   const auto numbersWidth = mShowLineNumbers ? lineNumberAreaWidth() : 0;
+   const auto viewportRect = viewport()->rect();
+   const auto textRect = viewportRect.adjusted(numbersWidth, 0, 0, 0);
+   const auto first = firstVisibleLine();
+   const auto last = qMin(mLines.lineCount() - 1, first + viewportRect.height() / lineHeight + 1);
+   const auto selectionFirst = qMin(mSelectionAnchor, mSelectionEnd);
+   const auto selectionLast = qMax(mSelectionAnchor, mSelectionEnd);
+
+   // Only the columns that fit in the view are painted, so very long lines don't slow down the painting.
+   const auto scroll = horizontalScrollBar()->value();
+   const auto firstColumn = scroll / charWidth;
+   const auto visibleColumns = textRect.width() / charWidth + 2;
+   const auto textX = numbersWidth + TEXT_MARGIN - scroll % charWidth;
+
+   auto boldFont = font();
+   boldFont.setWeight(QFont::ExtraBold);
 
-   auto block = firstVisibleBlock();
-   auto blockNumber = block.blockNumber();
-   auto top = blockBoundingGeometry(block).translated(contentOffset()).top();
-   auto bottom = top + blockBoundingRect(block).height();
+   if (mShowLineNumbers)
+      painter.fillRect(0, 0, numbersWidth, viewportRect.height(), GitQlientStyles::getBackgroundColor());
 
-   while (block.isValid() && top <= event->rect().bottom())
+   for (auto i = first; i <= last; ++i)
    {
-      if (block.isVisible() && bottom >= event->rect().top())
+      const auto y = (i - first) * lineHeight;
+
+      if (i >= selectionFirst && i <= selectionLast)
+      {
+         painter.fillRect(QRect(numbersWidth, y, textRect.width(), lineHeight),
+                          GitQlientStyles::getGraphSelectionColor());
+      }
+
+      auto color = GitQlientStyles::getTextColor();
+      auto bold = false;
+
+      switch (mLines.lineType(i))
+      {
+         case DiffLineStore::LineType::Addition:
+            color = GitQlientStyles::getGreen();
+            break;
+         case DiffLineStore::LineType::Deletion:
+            color = GitQlientStyles::getRed();
+            break;
+         case DiffLineStore::LineType::Hunk:
+            color = GitQlientStyles::getOrange();
+            bold = true;
+            break;
+         case DiffLineStore::LineType::FileHeader:
+            color = GitQlientStyles::getBlue();
+            bold = true;
+            break;
+         case DiffLineStore::LineType::Header:
+            color = GitQlientStyles::getBlue();
+            break;
+         case DiffLineStore::LineType::Expander:
+            color = GitQlientStyles::getOrange();
+            break;
+         case DiffLineStore::LineType::Context:
+            break;
+      }
+
+      const auto text = DiffLineStore::expandTabs(mLines.line(i)).mid(firstColumn, visibleColumns);
+
+      painter.setClipRect(textRect);
+      painter.setFont(bold ? boldFont : font());
+      painter.setPen(color);
+      painter.drawText(textX, y + metrics.ascent(), text);
+      painter.setClipping(false);
+
+      if (mShowLineNumbers)
       {
-         const auto number = QString::number(blockNumber + 1);
+         painter.setFont(font());
          painter.setPen(GitQlientStyles::getTextColor());
-         painter.drawText(0, static_cast<int>(top), mLineNumberArea->width() - 3, fontMetrics().height(),
-                          Qt::AlignRight, number);
+         painter.drawText(0, y, numbersWidth - 3, lineHeight, Qt::AlignRight, QString::number(i + 1));
+      }
+   }
+}
+
+void FileDiffView::resizeEvent(QResizeEvent *event)
+{
+   QAbstractScrollArea::resizeEvent(event);
+
+   updateScrollBars();
+}
+
+void FileDiffView::keyPressEvent(QKeyEvent *event)
+{
+   const auto altPressed = event->modifiers() == Qt::AltModifier;
+
+   if (event->matches(QKeySequence::Copy))
+      copySelection();
+   else if (event->matches(QKeySequence::SelectAll) && !mLines.isEmpty())
+   {
+      mSelectionAnchor = 0;
+      mSelectionEnd = mLines.lineCount() - 1;
+      viewport()->update();
+   }
+   else if (altPressed && event->key() == Qt::Key_Down)
+      goToNext(mLines.hunkLines());
+   else if (altPressed && event->key() == Qt::Key_Up)
+      goToPrevious(mLines.hunkLines());
+   else if (altPressed && event->key() == Qt::Key_PageDown)
+      goToNext(mLines.fileLines());
+   else if (altPressed && event->key() == Qt::Key_PageUp)
+      goToPrevious(mLines.fileLines());
+   else if (event->matches(QKeySequence::MoveToStartOfDocument))
+      goToLine(0);
+   else if (event->matches(QKeySequence::MoveToEndOfDocument))
+      goToLine(verticalScrollBar()->maximum());
+   else
+   {
+      mRestoreLine = -1;
+      mCurrentLine = -1;
+
+      QAbstractScrollArea::keyPressEvent(event);
+   }
+}
+
+void FileDiffView::mousePressEvent(QMouseEvent *event)
+{
+   if (event->button() == Qt::LeftButton)
+   {
+      const auto line = lineAt(event->pos());
+
+      if ((event->modifiers() & Qt::ShiftModifier) && mSelectionAnchor != -1)
+         mSelectionEnd = line;
+      else
+      {
+         mSelectionAnchor = line;
+         mSelectionEnd = line;
       }
 
-      block = block.next();
-      top = bottom;
-      bottom = top + blockBoundingRect(block).height();
-      ++blockNumber;
+      viewport()->update();
+
+      if (line != -1)
+         emit signalLineClicked(line);
    }
+
+   QAbstractScrollArea::mousePressEvent(event);
 }
 
-FileDiffView::LineNumberArea::LineNumberArea(FileDiffView *editor)
-   : QWidget(editor)
+void FileDiffView::mouseMoveEvent(QMouseEvent *event)
 {
-   fileDiffWidget = editor;
+   if ((event->buttons() & Qt::LeftButton) && mSelectionAnchor != -1)
+   {
+      // Dragging out of the view scrolls to extend the selection.
+      if (event->pos().y() < 0)
+         verticalScrollBar()->triggerAction(QAbstractSlider::SliderSingleStepSub);
+      else if (event->pos().y() > viewport()->height())
+         verticalScrollBar()->triggerAction(QAbstractSlider::SliderSingleStepAdd);
+
+      mSelectionEnd = lineAt(event->pos());
+      viewport()->update();
+   }
+
+   QAbstractScrollArea::mouseMoveEvent(event);
 }
 
-QSize FileDiffView::LineNumberArea::sizeHint() const
+void FileDiffView::contextMenuEvent(QContextMenuEvent *event)
 {
-   return { fileDiffWidget->lineNumberAreaWidth(), 0 };
+   QMenu menu(this);
+   const auto copyAction = menu.addAction(tr("Copy"), this, [this]() { copySelection(); });
+   copyAction->setEnabled(mSelectionAnchor != -1);
+
+   menu.exec(event->globalPos());
 }
 
-void FileDiffView::LineNumberArea::paintEvent(QPaintEvent *event)
+void FileDiffView::updateScrollBars()
 {
-   fileDiffWidget->lineNumberAreaPaintEvent(event);
+   const auto lineHeight = fontMetrics().height();
+   const auto visibleLines = qMax(1, viewport()->height() / lineHeight);
+
+   verticalScrollBar()->setPageStep(visibleLines);
+   verticalScrollBar()->setRange(0, qMax(0, mLines.lineCount() - visibleLines));
+
+   if (mRestoreLine != -1 && mRestoreLine <= verticalScrollBar()->maximum())
+   {
+      verticalScrollBar()->setValue(mRestoreLine);
+      mRestoreLine = -1;
+   }
+
+   const auto textWidth = mLines.maxLineLength() * characterWidth() + 2 * TEXT_MARGIN;
+   const auto availableWidth = viewport()->width() - (mShowLineNumbers ? lineNumberAreaWidth() : 0);
+
+   horizontalScrollBar()->setSingleStep(characterWidth());
+   horizontalScrollBar()->setPageStep(availableWidth);
+   horizontalScrollBar()->setRange(0, qMax(0, textWidth - availableWidth));
+}
+
+int FileDiffView::lineNumberAreaWidth() const
+{
+   auto digits = 1;
+   auto max = std::max(1, mLines.lineCount());
+
+   while (max >= 10)
+   {
+      max /= 10;
+      ++digits;
+   }
+
+   return 8 + characterWidth() * digits;
+}
+
+int FileDiffView::characterWidth() const
+{
+   int width;
+
+#if QT_VERSION >= QT_VERSION_CHECK(5, 11, 0)
+   width = fontMetrics().horizontalAdvance(QLatin1Char('9'));
+#else
+   width = fontMetrics().boundingRect(QLatin1Char('9')).width();
+#endif
+
+   return qMax(1, width);
+}
+
+int FileDiffView::lineAt(const QPoint &pos) const
+{
+   if (mLines.isEmpty())
+      return -1;
+
+   return qBound(0, firstVisibleLine() + pos.y() / fontMetrics().height(), mLines.lineCount() - 1);
+}
+
+void FileDiffView::copySelection() const
+{
+   if (mSelectionAnchor != -1)
+   {
+      const auto first = qMin(mSelectionAnchor, mSelectionEnd);
+      const auto last = qMax(mSelectionAnchor, mSelectionEnd);
+
+      QApplication::clipboard()->setText(mLines.text(first, last));
+   }
 }
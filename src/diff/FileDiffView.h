@@ -23,76 +23,139 @@
  ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
  ***************************************************************************************/
 
-#include <QPlainTextEdit>
+#include <DiffLineStore.h>
+
+#include <QAbstractScrollArea>
 
 /*!
- \brief The FileDiffView is an overload QPlainTextEdit class used to show the contents of a file diff between two
- commits.
+ \brief The FileDiffView shows the contents of a diff. The diff is kept in a DiffLineStore and the view only reads,
+ lays out and paints the lines that are visible, so its cost doesn't depend on the size of the diff. The data can be
+ appended while git produces it.
+
+ Besides the usual scroll keys, Alt+Down and Alt+Up go to the next and the previous hunk and Alt+PageDown and
+ Alt+PageUp go to the next and the previous file. The lines can be selected with the mouse and copied.
 
+ \class FileDiffView FileDiffView.h "FileDiffView.h"
 */
-class FileDiffView : public QPlainTextEdit
+class FileDiffView : public QAbstractScrollArea
 {
    Q_OBJECT
 
+signals:
+   /*!
+    \brief Signal triggered when the user clicks on a line.
+
+    \param line The line index.
+   */
+   void signalLineClicked(int line);
+
 public:
    /*!
     \brief Default constructor.
 
     \param parent The parent widget if needed.
    */
-   FileDiffView(QWidget *parent = nullptr);
+   explicit FileDiffView(QWidget *parent = nullptr);
 
-protected:
    /*!
-    \brief Overloaded method to process the resize event. Used to set an updated geometry to the line number area.
-
-    \param event The resize event.
+    \brief Removes the current diff. The scroll position is restored when the new data reaches it.
    */
-   void resizeEvent(QResizeEvent *event) override;
+   void clear();
+   /*!
+    \brief Removes the lines of the diff from \p lineCount to the end. The scroll position is restored when the new
+    data reaches it.
 
-private:
+    \param lineCount The number of lines to keep.
+   */
+   void truncateData(int lineCount);
    /*!
-    \brief Updates the line number area width based on the number of the line.
+    \brief Appends a chunk of the diff.
 
-    \param newBlockCount The number of the line.
+    \param chunk The raw data read from git.
+   */
+   void appendData(const QByteArray &chunk);
+   /*!
+    \brief Notifies that all the data was appended.
    */
-   void updateLineNumberAreaWidth(int newBlockCount);
+   void finishData();
    /*!
-    \brief Updates the line number area whenever the QPlainTextEdit emits the updateRequest signal.
+    \brief Replaces the diff keeping the scroll position.
 
-    \param rect The rect area that was updated.
-    \param dy The increment.
+    \param data The full diff.
    */
-   void updateLineNumberArea(const QRect &rect, int dy);
+   void setData(const QByteArray &data);
+   /*!
+    \brief Returns the lines of the diff.
 
+    \return const DiffLineStore & The line store.
+   */
+   const DiffLineStore &lines() const { return mLines; }
    /*!
-    \brief Method called by the line number area to paint the content of the QPlainTextEdit.
+    \brief Sets if the line numbers are painted.
+   */
+   void setShowLineNumbers(bool show);
 
-    \param event The paint event.
-    */
-   void lineNumberAreaPaintEvent(QPaintEvent *event);
+   /*!
+    \brief Scrolls to show the line at the top of the view.
 
+    \param line The line index.
+   */
+   void goToLine(int line);
    /*!
-    \brief Returns the width of the line number area.
+    \brief Moves to the next line of @p anchors after the first visible one.
 
-    \return int The width in pixels.
-    */
-   int lineNumberAreaWidth();
+    \param anchors The sorted lines where the view can jump to.
+    \return bool True if there was a line to move to.
+   */
+   bool goToNext(const QVector<int> &anchors);
+   /*!
+    \brief Moves to the previous line of @p anchors before the first visible one.
 
-private:
-   class LineNumberArea : public QWidget
-   {
-   public:
-      LineNumberArea(FileDiffView *editor);
+    \param anchors The sorted lines where the view can jump to.
+    \return bool True if there was a line to move to.
+   */
+   bool goToPrevious(const QVector<int> &anchors);
+   /*!
+    \brief Returns the first visible line.
+   */
+   int firstVisibleLine() const;
 
-      QSize sizeHint() const override;
+protected:
+   void paintEvent(QPaintEvent *event) override;
+   void resizeEvent(QResizeEvent *event) override;
+   void keyPressEvent(QKeyEvent *event) override;
+   void mousePressEvent(QMouseEvent *event) override;
+   void mouseMoveEvent(QMouseEvent *event) override;
+   void contextMenuEvent(QContextMenuEvent *event) override;
 
-   protected:
-      void paintEvent(QPaintEvent *event) override;
+private:
+   DiffLineStore mLines;
+   bool mShowLineNumbers = true;
+   int mRestoreLine = -1;
+   int mCurrentLine = -1;
+   int mSelectionAnchor = -1;
+   int mSelectionEnd = -1;
 
-   private:
-      FileDiffView *fileDiffWidget;
-   };
+   /*!
+    \brief Updates the range of the scroll bars after the data or the size change.
+   */
+   void updateScrollBars();
+   /*!
+    \brief Returns the width of the line number area.
 
-   LineNumberArea *mLineNumberArea;
+    \return int The width in pixels.
+    */
+   int lineNumberAreaWidth() const;
+   /*!
+    \brief Returns the width of a character of the monospace font.
+    */
+   int characterWidth() const;
+   /*!
+    \brief Returns the line at a point of the viewport, clamped to the existing lines.
+    */
+   int lineAt(const QPoint &pos) const;
+   /*!
+    \brief Copies the selected lines to the clipboard.
+   */
+   void copySelection() const;
 };
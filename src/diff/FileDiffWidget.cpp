@@ -2,16 +2,19 @@
 
 #include <GitHistory.h>
 #include <FileDiffView.h>
-#include <FileDiffHighlighter.h>
 #include <CommitInfo.h>
 #include <RevisionsCache.h>
 #include <DiffInfoPanel.h>
+#include <GitBase.h>
+#include <GitCatFile.h>
+
+#include <QLogger.h>
 
 #include <QHBoxLayout>
 #include <QPushButton>
-#include <QLabel>
-#include <QScrollBar>
-#include <QDateTime>
+#include <QFile>
+
+using namespace QLogger;
 
 FileDiffWidget::FileDiffWidget(const QSharedPointer<GitBase> &git, QSharedPointer<RevisionsCache> cache,
                                QWidget *parent)
@@ -21,21 +24,39 @@ FileDiffWidget::FileDiffWidget(const QSharedPointer<GitBase> &git, QSharedPointe
    , mDiffView(new FileDiffView())
    , mGoPrevious(new QPushButton())
    , mGoNext(new QPushButton())
+   , mFullFile(new QPushButton(tr("Full file")))
    , mDiffInfoPanel(new DiffInfoPanel(cache))
 
 {
    setAttribute(Qt::WA_DeleteOnClose);
 
-   mDiffHighlighter = new FileDiffHighlighter(mDiffView->document());
-
    mGoPrevious->setIcon(QIcon(":/icons/go_up"));
+   mGoPrevious->setToolTip(tr("Previous change"));
    mGoNext->setIcon(QIcon(":/icons/go_down"));
+   mGoNext->setToolTip(tr("Next change"));
+   mFullFile->setCheckable(true);
+   mFullFile->setToolTip(tr("Shows the unchanged lines of the file"));
+
+   const auto navigationLayout = new QHBoxLayout();
+   navigationLayout->setContentsMargins(QMargins());
+   navigationLayout->setSpacing(5);
+   navigationLayout->addStretch();
+   navigationLayout->addWidget(mFullFile);
+   navigationLayout->addWidget(mGoPrevious);
+   navigationLayout->addWidget(mGoNext);
 
    const auto vLayout = new QVBoxLayout(this);
    vLayout->setContentsMargins(QMargins());
    vLayout->setSpacing(10);
    vLayout->addWidget(mDiffInfoPanel);
+   vLayout->addLayout(navigationLayout);
    vLayout->addWidget(mDiffView);
+
+   connect(mGoPrevious, &QPushButton::clicked, this,
+           [this]() { mDiffView->goToPrevious(mDiffView->lines().changeLines()); });
+   connect(mGoNext, &QPushButton::clicked, this, [this]() { mDiffView->goToNext(mDiffView->lines().changeLines()); });
+   connect(mFullFile, &QPushButton::toggled, this, &FileDiffWidget::showFullFile);
+   connect(mDiffView, &FileDiffView::signalLineClicked, this, &FileDiffWidget::onLineClicked);
 }
 
 void FileDiffWidget::clear()
@@ -65,27 +86,90 @@ bool FileDiffWidget::configure(const QString &currentSha, const QString &previou
       destFile = destFile.split("--> ").last().split("(").first().trimmed();
 
    QScopedPointer<GitHistory> git(new GitHistory(mGit));
-   auto text = git->getFileDiff(currentSha == CommitInfo::ZERO_SHA ? QString() : currentSha, previousSha, destFile);
-   auto lines = text.split("\n");
+   const auto text
+       = git->getFileDiff(currentSha == CommitInfo::ZERO_SHA ? QString() : currentSha, previousSha, destFile).toUtf8();
 
-   for (auto i = 0; !lines.isEmpty() && i < 5; ++i)
-      lines.takeFirst();
+   // The WIP diff is reloaded periodically, so the view is only reset if the diff changed.
+   if (text == mRawDiff && destFile == mFilePath)
+      return !mHunks.isEmpty();
 
-   if (!lines.isEmpty())
-   {
-      text = lines.join("\n");
+   mFilePath = destFile;
+   mRawDiff = text;
+   mFileLines.clear();
+   mFileLinesLoaded = false;
+   mHunks.parse(text);
+
+   if (mFullFile->isChecked())
+      showFullFile(true);
+   else
+      render();
 
-      const auto pos = mDiffView->verticalScrollBar()->value();
-      mDiffView->setPlainText(text);
+   return !mHunks.isEmpty();
+}
 
-      mRowIndex = 0;
+void FileDiffWidget::render()
+{
+   mDiffView->setData(mHunks.render(mFileLinesLoaded ? &mFileLines : nullptr, mCollapsedRegions));
+}
 
-      mDiffView->moveCursor(QTextCursor::Start);
+void FileDiffWidget::onLineClicked(int line)
+{
+   const auto region = mCollapsedRegions.value(line, -1);
 
-      mDiffView->verticalScrollBar()->setValue(pos);
+   if (region != -1 && loadFileLines())
+   {
+      mHunks.setExpanded(region, true);
+      render();
+   }
+}
 
+void FileDiffWidget::showFullFile(bool expand)
+{
+   if (!expand || loadFileLines())
+   {
+      mHunks.setAllExpanded(expand);
+      render();
+   }
+}
+
+bool FileDiffWidget::loadFileLines()
+{
+   if (mFileLinesLoaded)
       return true;
+
+   QByteArray contents;
+
+   if (mCurrentSha == CommitInfo::ZERO_SHA)
+   {
+      QFile file(QString("%1/%2").arg(mGit->getWorkingDir(), mFilePath));
+
+      if (!file.open(QIODevice::ReadOnly))
+      {
+         QLog_Warning("UI", QString("Unable to read the file {%1}.").arg(file.fileName()));
+         return false;
+      }
+
+      contents = file.readAll();
+   }
+   else
+   {
+      GitCatFile::ObjectInfo info;
+      contents = mGit->catFile()->contents(QString("%1:%2").arg(mCurrentSha, mFilePath), &info);
+
+      if (!info.isValid())
+      {
+         QLog_Warning("UI", QString("Unable to read the file {%1} in the commit {%2}.").arg(mFilePath, mCurrentSha));
+         return false;
+      }
    }
 
-   return false;
+   mFileLines = contents.split('\n');
+
+   // A new line at the end of the file doesn't start another line.
+   if (contents.endsWith('\n'))
+      mFileLines.removeLast();
+
+   mFileLinesLoaded = true;
+
+   return true;
 }
@@ -23,9 +23,10 @@
  ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
  ***************************************************************************************/
 
+#include <FileDiffHunks.h>
+
 #include <QFrame>
 
-class FileDiffHighlighter;
 class FileDiffView;
 class QPushButton;
 class GitBase;
@@ -34,7 +35,10 @@ class RevisionsCache;
 
 /*!
  \brief The FileDiffWidget creates the layout that contains all the widgets related with the creation of the diff of a
- specific file.
+ specific file. The buttons move between the blocks of changes.
+
+ The diff is loaded with the default context and the unchanged regions between the hunks are collapsed. Clicking on a
+ collapsed region shows it, reading the file only then, and the full file button expands all of them.
 
  \class FileDiffWidget FileDiffWidget.h "FileDiffWidget.h"
 */
@@ -90,12 +94,39 @@ private:
    QString mPreviousSha;
    QSharedPointer<GitBase> mGit;
    QSharedPointer<RevisionsCache> mCache;
-   FileDiffHighlighter *mDiffHighlighter = nullptr;
    FileDiffView *mDiffView = nullptr;
    QPushButton *mGoPrevious = nullptr;
    QPushButton *mGoNext = nullptr;
+   QPushButton *mFullFile = nullptr;
    DiffInfoPanel *mDiffInfoPanel = nullptr;
-   QVector<int> mModifications;
-   int mRowIndex = 0;
-   int mDestRow = 0;
+   QString mFilePath;
+   QByteArray mRawDiff;
+   FileDiffHunks mHunks;
+   QList<QByteArray> mFileLines;
+   bool mFileLinesLoaded = false;
+   QHash<int, int> mCollapsedRegions;
+
+   /*!
+    \brief Renders the hunks with the current state of the regions.
+   */
+   void render();
+   /*!
+    \brief Expands the collapsed region if the user clicked on it.
+
+    \param line The clicked line.
+   */
+   void onLineClicked(int line);
+   /*!
+    \brief Expands or collapses all the regions.
+
+    \param expand True to show the full file.
+   */
+   void showFullFile(bool expand);
+   /*!
+    \brief Reads the lines of the new version of the file: from the working directory for the WIP, otherwise from
+    the repository.
+
+    \return bool True if the lines are available.
+   */
+   bool loadFileLines();
 };
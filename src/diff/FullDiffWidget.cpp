@@ -1,113 +1,99 @@
 #include "FullDiffWidget.h"
 
 #include <CommitInfo.h>
+#include <GitBase.h>
 #include <GitHistory.h>
 #include <DiffInfoPanel.h>
+#include <FileDiffView.h>
 #include <RevisionsCache.h>
-#include <GitQlientStyles.h>
 
+#include <QComboBox>
+#include <QHBoxLayout>
+#include <QPushButton>
 #include <QScrollBar>
-#include <QTextCharFormat>
-#include <QTextCodec>
+#include <QTimer>
 #include <QVBoxLayout>
 
-FullDiffWidget::DiffHighlighter::DiffHighlighter(QTextEdit *p)
-   : QSyntaxHighlighter(p)
-{
-}
+#include <QLogger.h>
+
+#include <algorithm>
+
+using namespace QLogger;
 
-void FullDiffWidget::DiffHighlighter::highlightBlock(const QString &text)
+namespace
 {
-   // state is used to count paragraphs, starting from 0
-   setCurrentBlockState(previousBlockState() + 1);
-   if (text.isEmpty())
-      return;
+// Files with more changed lines than this are collapsed until the user expands them.
+const auto MAX_EXPANDED_LINES = 2000;
 
-   QTextCharFormat myFormat;
-   const char firstChar = text.at(0).toLatin1();
-   switch (firstChar)
-   {
-      case '@':
-         myFormat.setForeground(GitQlientStyles::getOrange());
-         myFormat.setFontWeight(QFont::ExtraBold);
-         break;
-      case '+':
-         myFormat.setForeground(GitQlientStyles::getGreen());
-         break;
-      case '-':
-         myFormat.setForeground(GitQlientStyles::getRed());
-         break;
-      case 'c':
-      case 'd':
-      case 'i':
-      case 'n':
-      case 'o':
-      case 'r':
-      case 's':
-         if (text.startsWith("diff --git a/"))
-         {
-            myFormat.setForeground(GitQlientStyles::getBlue());
-            myFormat.setFontWeight(QFont::ExtraBold);
-         }
-         else if (text.startsWith("copy ") || text.startsWith("index ") || text.startsWith("new ")
-                  || text.startsWith("old ") || text.startsWith("rename ") || text.startsWith("similarity "))
-            myFormat.setForeground(GitQlientStyles::getBlue());
-         break;
-      default:
-         break;
-   }
-   if (myFormat.isValid())
-      setFormat(0, text.length(), myFormat);
+// Time to wait for more patches before regenerating the view.
+const auto REBUILD_DELAY_MS = 30;
 }
 
 FullDiffWidget::FullDiffWidget(const QSharedPointer<GitBase> &git, QSharedPointer<RevisionsCache> cache,
                                QWidget *parent)
-   : QTextEdit(parent)
+   : QFrame(parent)
    , mGit(git)
    , mCache(cache)
    , mDiffInfoPanel(new DiffInfoPanel(cache))
-   , mDiffWidget(new QTextEdit())
+   , mFiles(new QComboBox())
+   , mGoPrevious(new QPushButton())
+   , mGoNext(new QPushButton())
+   , mDiffView(new FileDiffView())
+   , mRebuildTimer(new QTimer(this))
 {
    setAttribute(Qt::WA_DeleteOnClose);
 
-   diffHighlighter = new DiffHighlighter(this);
+   mDiffView->setShowLineNumbers(false);
+
+   mRebuildTimer->setSingleShot(true);
+   mRebuildTimer->setInterval(REBUILD_DELAY_MS);
 
-   QFont font;
-   font.setFamily(QString::fromUtf8("Ubuntu Mono"));
-   mDiffWidget->setFont(font);
-   mDiffWidget->setObjectName("textEditDiff");
-   mDiffWidget->setUndoRedoEnabled(false);
-   mDiffWidget->setLineWrapMode(QTextEdit::NoWrap);
-   mDiffWidget->setReadOnly(true);
-   mDiffWidget->setTextInteractionFlags(Qt::TextSelectableByMouse);
+   mGoPrevious->setIcon(QIcon(":/icons/go_up"));
+   mGoPrevious->setToolTip(tr("Previous hunk (Alt+Up)"));
+   mGoNext->setIcon(QIcon(":/icons/go_down"));
+   mGoNext->setToolTip(tr("Next hunk (Alt+Down)"));
+   mFiles->setToolTip(tr("Go to file (Alt+PageUp / Alt+PageDown)"));
+
+   const auto navigationLayout = new QHBoxLayout();
+   navigationLayout->setContentsMargins(QMargins());
+   navigationLayout->setSpacing(5);
+   navigationLayout->addWidget(mFiles, 1);
+   navigationLayout->addWidget(mGoPrevious);
+   navigationLayout->addWidget(mGoNext);
 
    const auto layout = new QVBoxLayout(this);
    layout->setContentsMargins(QMargins());
    layout->setSpacing(10);
    layout->addWidget(mDiffInfoPanel);
-   layout->addWidget(mDiffWidget);
+   layout->addLayout(navigationLayout);
+   layout->addWidget(mDiffView);
+
+   connect(mRebuildTimer, &QTimer::timeout, this, &FullDiffWidget::rebuildView);
+   connect(mGoPrevious, &QPushButton::clicked, this,
+           [this]() { mDiffView->goToPrevious(mDiffView->lines().hunkLines()); });
+   connect(mGoNext, &QPushButton::clicked, this, [this]() { mDiffView->goToNext(mDiffView->lines().hunkLines()); });
+   connect(mFiles, static_cast<void (QComboBox::*)(int)>(&QComboBox::activated), this, [this](int index) {
+      if (index < mFileStarts.count())
+         mDiffView->goToLine(mFileStarts.at(index));
+   });
+   connect(mDiffView, &FileDiffView::signalLineClicked, this, &FullDiffWidget::onLineClicked);
+   connect(mDiffView->verticalScrollBar(), &QScrollBar::valueChanged, this, &FullDiffWidget::updateCurrentFile);
+   connect(mDiffView->verticalScrollBar(), &QScrollBar::valueChanged, this, &FullDiffWidget::loadVisibleFiles);
+   connect(mDiffView->verticalScrollBar(), &QScrollBar::rangeChanged, this, &FullDiffWidget::loadVisibleFiles);
 }
 
-void FullDiffWidget::reload()
+FullDiffWidget::~FullDiffWidget()
 {
-   if (mCurrentSha != CommitInfo::ZERO_SHA)
-      loadDiff(mCurrentSha, mPreviousSha);
+   cancelRequests();
 }
 
-void FullDiffWidget::processData(const QString &fileChunk)
+void FullDiffWidget::reload()
 {
-   if (mPreviousDiffText != fileChunk)
+   if (mCurrentSha != CommitInfo::ZERO_SHA)
    {
-      mPreviousDiffText = fileChunk;
-
-      const auto pos = mDiffWidget->verticalScrollBar()->value();
-
-      mDiffWidget->setUpdatesEnabled(false);
-      mDiffWidget->clear();
-      mDiffWidget->setPlainText(fileChunk);
-      mDiffWidget->moveCursor(QTextCursor::Start);
-      mDiffWidget->verticalScrollBar()->setValue(pos);
-      mDiffWidget->setUpdatesEnabled(true);
+      // The cache could have dropped any of the patches.
+      invalidateFrom(0);
+      rebuildView();
    }
 }
 
@@ -118,9 +104,306 @@ void FullDiffWidget::loadDiff(const QString &sha, const QString &diffToSha)
 
    mDiffInfoPanel->configure(mCurrentSha, mPreviousSha);
 
-   QScopedPointer<GitHistory> git(new GitHistory(mGit));
-   const auto ret = git->getCommitDiff(mCurrentSha, mPreviousSha);
+   cancelRequests();
+
+   mDiffFiles.clear();
+   mFileStarts.clear();
+   mFirstChangedFile = 0;
+   mFiles->clear();
+   mDiffView->clear();
+
+   if (mCurrentSha.isEmpty())
+      return;
+
+   // The patches of the WIP change with every edit.
+   if (mCurrentSha == CommitInfo::ZERO_SHA)
+      mCache->removeFilePatches(mCurrentSha);
+
+   GitHistory git(mGit);
+   const auto output = QSharedPointer<QByteArray>::create();
+
+   // The output is read in raw bytes: it's separated by NULs and the QString result stops at the first one.
+   mStatsFuture = mGit->runAsync(git.getCommitDiffStatsCommand(mCurrentSha, mPreviousSha),
+                                 GitFuture::Priority::Interactive, false);
+   connect(mStatsFuture.data(), &GitFuture::signalOutputReady, this,
+           [output](const QByteArray &chunk) { output->append(chunk); });
+   mStatsFuture->then(this, [this, sha, diffToSha, output](const GitExecResult &result) {
+      if (sha == mCurrentSha && diffToSha == mPreviousSha)
+         onStatsLoaded(result.success, *output);
+   });
+}
+
+void FullDiffWidget::onStatsLoaded(bool success, const QByteArray &output)
+{
+   mStatsFuture.reset();
+
+   if (!success)
+   {
+      QLog_Warning("UI",
+                   QString("The files of the diff {%1} to {%2} couldn't be loaded.").arg(mCurrentSha, mPreviousSha));
+      return;
+   }
+
+   // Every record is "<added>\t<deleted>\t<path>\0", or "<added>\t<deleted>\t\0<old path>\0<new path>\0" for the
+   // renames and copies. Binary files have "-" instead of the number of lines.
+   const auto fields = output.split('\0');
+
+   for (auto i = 0; i < fields.count(); ++i)
+   {
+      const auto &field = fields.at(i);
+      const auto firstTab = field.indexOf('\t');
+      const auto secondTab = firstTab == -1 ? -1 : field.indexOf('\t', firstTab + 1);
+
+      if (secondTab == -1)
+         continue;
+
+      const auto added = field.left(firstTab);
+
+      DiffFile file;
+      file.binary = added == "-";
+      file.additions = added.toInt();
+      file.deletions = field.mid(firstTab + 1, secondTab - firstTab - 1).toInt();
+      file.path = QString::fromUtf8(field.mid(secondTab + 1));
+
+      if (file.path.isEmpty() && i + 2 < fields.count())
+      {
+         file.oldPath = QString::fromUtf8(fields.at(++i));
+         file.path = QString::fromUtf8(fields.at(++i));
+      }
+
+      file.expanded = !file.binary && file.additions + file.deletions <= MAX_EXPANDED_LINES;
+
+      mDiffFiles.append(file);
+      mFiles->addItem(file.oldPath.isEmpty() ? file.path : QString("%1 \u2192 %2").arg(file.oldPath, file.path));
+   }
+
+   rebuildView();
+}
+
+void FullDiffWidget::loadVisibleFiles()
+{
+   if (mRebuilding || mFileStarts.isEmpty())
+      return;
+
+   const auto firstLine = mDiffView->firstVisibleLine();
+   const auto lastLine = firstLine + mDiffView->verticalScrollBar()->pageStep();
+   const auto first = qMax(0, fileAtLine(firstLine));
+   const auto last = qMax(0, fileAtLine(lastLine));
+
+   for (auto i = first; i <= last; ++i)
+   {
+      const auto &file = mDiffFiles.at(i);
+
+      if (file.expanded && !file.failed && !mPatchFutures.contains(i) && patch(i).isNull())
+         requestPatch(i);
+   }
+}
+
+void FullDiffWidget::requestPatch(int index)
+{
+   const auto &file = mDiffFiles.at(index);
+   auto files = QStringList(file.path);
+
+   if (!file.oldPath.isEmpty())
+      files.prepend(file.oldPath);
+
+   const auto sha = mCurrentSha;
+   const auto previousSha = mPreviousSha;
+   const auto path = file.path;
+
+   GitHistory git(mGit);
+   const auto output = QSharedPointer<QByteArray>::create();
+
+   // The patch is kept in raw bytes, so the files that aren't UTF-8 are shown as they are.
+   const auto future = mGit->runAsync(git.getCommitFileDiffCommand(sha, previousSha, files),
+                                      GitFuture::Priority::Interactive, false);
+   mPatchFutures.insert(index, future);
+
+   connect(future.data(), &GitFuture::signalOutputReady, this,
+           [output](const QByteArray &chunk) { output->append(chunk); });
+   future->then(this, [this, index, sha, previousSha, path, output](const GitExecResult &result) {
+      if (sha != mCurrentSha || previousSha != mPreviousSha || index >= mDiffFiles.count()
+          || mDiffFiles.at(index).path != path)
+      {
+         return;
+      }
+
+      mPatchFutures.remove(index);
+
+      auto &file = mDiffFiles[index];
+      auto data = *output;
+
+      // A null patch means it's not loaded, so an empty one is stored as an empty string.
+      if (data.isNull())
+         data = QByteArray("");
+
+      if (!result.success)
+         file.failed = true;
+      else if (!mCache->insertFilePatch(sha, previousSha, path, data))
+         file.patch = data;
+
+      invalidateFrom(index);
+      mRebuildTimer->start();
+   });
+}
+
+QByteArray FullDiffWidget::patch(int index) const
+{
+   const auto &file = mDiffFiles.at(index);
+
+   if (!file.patch.isNull())
+      return file.patch;
+
+   return mCache->getFilePatch(mCurrentSha, mPreviousSha, file.path);
+}
+
+void FullDiffWidget::invalidateFrom(int index)
+{
+   mFirstChangedFile = qMin(mFirstChangedFile, index);
+}
+
+void FullDiffWidget::rebuildView()
+{
+   mRebuildTimer->stop();
+
+   const auto firstFile = qMin(mFirstChangedFile, mFileStarts.count());
+
+   if (firstFile == mDiffFiles.count() && !mFileStarts.isEmpty())
+      return;
+
+   mRebuilding = true;
+
+   // The view keeps showing the same line of the same file, even if the files above it are loaded.
+   const auto firstLine = mDiffView->firstVisibleLine();
+   const auto anchorFile = fileAtLine(firstLine);
+   const auto anchorOffset = anchorFile != -1 ? firstLine - mFileStarts.at(anchorFile) : firstLine;
+
+   // Only the files from the first one that changed are regenerated, so loading the patches one by one while
+   // scrolling doesn't append the whole diff again every time.
+   if (firstFile == 0)
+   {
+      auto additions = 0;
+      auto deletions = 0;
+
+      for (const auto &file : qAsConst(mDiffFiles))
+      {
+         additions += file.additions;
+         deletions += file.deletions;
+      }
+
+      mDiffView->clear();
+      mDiffView->appendData(QString(" %1 files changed, %2 insertions(+), %3 deletions(-)\n\n")
+                                .arg(mDiffFiles.count())
+                                .arg(additions)
+                                .arg(deletions)
+                                .toUtf8());
+   }
+   else
+      mDiffView->truncateData(mFileStarts.at(firstFile));
+
+   mFileStarts.resize(firstFile);
+   mFileStarts.reserve(mDiffFiles.count());
+
+   for (auto i = firstFile; i < mDiffFiles.count(); ++i)
+   {
+      const auto &file = mDiffFiles.at(i);
+      const auto data = file.expanded ? patch(i) : QByteArray();
+
+      mFileStarts.append(mDiffView->lines().lineCount());
+
+      if (!data.isEmpty())
+      {
+         mDiffView->appendData(data);
+
+         if (!data.endsWith('\n'))
+            mDiffView->appendData("\n");
+
+         continue;
+      }
+
+      QString message;
+
+      if (file.failed)
+         message = tr("The diff of this file couldn't be loaded.");
+      else if (file.expanded && !data.isNull())
+         message = tr("There are no changes to show.");
+      else if (file.expanded)
+         message = tr("Loading...");
+      else if (file.binary)
+         message = tr("Binary file. Click on the file name to show the diff.");
+      else
+      {
+         message = tr("%1 lines changed. The diff is collapsed, click on the file name to show it.")
+                       .arg(file.additions + file.deletions);
+      }
+
+      const auto oldPath = file.oldPath.isEmpty() ? file.path : file.oldPath;
+      mDiffView->appendData(QString("diff --git a/%1 b/%2\n    %3\n\n").arg(oldPath, file.path, message).toUtf8());
+   }
+
+   mDiffView->finishData();
+
+   if (anchorFile != -1)
+      mDiffView->goToLine(mFileStarts.at(anchorFile) + anchorOffset);
+   else
+      mDiffView->goToLine(anchorOffset);
+
+   mFirstChangedFile = mDiffFiles.count();
+   mRebuilding = false;
+
+   updateCurrentFile();
+   loadVisibleFiles();
+}
+
+void FullDiffWidget::onLineClicked(int line)
+{
+   const auto file = fileAtLine(line);
+
+   if (file != -1 && mFileStarts.at(file) == line)
+   {
+      auto &diffFile = mDiffFiles[file];
+      diffFile.expanded = !diffFile.expanded;
+      diffFile.failed = false;
+
+      invalidateFrom(file);
+      rebuildView();
+   }
+}
+
+int FullDiffWidget::fileAtLine(int line) const
+{
+   const auto iter = std::upper_bound(mFileStarts.cbegin(), mFileStarts.cend(), line);
+
+   return static_cast<int>(iter - mFileStarts.cbegin()) - 1;
+}
+
+void FullDiffWidget::updateCurrentFile()
+{
+   if (mRebuilding)
+      return;
+
+   const auto index = fileAtLine(mDiffView->firstVisibleLine());
+
+   if (index >= 0 && index < mFiles->count())
+      mFiles->setCurrentIndex(index);
+}
+
+void FullDiffWidget::cancelRequests()
+{
+   mRebuildTimer->stop();
+
+   if (mStatsFuture)
+   {
+      mStatsFuture->disconnect(this);
+      mStatsFuture->cancel();
+      mStatsFuture.reset();
+   }
+
+   for (const auto &future : qAsConst(mPatchFutures))
+   {
+      future->disconnect(this);
+      future->cancel();
+   }
 
-   if (ret.success)
-      processData(ret.output.toString());
+   mPatchFutures.clear();
 }
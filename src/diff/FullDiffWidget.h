@@ -23,20 +23,30 @@
  ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
  ***************************************************************************************/
 
-#include <QSyntaxHighlighter>
-#include <QTextEdit>
+#include <QFrame>
+#include <QHash>
+#include <QSharedPointer>
+#include <QVector>
 
 class GitBase;
+class GitFuture;
 class DiffInfoPanel;
+class FileDiffView;
 class RevisionsCache;
+class QComboBox;
+class QPushButton;
+class QTimer;
 
 /*!
- \brief The FullDiffWidget class is an overload class inherited from QTextEdit that process the output from a diff for a
- full commit diff. It includes a highlighter for the lines that are added, removed and to differentiate where a file
- diff chuck starts.
+ \brief The FullDiffWidget class shows the diff of a full commit. It first loads the list of files with the number of
+ lines added and removed, and then only loads the patch of the files that are scrolled into view. The big and binary
+ files are collapsed until the user clicks on their name. The patches are kept in the RevisionsCache, so opening the
+ same commit again doesn't run git.
+
+ The files of the diff are listed in a combo box to jump to them and the buttons move between the hunks.
 
 */
-class FullDiffWidget : public QTextEdit
+class FullDiffWidget : public QFrame
 {
    Q_OBJECT
 
@@ -49,9 +59,14 @@ public:
    */
    explicit FullDiffWidget(const QSharedPointer<GitBase> &git, QSharedPointer<RevisionsCache> cache,
                            QWidget *parent = nullptr);
+   /*!
+    \brief Destructor. Cancels the git commands that are still running.
+   */
+   ~FullDiffWidget() override;
 
    /*!
-    \brief Reloads the current diff in case the user loaded the work in progress as base commit.
+    \brief Reloads the current diff. A commit diff never changes, so it only loads the visible patches that are not in
+    the cache anymore.
 
    */
    void reload();
@@ -64,27 +79,86 @@ public:
    void loadDiff(const QString &sha, const QString &diffToSha);
 
 private:
+   struct DiffFile
+   {
+      QString path;
+      QString oldPath;
+      int additions = 0;
+      int deletions = 0;
+      bool binary = false;
+      bool expanded = true;
+      bool failed = false;
+      // Only used for the patches that are too big for the cache.
+      QByteArray patch;
+   };
+
    QSharedPointer<GitBase> mGit;
    QSharedPointer<RevisionsCache> mCache;
    QString mCurrentSha;
    QString mPreviousSha;
-   QString mPreviousDiffText;
    DiffInfoPanel *mDiffInfoPanel = nullptr;
-   QTextEdit *mDiffWidget = nullptr;
+   QComboBox *mFiles = nullptr;
+   QPushButton *mGoPrevious = nullptr;
+   QPushButton *mGoNext = nullptr;
+   FileDiffView *mDiffView = nullptr;
+   QTimer *mRebuildTimer = nullptr;
+   QSharedPointer<GitFuture> mStatsFuture;
+   QHash<int, QSharedPointer<GitFuture>> mPatchFutures;
+   QVector<DiffFile> mDiffFiles;
+   QVector<int> mFileStarts;
+   int mFirstChangedFile = 0;
+   bool mRebuilding = false;
 
-   class DiffHighlighter : public QSyntaxHighlighter
-   {
-   public:
-      DiffHighlighter(QTextEdit *p);
-      void highlightBlock(const QString &text) override;
-   };
+   /*!
+    \brief Parses the list of files of the diff and shows them collapsed until their patches are loaded.
+
+    \param success If the numstat command succeeded.
+    \param output The raw output of the numstat command.
+   */
+   void onStatsLoaded(bool success, const QByteArray &output);
+   /*!
+    \brief Requests the patches of the expanded files that are visible and not cached.
+   */
+   void loadVisibleFiles();
+   /*!
+    \brief Requests the patch of a file.
 
-   DiffHighlighter *diffHighlighter = nullptr;
+    \param index The position of the file in the diff.
+   */
+   void requestPatch(int index);
+   /*!
+    \brief Returns the patch of a file if it's loaded, otherwise a null array.
 
+    \param index The position of the file in the diff.
+   */
+   QByteArray patch(int index) const;
+   /*!
+    \brief Marks a file as changed so the next rebuild regenerates the view from it.
+
+    \param index The position of the file in the diff.
+   */
+   void invalidateFrom(int index);
+   /*!
+    \brief Regenerates the content of the view from the first changed file, keeping the line at the top. The lines
+    of the files above it are kept.
+   */
+   void rebuildView();
    /*!
-    \brief Method that processes the data from the Git diff command.
+    \brief Collapses or expands a file if the user clicked on its header.
 
-    \param fileChunk The file chuck to compare.
+    \param line The clicked line.
+   */
+   void onLineClicked(int line);
+   /*!
+    \brief Returns the file that contains a line of the view, or -1 if the line is before the first file.
+   */
+   int fileAtLine(int line) const;
+   /*!
+    \brief Selects in the files combo box the file shown at the top of the view.
+   */
+   void updateCurrentFile();
+   /*!
+    \brief Cancels the git commands that are running.
    */
-   void processData(const QString &fileChunk);
+   void cancelRequests();
 };
@@ -1,7 +1,10 @@
 #include "AGitProcess.h"
 
+#include <GitCommandTrace.h>
+
 #include <QTemporaryFile>
 #include <QTextStream>
+#include <QThread>
 
 #include <QLogger.h>
 
@@ -93,6 +96,7 @@ QStringList splitArgList(const QString &cmd)
 
 AGitProcess::AGitProcess(const QString &workingDir)
    : mWorkingDirectory(workingDir)
+   , mSubsystem(GitCommandTrace::currentSubsystem())
 {
    setWorkingDirectory(mWorkingDirectory);
 
@@ -100,12 +104,18 @@ AGitProcess::AGitProcess(const QString &workingDir)
            Qt::DirectConnection);
    connect(this, static_cast<void (AGitProcess::*)(int, QProcess::ExitStatus)>(&AGitProcess::finished), this,
            &AGitProcess::onFinished, Qt::DirectConnection);
+   // Connected after onFinished so the last data read is counted.
+   connect(this, static_cast<void (AGitProcess::*)(int, QProcess::ExitStatus)>(&AGitProcess::finished), this,
+           &AGitProcess::recordTrace, Qt::DirectConnection);
 }
 
 void AGitProcess::onCancel()
 {
    mCanceling = true;
 
+   if (state() != QProcess::NotRunning)
+      kill();
+
    waitForFinished();
 }
 
@@ -114,8 +124,10 @@ void AGitProcess::onReadyStandardOutput()
    if (!mCanceling)
    {
       const auto standardOutput = readAllStandardOutput();
+      mBytesRead += standardOutput.size();
 
-      mRunOutput.append(QString::fromUtf8(standardOutput));
+      if (mBufferOutput)
+         mRunOutput.append(QString::fromUtf8(standardOutput));
 
       emit procDataReady(standardOutput);
    }
@@ -137,12 +149,17 @@ bool AGitProcess::execute(const QString &command)
       setEnvironment(env);
       setProgram(arguments.takeFirst());
       setArguments(arguments);
+      mStartTime = GitCommandTrace::now();
       start();
 
       processStarted = waitForStarted();
+      mSpawnTime = GitCommandTrace::now() - mStartTime;
 
       if (!processStarted)
+      {
          QLog_Warning("Git", QString("Unable to start the process:\n%1\nMore info:\n%2").arg(mCommand, errorString()));
+         recordTrace(-1, QProcess::CrashExit);
+      }
       else
          QLog_Debug("Git", QString("Process started: %1").arg(mCommand));
    }
@@ -155,13 +172,34 @@ void AGitProcess::onFinished(int, QProcess::ExitStatus exitStatus)
    QLog_Debug("Git", QString("Process {%1} finished.").arg(mCommand));
 
    const auto errorOutput = readAllStandardError();
+   const auto remainingOutput = readAllStandardOutput();
+   mBytesRead += errorOutput.size() + remainingOutput.size();
 
    mErrorOutput = QString::fromUtf8(errorOutput);
    mRealError = exitStatus != QProcess::NormalExit || mCanceling || errorOutput.contains("error")
        || errorOutput.toLower().contains("could not read username");
 
+   if (!remainingOutput.isEmpty() && !mCanceling)
+      emit procDataReady(remainingOutput);
+
    if (mRealError)
       mRunOutput = mErrorOutput;
-   else
-      mRunOutput.append(readAllStandardOutput() + mErrorOutput);
+   else if (mBufferOutput)
+      mRunOutput.append(QString::fromUtf8(remainingOutput) + mErrorOutput);
+}
+
+void AGitProcess::recordTrace(int exitCode, QProcess::ExitStatus exitStatus)
+{
+   GitCommandTrace::Record record;
+   record.startTime = mStartTime;
+   record.spawnTime = mSpawnTime;
+   record.wallTime = GitCommandTrace::now() - mStartTime;
+   record.bytesRead = mBytesRead;
+   record.exitCode = exitCode;
+   record.crashed = exitStatus != QProcess::NormalExit;
+   record.threadId = reinterpret_cast<quintptr>(QThread::currentThreadId());
+   record.subsystem = mSubsystem;
+   record.command = mCommand.toUtf8();
+
+   GitCommandTrace::record(record);
 }
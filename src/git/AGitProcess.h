@@ -39,6 +39,16 @@ public:
 
    virtual GitExecResult run(const QString &command) = 0;
    void onCancel();
+   /**
+    * @brief Sets the subsystem the process is attributed to in the command trace. By default it's the one of the
+    * scope that was active when the process was created.
+    */
+   void setSubsystem(const char *subsystem) { mSubsystem = subsystem; }
+   /**
+    * @brief Sets if the output is kept to be returned when the process finishes. Processes whose output is only
+    * consumed through @ref procDataReady don't need to keep a copy of it.
+    */
+   void setBufferOutput(bool bufferOutput) { mBufferOutput = bufferOutput; }
 
 protected:
    QString mRunOutput;
@@ -47,9 +57,16 @@ protected:
    QString mCommand;
    bool mRealError = false;
    bool mCanceling = false;
+   bool mBufferOutput = true;
+   qint64 mBytesRead = 0;
    bool execute(const QString &command);
    virtual void onFinished(int, QProcess::ExitStatus exitStatus);
+   virtual void onReadyStandardOutput();
 
 private:
-   void onReadyStandardOutput();
+   qint64 mStartTime = 0;
+   qint64 mSpawnTime = 0;
+   const char *mSubsystem = nullptr;
+
+   void recordTrace(int exitCode, QProcess::ExitStatus exitStatus);
 };
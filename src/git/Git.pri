@@ -4,18 +4,28 @@ HEADERS += \
     $$PWD/AGitProcess.h \
     $$PWD/GitAsyncProcess.h \
     $$PWD/GitBase.h \
+    $$PWD/GitBlameParser.h \
     $$PWD/GitBranches.h \
+    $$PWD/GitCatFile.h \
     $$PWD/GitCloneProcess.h \
+    $$PWD/GitCommandTrace.h \
     $$PWD/GitConfig.h \
+    $$PWD/GitDiffTreeParser.h \
+    $$PWD/GitDiffTreeService.h \
     $$PWD/GitExecResult.h \
+    $$PWD/GitFuture.h \
     $$PWD/GitHistory.h \
     $$PWD/GitLocal.h \
+    $$PWD/GitLogParser.h \
     $$PWD/GitMerge.h \
     $$PWD/GitPatches.h \
+    $$PWD/GitProcessPool.h \
     $$PWD/GitRemote.h \
     $$PWD/GitRepoLoader.h \
+    $$PWD/GitRepoWatcher.h \
     $$PWD/GitRequestorProcess.h \
     $$PWD/GitStashes.h \
+    $$PWD/GitStatusParser.h \
     $$PWD/GitSubmodules.h \
     $$PWD/GitSyncProcess.h \
     $$PWD/GitTags.h
@@ -24,18 +34,28 @@ SOURCES += \
     $$PWD/AGitProcess.cpp \
     $$PWD/GitAsyncProcess.cpp \
     $$PWD/GitBase.cpp \
+    $$PWD/GitBlameParser.cpp \
     $$PWD/GitBranches.cpp \
+    $$PWD/GitCatFile.cpp \
     $$PWD/GitCloneProcess.cpp \
+    $$PWD/GitCommandTrace.cpp \
     $$PWD/GitConfig.cpp \
+    $$PWD/GitDiffTreeParser.cpp \
+    $$PWD/GitDiffTreeService.cpp \
     $$PWD/GitExecResult.cpp \
+    $$PWD/GitFuture.cpp \
     $$PWD/GitHistory.cpp \
     $$PWD/GitLocal.cpp \
+    $$PWD/GitLogParser.cpp \
     $$PWD/GitMerge.cpp \
     $$PWD/GitPatches.cpp \
+    $$PWD/GitProcessPool.cpp \
     $$PWD/GitRemote.cpp \
     $$PWD/GitRepoLoader.cpp \
+    $$PWD/GitRepoWatcher.cpp \
     $$PWD/GitRequestorProcess.cpp \
     $$PWD/GitStashes.cpp \
+    $$PWD/GitStatusParser.cpp \
     $$PWD/GitSubmodules.cpp \
     $$PWD/GitSyncProcess.cpp \
     $$PWD/GitTags.cpp
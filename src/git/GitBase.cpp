@@ -1,7 +1,7 @@
 #include "GitBase.h"
 
 #include <GitSyncProcess.h>
-#include <GitAsyncProcess.h>
+#include <GitProcessPool.h>
 
 #include <QLogger.h>
 
@@ -23,6 +23,24 @@ QString GitBase::getWorkingDir() const
 void GitBase::setWorkingDir(const QString &workingDir)
 {
    mWorkingDirectory = workingDir;
+   mCatFile.reset();
+   mDiffTree.reset();
+}
+
+GitCatFile *GitBase::catFile() const
+{
+   if (!mCatFile)
+      mCatFile.reset(new GitCatFile(mWorkingDirectory));
+
+   return mCatFile.data();
+}
+
+GitDiffTreeService *GitBase::diffTree() const
+{
+   if (!mDiffTree)
+      mDiffTree.reset(new GitDiffTreeService(mWorkingDirectory));
+
+   return mDiffTree.data();
 }
 
 GitExecResult GitBase::run(const QString &cmd) const
@@ -47,13 +65,12 @@ GitExecResult GitBase::run(const QString &cmd) const
    return ret;
 }
 
-bool GitBase::runAsync(const QString &cmd) const
+QSharedPointer<GitFuture> GitBase::runAsync(const QString &cmd, GitFuture::Priority priority, bool bufferOutput) const
 {
-   const auto p = new GitAsyncProcess(mWorkingDirectory);
-   connect(this, &GitBase::cancelAllProcesses, p, &AGitProcess::onCancel);
-   connect(p, &GitAsyncProcess::signalDataReady, this, &GitBase::signalResultReady);
+   const auto future = GitProcessPool::instance()->run(mWorkingDirectory, cmd, priority, bufferOutput);
+   connect(this, &GitBase::cancelAllProcesses, future.data(), &GitFuture::cancel);
 
-   return p->run(cmd).success;
+   return future;
 }
 
 void GitBase::updateCurrentBranch()
@@ -63,6 +80,10 @@ void GitBase::updateCurrentBranch()
    const auto ret = run("git rev-parse --abbrev-ref HEAD");
 
    mCurrentBranch = ret.success ? ret.output.toString().trimmed() : QString();
+
+   const auto head = getLastCommit();
+
+   mLastCommitSha = head.success ? head.output.toString().trimmed() : QString();
 }
 
 QString GitBase::getCurrentBranch()
@@ -77,5 +98,12 @@ QString GitBase::getCurrentBranch()
 
 GitExecResult GitBase::getLastCommit() const
 {
-   return run("git rev-parse HEAD");
+   const auto head = catFile()->info("HEAD");
+
+   return head.isValid() ? GitExecResult(true, head.sha) : run("git rev-parse HEAD");
+}
+
+QString GitBase::getLastCommitSha() const
+{
+   return mLastCommitSha;
 }
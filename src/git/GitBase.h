@@ -23,7 +23,10 @@
  ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
  ***************************************************************************************/
 
+#include <GitCatFile.h>
+#include <GitDiffTreeService.h>
 #include <GitExecResult.h>
+#include <GitFuture.h>
 #include <RevisionsCache.h>
 
 #include <QObject>
@@ -35,14 +38,34 @@ class GitBase final : public QObject
 
 signals:
    void cancelAllProcesses(QPrivateSignal);
-   void signalResultReady(GitExecResult result);
 
 public:
    explicit GitBase(const QString &workingDirectory, QObject *parent = nullptr);
 
    GitExecResult run(const QString &cmd) const;
 
-   bool runAsync(const QString &cmd) const;
+   /**
+    * @brief Runs the command through the shared process pool without blocking.
+    *
+    * @param cmd The git command.
+    * @param priority The priority of the command in the pool.
+    * @param bufferOutput If false, the output is only delivered in chunks through GitFuture::signalOutputReady.
+    * @return QSharedPointer<GitFuture> The handle to get the result or cancel the command.
+    */
+   QSharedPointer<GitFuture> runAsync(const QString &cmd, GitFuture::Priority priority = GitFuture::Priority::Normal,
+                                      bool bufferOutput = true) const;
+
+   /**
+    * @brief Returns the cat-file helper of the repository. It's started with the first query and it's kept running,
+    * so it's the cheapest way to resolve references and read objects.
+    */
+   GitCatFile *catFile() const;
+
+   /**
+    * @brief Returns the diff-tree helper of the repository. It's started with the first query and it's kept running,
+    * so it's the cheapest way to list the files of the commits. It must be used from the GUI thread.
+    */
+   GitDiffTreeService *diffTree() const;
 
    QString getWorkingDir() const;
 
@@ -54,7 +77,16 @@ public:
 
    GitExecResult getLastCommit() const;
 
+   /**
+    * @brief Returns the SHA of HEAD as it was resolved the last time the current branch was updated. It doesn't ask
+    * git, so it can be used while painting.
+    */
+   QString getLastCommitSha() const;
+
 protected:
    QString mWorkingDirectory;
    QString mCurrentBranch;
+   QString mLastCommitSha;
+   mutable QSharedPointer<GitCatFile> mCatFile;
+   mutable QSharedPointer<GitDiffTreeService> mDiffTree;
 };
@@ -0,0 +1,117 @@
+#include "GitBlameParser.h"
+
+#include <cstring>
+
+namespace
+{
+/**
+ * @brief Tells if the line is the header @p key, and if so, returns the value that follows it in @p value.
+ */
+bool readHeader(const char *line, int size, const char *key, QByteArray &value)
+{
+   const auto keySize = static_cast<int>(strlen(key));
+
+   if (size < keySize || memcmp(line, key, static_cast<size_t>(keySize)) != 0)
+      return false;
+
+   if (size == keySize)
+      value.clear();
+   else if (line[keySize] == ' ')
+      value = QByteArray(line + keySize + 1, size - keySize - 1);
+   else
+      return false;
+
+   return true;
+}
+}
+
+void GitBlameParser::reset(FileBlame *blame)
+{
+   mBlame = blame;
+   mPendingData.clear();
+   mCommit = FileBlame::Commit();
+   mFirstLine = -1;
+   mLinesCount = 0;
+   mLinesBlamed = false;
+}
+
+bool GitBlameParser::processChunk(const QByteArray &chunk)
+{
+   mPendingData.append(chunk);
+   mLinesBlamed = false;
+
+   const auto lastSeparator = mPendingData.lastIndexOf('\n');
+
+   if (lastSeparator == -1)
+      return false;
+
+   const auto data = mPendingData.constData();
+   auto lineStart = 0;
+
+   while (lineStart <= lastSeparator)
+   {
+      const auto lineEnd = mPendingData.indexOf('\n', lineStart);
+
+      parseLine(data + lineStart, lineEnd - lineStart);
+
+      lineStart = lineEnd + 1;
+   }
+
+   mPendingData.remove(0, lastSeparator + 1);
+
+   return mLinesBlamed;
+}
+
+void GitBlameParser::finish()
+{
+   if (!mPendingData.isEmpty())
+   {
+      parseLine(mPendingData.constData(), mPendingData.size());
+      mPendingData.clear();
+   }
+}
+
+void GitBlameParser::parseLine(const char *line, int size)
+{
+   if (!mBlame || size == 0)
+      return;
+
+   // Every group starts with "<sha> <source line> <final line> <number of lines>".
+   if (mFirstLine == -1)
+   {
+      const auto fields = QByteArray::fromRawData(line, size).split(' ');
+
+      if (fields.count() != 4)
+         return;
+
+      mCommit = FileBlame::Commit();
+      mCommit.sha = QString::fromLatin1(fields.at(0));
+      mFirstLine = fields.at(2).toInt() - 1;
+      mLinesCount = fields.at(3).toInt();
+
+      return;
+   }
+
+   QByteArray value;
+
+   if (readHeader(line, size, "filename", value))
+   {
+      // The file name closes the group. The rest of the headers are only written the first time a commit appears.
+      auto commitIndex = mBlame->commitIndex(mCommit.sha);
+
+      if (commitIndex == -1)
+         commitIndex = mBlame->addCommit(mCommit);
+
+      mBlame->setLinesCommit(mFirstLine, mLinesCount, commitIndex);
+      mLinesBlamed = true;
+      mFirstLine = -1;
+   }
+   else if (readHeader(line, size, "author", value))
+      mCommit.author = QString::fromUtf8(value);
+   else if (readHeader(line, size, "author-time", value))
+      mCommit.authorTime = value.toLongLong();
+   else if (readHeader(line, size, "summary", value))
+      mCommit.summary = QString::fromUtf8(value);
+   else if (readHeader(line, size, "boundary", value))
+      mCommit.boundary = true;
+}
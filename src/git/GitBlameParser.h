@@ -0,0 +1,69 @@
+#pragma once
+
+/****************************************************************************************
+ ** GitQlient is an application to manage and operate one or several Git repositories. With
+ ** GitQlient you will be able to add commits, branches and manage all the options Git provides.
+ ** Copyright (C) 2020  Francesc Martinez
+ **
+ ** LinkedIn: www.linkedin.com/in/cescmm/
+ ** Web: www.francescmm.com
+ **
+ ** This program is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public
+ ** License as published by the Free Software Foundation; either
+ ** version 2 of the License, or (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this library; if not, write to the Free Software
+ ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ***************************************************************************************/
+
+#include <FileBlame.h>
+
+#include <QByteArray>
+#include <QString>
+
+/**
+ * @brief The GitBlameParser class reads the output of git blame --incremental and fills a @ref FileBlame with it. The
+ * incremental format reports the lines in groups as soon as git finds their commit, and the information of each commit
+ * is only written the first time it appears, so the blame can be shown while git is still running. The data can be fed
+ * in chunks as it is read from the git process.
+ *
+ * @class GitBlameParser GitBlameParser.h "GitBlameParser.h"
+ */
+class GitBlameParser
+{
+public:
+   /**
+    * @brief Discards any data from a previous run and starts filling @p blame.
+    *
+    * @param blame The blame to fill. It must outlive the parsing.
+    */
+   void reset(FileBlame *blame);
+   /**
+    * @brief Parses all the complete lines of a chunk. The incomplete tail is kept until the next chunk arrives.
+    *
+    * @param chunk The raw data as it was read from the git process.
+    * @return bool True if any line of the file got its commit.
+    */
+   bool processChunk(const QByteArray &chunk);
+   /**
+    * @brief Parses the remaining data once the git process has finished.
+    */
+   void finish();
+
+private:
+   FileBlame *mBlame = nullptr;
+   QByteArray mPendingData;
+   FileBlame::Commit mCommit;
+   int mFirstLine = -1;
+   int mLinesCount = 0;
+   bool mLinesBlamed = false;
+
+   void parseLine(const char *line, int size);
+};
@@ -1,7 +1,6 @@
 #include "GitBranches.h"
 
 #include <GitBase.h>
-#include <GitConfig.h>
 #include <QLogger.h>
 
 using namespace QLogger;
@@ -18,28 +17,6 @@ GitExecResult GitBranches::getBranches()
    return mGitBase->run(QString("git branch -a"));
 }
 
-GitExecResult GitBranches::getDistanceBetweenBranches(bool toMaster, const QString &right)
-{
-   QLog_Debug("Git",
-              QString("Executing getDistanceBetweenBranches: {origin/%1} and {%2}")
-                  .arg(toMaster ? QString("master") : QString("%1"), right));
-
-   QScopedPointer<GitConfig> gitConfig(new GitConfig(mGitBase));
-
-   const auto ret = gitConfig->getRemoteForBranch(toMaster ? QString("master") : right);
-
-   if (!toMaster && right == "master")
-      return { false, "Same branch" };
-   else
-   {
-      const auto gitBase = new GitBase(mGitBase->getWorkingDir());
-      const auto gitCmd = QString("git rev-list --left-right --count %1/%2...%3")
-                              .arg(ret.output.toString(), toMaster ? QString("master") : right, right);
-
-      return gitBase->run(gitCmd);
-   }
-}
-
 GitExecResult GitBranches::createBranchFromAnotherBranch(const QString &oldName, const QString &newName)
 {
    QLog_Debug("Git", QString("Executing createBranchFromAnotherBranch: {%1} and {%2}").arg(oldName, newName));
@@ -137,6 +114,11 @@ GitExecResult GitBranches::getLastCommitOfBranch(const QString &branch)
 {
    QLog_Debug("Git", QString("Executing getLastCommitOfBranch: {%1}").arg(branch));
 
+   const auto tip = mGitBase->catFile()->info(branch);
+
+   if (tip.isValid())
+      return { true, tip.sha };
+
    auto ret = mGitBase->run(QString("git rev-parse %1").arg(branch));
 
    if (ret.success)
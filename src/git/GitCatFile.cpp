@@ -0,0 +1,228 @@
+#include "GitCatFile.h"
+
+#include <GitCommandTrace.h>
+
+#include <QLogger.h>
+
+#include <QProcess>
+#include <QThread>
+
+using namespace QLogger;
+
+namespace
+{
+const auto TIMEOUT_MS = 10000;
+
+/**
+ * @brief Each query is a line, so a revision can't span more than one.
+ */
+bool isValidRevision(const QString &revision)
+{
+   return !revision.isEmpty() && !revision.contains('\n');
+}
+}
+
+GitCatFile::GitCatFile(const QString &workingDir)
+   : mWorkingDir(workingDir)
+{
+}
+
+GitCatFile::~GitCatFile()
+{
+   close();
+}
+
+GitCatFile::ObjectInfo GitCatFile::info(const QString &revision)
+{
+   ObjectInfo info;
+
+   if (!isValidRevision(revision))
+      return info;
+
+   const auto startTime = GitCommandTrace::now();
+   const auto found = query(mInfoStream, "--batch-check", revision, info);
+
+   recordTrace(mInfoStream, "--batch-check", revision, startTime, found);
+
+   return info;
+}
+
+QByteArray GitCatFile::contents(const QString &revision, ObjectInfo *info)
+{
+   ObjectInfo objectInfo;
+   QByteArray data;
+
+   if (isValidRevision(revision))
+   {
+      const auto startTime = GitCommandTrace::now();
+      const auto found = query(mContentsStream, "--batch", revision, objectInfo);
+
+      // The contents are followed by a line feed.
+      if (found && read(mContentsStream, static_cast<int>(objectInfo.size) + 1, data))
+         data.chop(1);
+      else
+         objectInfo = ObjectInfo();
+
+      recordTrace(mContentsStream, "--batch", revision, startTime, objectInfo.isValid());
+   }
+
+   if (info)
+      *info = objectInfo;
+
+   return data;
+}
+
+void GitCatFile::close()
+{
+   stop(mInfoStream);
+   stop(mContentsStream);
+}
+
+bool GitCatFile::query(Stream &stream, const QString &mode, const QString &revision, ObjectInfo &info)
+{
+   if (!start(stream, mode))
+      return false;
+
+   stream.process->write(revision.toUtf8().append('\n'));
+
+   QByteArray line;
+
+   if (!readLine(stream, line))
+      return false;
+
+   // The answer is "<sha> <type> <size>" or "<revision> missing" when it can't be resolved.
+   const auto fields = line.split(' ');
+
+   if (fields.count() != 3)
+      return false;
+
+   info.sha = QString::fromLatin1(fields.at(0));
+   info.type = QString::fromLatin1(fields.at(1));
+   info.size = fields.at(2).toLongLong();
+
+   return true;
+}
+
+bool GitCatFile::start(Stream &stream, const QString &mode)
+{
+   if (stream.process && stream.process->state() == QProcess::Running)
+      return true;
+
+   stop(stream);
+
+   const auto startTime = GitCommandTrace::now();
+
+   stream.process.reset(new QProcess());
+   stream.process->setWorkingDirectory(mWorkingDir);
+   stream.process->start("git", { "cat-file", mode });
+
+   const auto started = stream.process->waitForStarted(TIMEOUT_MS);
+
+   stream.spawnTime = GitCommandTrace::now() - startTime;
+
+   if (!started)
+   {
+      QLog_Warning("Git", QString("Unable to start {git cat-file %1} in {%2}.").arg(mode, mWorkingDir));
+      stop(stream);
+      return false;
+   }
+
+   QLog_Debug("Git", QString("Started {git cat-file %1} in {%2}.").arg(mode, mWorkingDir));
+
+   return true;
+}
+
+bool GitCatFile::read(Stream &stream, int size, QByteArray &data)
+{
+   readAvailable(stream);
+
+   while (stream.buffer.size() < size)
+   {
+      if (!stream.process->waitForReadyRead(TIMEOUT_MS))
+      {
+         // The answer would be out of sync with the next query, so the process is discarded.
+         QLog_Warning("Git", QString("The git cat-file helper in {%1} stopped answering.").arg(mWorkingDir));
+         stop(stream);
+         return false;
+      }
+
+      readAvailable(stream);
+   }
+
+   data = stream.buffer.left(size);
+   stream.buffer.remove(0, size);
+
+   return true;
+}
+
+bool GitCatFile::readLine(Stream &stream, QByteArray &line)
+{
+   readAvailable(stream);
+
+   auto end = stream.buffer.indexOf('\n');
+
+   while (end == -1)
+   {
+      if (!stream.process->waitForReadyRead(TIMEOUT_MS))
+      {
+         QLog_Warning("Git", QString("The git cat-file helper in {%1} stopped answering.").arg(mWorkingDir));
+         stop(stream);
+         return false;
+      }
+
+      readAvailable(stream);
+      end = stream.buffer.indexOf('\n');
+   }
+
+   line = stream.buffer.left(end);
+   stream.buffer.remove(0, end + 1);
+
+   return true;
+}
+
+void GitCatFile::readAvailable(Stream &stream)
+{
+   const auto data = stream.process->readAllStandardOutput();
+
+   stream.bytesRead += data.size();
+   stream.buffer.append(data);
+}
+
+void GitCatFile::stop(Stream &stream)
+{
+   if (stream.process)
+   {
+      stream.process->closeWriteChannel();
+
+      if (!stream.process->waitForFinished(1000))
+      {
+         stream.process->kill();
+         stream.process->waitForFinished();
+      }
+
+      stream.process.reset();
+   }
+
+   stream.buffer.clear();
+}
+
+void GitCatFile::recordTrace(Stream &stream, const QString &mode, const QString &revision, qint64 startTime,
+                             bool found)
+{
+   GitCommandTrace::Record record;
+   record.startTime = startTime;
+   record.spawnTime = stream.spawnTime;
+   record.wallTime = GitCommandTrace::now() - startTime;
+   record.bytesRead = stream.bytesRead;
+   // There is no process that exits per query: 0 means the object was found and 1 that it wasn't.
+   record.exitCode = found ? 0 : 1;
+   record.crashed = !stream.process;
+   record.threadId = reinterpret_cast<quintptr>(QThread::currentThreadId());
+   record.subsystem = GitCommandTrace::currentSubsystem();
+   record.command = QString("git cat-file %1 %2").arg(mode, revision).toUtf8();
+
+   GitCommandTrace::record(record);
+
+   stream.spawnTime = 0;
+   stream.bytesRead = 0;
+}
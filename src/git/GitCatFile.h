@@ -0,0 +1,104 @@
+#pragma once
+
+#pragma once
+
+/****************************************************************************************
+ ** GitQlient is an application to manage and operate one or several Git repositories. With
+ ** GitQlient you will be able to add commits, branches and manage all the options Git provides.
+ ** Copyright (C) 2020  Francesc Martinez
+ **
+ ** LinkedIn: www.linkedin.com/in/cescmm/
+ ** Web: www.francescmm.com
+ **
+ ** This program is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public
+ ** License as published by the Free Software Foundation; either
+ ** version 2 of the License, or (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this library; if not, write to the Free Software
+ ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ***************************************************************************************/
+
+#include <QByteArray>
+#include <QScopedPointer>
+#include <QString>
+
+class QProcess;
+
+/**
+ * @brief The GitCatFile class keeps git cat-file running in batch mode for a repository, so object and reference
+ * lookups don't need to start a new git process each time. Each query is written as a line to the standard input and
+ * the answer is read back synchronously. Two processes are started on demand: one with --batch-check for the object
+ * information and another one with --batch for the contents.
+ *
+ * The references are resolved again on every query, so the answers are never stale. Every query is recorded in the
+ * @ref GitCommandTrace as if it was a git process. The class must be used from the thread that created it.
+ *
+ * @class GitCatFile GitCatFile.h "GitCatFile.h"
+ */
+class GitCatFile
+{
+public:
+   /**
+    * @brief The information of an object. The SHA is empty if the revision couldn't be resolved.
+    */
+   struct ObjectInfo
+   {
+      QString sha;
+      QString type;
+      qint64 size = -1;
+
+      bool isValid() const { return !sha.isEmpty(); }
+   };
+
+   explicit GitCatFile(const QString &workingDir);
+   ~GitCatFile();
+
+   /**
+    * @brief Resolves a revision (SHA, reference or any expression git understands) to an object.
+    *
+    * @param revision The revision to resolve.
+    * @return ObjectInfo The object information. Invalid if it doesn't exist.
+    */
+   ObjectInfo info(const QString &revision);
+   /**
+    * @brief Reads the raw contents of an object.
+    *
+    * @param revision The revision of the object.
+    * @param info If not null, it receives the object information.
+    * @return QByteArray The contents of the object. Empty if it doesn't exist.
+    */
+   QByteArray contents(const QString &revision, ObjectInfo *info = nullptr);
+   /**
+    * @brief Stops the helper processes. They are started again with the next query.
+    */
+   void close();
+
+private:
+   struct Stream
+   {
+      QScopedPointer<QProcess> process;
+      QByteArray buffer;
+      qint64 spawnTime = 0;
+      qint64 bytesRead = 0;
+   };
+
+   QString mWorkingDir;
+   Stream mInfoStream;
+   Stream mContentsStream;
+
+   bool query(Stream &stream, const QString &mode, const QString &revision, ObjectInfo &info);
+   bool start(Stream &stream, const QString &mode);
+   bool read(Stream &stream, int size, QByteArray &data);
+   bool readLine(Stream &stream, QByteArray &line);
+   static void readAvailable(Stream &stream);
+   static void stop(Stream &stream);
+   static void recordTrace(Stream &stream, const QString &mode, const QString &revision, qint64 startTime,
+                           bool found);
+};
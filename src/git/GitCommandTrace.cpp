@@ -0,0 +1,170 @@
+#include "GitCommandTrace.h"
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+
+namespace
+{
+const quint64 CAPACITY = 4096;
+const auto COMMAND_SIZE = 160;
+
+/**
+ * @brief A slot of the ring buffer. The sequence is 0 while the slot is being written and the 1-based position of the
+ * record once it's complete, so a reader can tell if it read a full record.
+ */
+struct Slot
+{
+   std::atomic<quint64> sequence { 0 };
+   qint64 startTime;
+   qint64 spawnTime;
+   qint64 wallTime;
+   qint64 bytesRead;
+   int exitCode;
+   bool crashed;
+   quintptr threadId;
+   const char *subsystem;
+   char command[COMMAND_SIZE];
+};
+
+Slot sSlots[CAPACITY];
+std::atomic<quint64> sNextRecord { 0 };
+thread_local const char *sSubsystem = nullptr;
+
+const QElapsedTimer &applicationTimer()
+{
+   static const auto timer = []() {
+      QElapsedTimer t;
+      t.start();
+      return t;
+   }();
+
+   return timer;
+}
+}
+
+GitCommandTrace::Scope::Scope(const char *subsystem)
+   : mPrevious(sSubsystem)
+{
+   sSubsystem = subsystem;
+}
+
+GitCommandTrace::Scope::~Scope()
+{
+   sSubsystem = mPrevious;
+}
+
+const char *GitCommandTrace::currentSubsystem()
+{
+   return sSubsystem;
+}
+
+qint64 GitCommandTrace::now()
+{
+   return applicationTimer().nsecsElapsed();
+}
+
+void GitCommandTrace::record(const Record &record)
+{
+   const auto position = sNextRecord.fetch_add(1, std::memory_order_relaxed);
+   auto &slot = sSlots[position % CAPACITY];
+
+   slot.sequence.store(0, std::memory_order_relaxed);
+   std::atomic_thread_fence(std::memory_order_release);
+
+   slot.startTime = record.startTime;
+   slot.spawnTime = record.spawnTime;
+   slot.wallTime = record.wallTime;
+   slot.bytesRead = record.bytesRead;
+   slot.exitCode = record.exitCode;
+   slot.crashed = record.crashed;
+   slot.threadId = record.threadId;
+   slot.subsystem = record.subsystem;
+
+   const auto size = std::min(record.command.size(), COMMAND_SIZE - 1);
+   memcpy(slot.command, record.command.constData(), static_cast<size_t>(size));
+   slot.command[size] = '\0';
+
+   slot.sequence.store(position + 1, std::memory_order_release);
+}
+
+QVector<GitCommandTrace::Record> GitCommandTrace::records()
+{
+   const auto end = sNextRecord.load(std::memory_order_acquire);
+   const auto begin = end > CAPACITY ? end - CAPACITY : 0;
+   QVector<Record> records;
+   records.reserve(static_cast<int>(end - begin));
+
+   for (auto position = begin; position < end; ++position)
+   {
+      const auto &slot = sSlots[position % CAPACITY];
+      const auto sequence = slot.sequence.load(std::memory_order_acquire);
+
+      // The slot is still being written or has already been reused by a newer record.
+      if (sequence != position + 1)
+         continue;
+
+      Record record;
+      record.startTime = slot.startTime;
+      record.spawnTime = slot.spawnTime;
+      record.wallTime = slot.wallTime;
+      record.bytesRead = slot.bytesRead;
+      record.exitCode = slot.exitCode;
+      record.crashed = slot.crashed;
+      record.threadId = slot.threadId;
+      record.subsystem = slot.subsystem;
+      record.command = QByteArray(slot.command);
+
+      std::atomic_thread_fence(std::memory_order_acquire);
+
+      if (slot.sequence.load(std::memory_order_relaxed) == sequence)
+         records.append(record);
+   }
+
+   return records;
+}
+
+bool GitCommandTrace::exportChromeTrace(const QString &fileName)
+{
+   QFile file(fileName);
+
+   if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+      return false;
+
+   QJsonArray events;
+   const auto processId = QCoreApplication::applicationPid();
+
+   for (const auto &record : records())
+   {
+      QJsonObject args;
+      args.insert("spawn_us", record.spawnTime / 1000.0);
+      args.insert("bytes_read", record.bytesRead);
+      args.insert("exit_code", record.exitCode);
+      args.insert("crashed", record.crashed);
+
+      QJsonObject event;
+      event.insert("name", QString::fromUtf8(record.command));
+      event.insert("cat", QString::fromLatin1(record.subsystem ? record.subsystem : "Unknown"));
+      event.insert("ph", "X");
+      event.insert("ts", record.startTime / 1000.0);
+      event.insert("dur", record.wallTime / 1000.0);
+      event.insert("pid", processId);
+      event.insert("tid", static_cast<qint64>(record.threadId));
+      event.insert("args", args);
+
+      events.append(event);
+   }
+
+   QJsonObject trace;
+   trace.insert("traceEvents", events);
+   trace.insert("displayTimeUnit", "ms");
+
+   return file.write(QJsonDocument(trace).toJson(QJsonDocument::Compact)) != -1;
+}
@@ -0,0 +1,105 @@
+#pragma once
+
+#pragma once
+
+/****************************************************************************************
+ ** GitQlient is an application to manage and operate one or several Git repositories. With
+ ** GitQlient you will be able to add commits, branches and manage all the options Git provides.
+ ** Copyright (C) 2020  Francesc Martinez
+ **
+ ** LinkedIn: www.linkedin.com/in/cescmm/
+ ** Web: www.francescmm.com
+ **
+ ** This program is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public
+ ** License as published by the Free Software Foundation; either
+ ** version 2 of the License, or (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this library; if not, write to the Free Software
+ ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ***************************************************************************************/
+
+#include <QByteArray>
+#include <QString>
+#include <QVector>
+
+/**
+ * @brief The GitCommandTrace class records how long every git process takes. Each process stores one record in a
+ * fixed-size ring buffer without taking any lock, so it can be used from any thread and it's always enabled. The
+ * oldest records are overwritten once the buffer is full.
+ *
+ * The records can be exported in the Chrome trace-event format (to open them in chrome://tracing or Perfetto) and are
+ * summarized in the diagnostics dialog.
+ *
+ * @class GitCommandTrace GitCommandTrace.h "GitCommandTrace.h"
+ */
+class GitCommandTrace
+{
+public:
+   /**
+    * @brief The measures of a git process. All the times are in nanoseconds and the start time is relative to the
+    * start of the application.
+    */
+   struct Record
+   {
+      qint64 startTime = 0;
+      qint64 spawnTime = 0;
+      qint64 wallTime = 0;
+      qint64 bytesRead = 0;
+      int exitCode = -1;
+      bool crashed = false;
+      quintptr threadId = 0;
+      const char *subsystem = nullptr;
+      QByteArray command;
+   };
+
+   /**
+    * @brief The Scope class sets the subsystem that is attributed to the git processes created in the current thread
+    * while it's alive. Scopes can be nested.
+    */
+   class Scope
+   {
+   public:
+      /**
+       * @param subsystem A string literal that names the subsystem.
+       */
+      explicit Scope(const char *subsystem);
+      ~Scope();
+
+      Scope(const Scope &) = delete;
+      Scope &operator=(const Scope &) = delete;
+
+   private:
+      const char *mPrevious;
+   };
+
+   /**
+    * @brief Returns the subsystem of the innermost scope of the current thread.
+    */
+   static const char *currentSubsystem();
+   /**
+    * @brief Returns the nanoseconds elapsed since the application started.
+    */
+   static qint64 now();
+   /**
+    * @brief Stores a record in the ring buffer.
+    */
+   static void record(const Record &record);
+   /**
+    * @brief Returns the records currently stored, from the oldest to the newest.
+    */
+   static QVector<Record> records();
+   /**
+    * @brief Writes the records in the Chrome trace-event JSON format.
+    *
+    * @param fileName The file to write.
+    * @return bool True if the file was written.
+    */
+   static bool exportChromeTrace(const QString &fileName);
+};
@@ -0,0 +1,212 @@
+#include "GitDiffTreeParser.h"
+
+#include <cstring>
+
+const QByteArray GitDiffTreeParser::ANSWER_END = QByteArray("GitQlient:answer-end\n");
+
+namespace
+{
+/**
+ * @brief Returns the first NUL between @p begin and @p end, or nullptr if the record is not terminated.
+ */
+const char *findTerminator(const char *begin, const char *end)
+{
+   return static_cast<const char *>(memchr(begin, '\0', static_cast<size_t>(end - begin)));
+}
+
+/**
+ * @brief Returns where the last space separated field of the metadata between @p begin and @p end starts.
+ */
+const char *lastField(const char *begin, const char *end)
+{
+   auto field = end;
+
+   while (field > begin && field[-1] != ' ')
+      --field;
+
+   return field;
+}
+}
+
+void GitDiffTreeParser::reset()
+{
+   mPendingData.clear();
+   mCurrentSha.clear();
+   mCommits.clear();
+   mFiles = RevisionFiles();
+   mAnswerSize = 0;
+   mAnswerEnded = false;
+}
+
+void GitDiffTreeParser::processChunk(const QByteArray &chunk)
+{
+   mPendingData.append(chunk);
+
+   const auto data = mPendingData.constData();
+   const auto end = data + mPendingData.size();
+   auto pos = data;
+
+   while (pos < end)
+   {
+      const auto next = parseRecord(pos, end);
+
+      if (!next)
+         break;
+
+      mAnswerSize += static_cast<int>(next - pos);
+      pos = next;
+
+      if (mAnswerEnded)
+         completeCommit();
+   }
+
+   mPendingData.remove(0, static_cast<int>(pos - data));
+}
+
+QVector<GitDiffTreeParser::CommitFiles> GitDiffTreeParser::takeCommits()
+{
+   QVector<CommitFiles> commits;
+   commits.swap(mCommits);
+
+   return commits;
+}
+
+const char *GitDiffTreeParser::parseRecord(const char *record, const char *end)
+{
+   // The end of an answer is a line, not a NUL terminated record.
+   if (*record == ANSWER_END.at(0))
+   {
+      if (end - record < ANSWER_END.size())
+         return nullptr;
+
+      if (memcmp(record, ANSWER_END.constData(), static_cast<size_t>(ANSWER_END.size())) == 0)
+      {
+         mAnswerEnded = true;
+         return record + ANSWER_END.size();
+      }
+   }
+
+   const auto metadataEnd = findTerminator(record, end);
+
+   if (!metadataEnd)
+      return nullptr;
+
+   // Anything that is not a change is the SHA that starts the next commit of the --stdin run.
+   if (*record != ':')
+   {
+      const auto size = static_cast<int>(metadataEnd - record);
+
+      if (size > 0)
+         startCommit(record, size);
+
+      return metadataEnd + 1;
+   }
+
+   // ":<mode> <mode> <sha> <sha> <status>" or, for the combined merges, one colon and one mode and SHA per parent.
+   auto colons = 0;
+
+   while (record + colons < metadataEnd && record[colons] == ':')
+      ++colons;
+
+   const auto status = lastField(record, metadataEnd);
+   const auto statusSize = static_cast<int>(metadataEnd - status);
+   const auto path = metadataEnd + 1;
+   const auto pathEnd = findTerminator(path, end);
+
+   if (!pathEnd)
+      return nullptr;
+
+   if (statusSize == 0)
+      return pathEnd + 1;
+
+   if (colons > 1)
+   {
+      /* For combined merges rename/copy information is useless
+       * because nor the original file name, nor similarity info
+       * is given, just the status tracks that in the left/right
+       * branch a renamed/copy occurred (as example status could
+       * be RM or MR). For visualization purposes we could consider
+       * the file as modified
+       */
+      appendFile(path, static_cast<int>(pathEnd - path));
+      mFiles.setStatus(RevisionFiles::MODIFIED);
+   }
+   else if (*status == 'R' || *status == 'C')
+   {
+      const auto dest = pathEnd + 1;
+      const auto destEnd = findTerminator(dest, end);
+
+      if (!destEnd)
+         return nullptr;
+
+      appendCopy(status, statusSize, path, static_cast<int>(pathEnd - path), dest, static_cast<int>(destEnd - dest));
+
+      return destEnd + 1;
+   }
+   else
+   {
+      appendFile(path, static_cast<int>(pathEnd - path));
+      mFiles.setStatus(*status);
+   }
+
+   return pathEnd + 1;
+}
+
+void GitDiffTreeParser::startCommit(const char *sha, int size)
+{
+   mCurrentSha = QString::fromLatin1(sha, size);
+   mFiles = RevisionFiles();
+}
+
+void GitDiffTreeParser::completeCommit()
+{
+   mCommits.append({ mCurrentSha, mFiles, mAnswerSize });
+
+   mCurrentSha.clear();
+   mFiles = RevisionFiles();
+   mAnswerSize = 0;
+   mAnswerEnded = false;
+}
+
+void GitDiffTreeParser::appendFile(const char *path, int size)
+{
+   mFiles.appendFile(FilePathPool::instance().intern(path, size));
+   mFiles.mergeParent.append(1);
+}
+
+void GitDiffTreeParser::appendCopy(const char *status, int statusSize, const char *orig, int origSize,
+                                   const char *dest, int destSize)
+{
+   // The status is the letter followed by the similarity score: "R090".
+   auto score = 0;
+
+   for (auto i = 1; i < statusSize && status[i] >= '0' && status[i] <= '9'; ++i)
+      score = score * 10 + status[i] - '0';
+
+   // we want store extra info with format "orig --> dest (Rxx%)"
+   const auto extStatusInfo = QString::fromUtf8(orig, origSize) + " --> " + QString::fromUtf8(dest, destSize) + " ("
+       + QString::number(score) + "%)";
+
+   /*
+    NOTE: we set rf.extStatus size equal to position of latest
+          copied/renamed file. So it can have size lower then
+          rf.count() if after copied/renamed file there are
+          others. Here we have no possibility to know final
+          dimension of this RefFile. We are still in parsing.
+ */
+
+   // simulate new file
+   appendFile(dest, destSize);
+   mFiles.setStatus(RevisionFiles::NEW);
+   mFiles.appendExtStatus(extStatusInfo);
+
+   // simulate deleted orig file only in case of rename
+   if (*status == 'R')
+   {
+      appendFile(orig, origSize);
+      mFiles.setStatus(RevisionFiles::DELETED);
+      mFiles.appendExtStatus(extStatusInfo);
+   }
+
+   mFiles.setOnlyModified(false);
+}
@@ -0,0 +1,96 @@
+#pragma once
+
+/****************************************************************************************
+ ** GitQlient is an application to manage and operate one or several Git repositories. With
+ ** GitQlient you will be able to add commits, branches and manage all the options Git provides.
+ ** Copyright (C) 2020  Francesc Martinez
+ **
+ ** LinkedIn: www.linkedin.com/in/cescmm/
+ ** Web: www.francescmm.com
+ **
+ ** This program is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public
+ ** License as published by the Free Software Foundation; either
+ ** version 2 of the License, or (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this library; if not, write to the Free Software
+ ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ***************************************************************************************/
+
+#include <RevisionFiles.h>
+
+#include <QByteArray>
+#include <QString>
+#include <QVector>
+
+/**
+ * @brief The GitDiffTreeParser class reads the raw output of git diff-tree -z and builds the files of a revision from
+ * it. The buffer is walked in place: the records are located by their NUL terminators, the status is the last field of
+ * the metadata so the length of the object names doesn't matter (SHA-1 or SHA-256), and the paths are interned in the
+ * @ref FilePathPool straight from the bytes. Nothing is decoded to QString except the description of the renames.
+ *
+ * It understands the regular records, the renames and copies (that have two paths) and the combined records of the
+ * merges.
+ *
+ * The output of git diff-tree --stdin, that has the changes of many commits, is fed in chunks while the process is
+ * still running. Each commit starts with its SHA and every query is followed by the @ref ANSWER_END line, that git
+ * writes back as it was received since it's not an object name. The answer of a query is complete when that line
+ * arrives.
+ *
+ * @class GitDiffTreeParser GitDiffTreeParser.h "GitDiffTreeParser.h"
+ */
+class GitDiffTreeParser
+{
+public:
+   /**
+    * @brief The line written after every query to know where its answer ends. It can't start with a hexadecimal digit,
+    * or git would take it as an object name.
+    */
+   static const QByteArray ANSWER_END;
+
+   /**
+    * @brief The answer to one of the queries of a git diff-tree --stdin run. The SHA is empty if git couldn't list the
+    * files of the commit.
+    */
+   struct CommitFiles
+   {
+      QString sha;
+      RevisionFiles files;
+      int size = 0; // The bytes of the answer in the output of git.
+   };
+
+   /**
+    * @brief Discards any data from a previous run of git diff-tree --stdin.
+    */
+   void reset();
+   /**
+    * @brief Parses all the complete records of a chunk. The incomplete tail is kept until the next chunk arrives.
+    *
+    * @param chunk The raw data as it was read from the git process.
+    */
+   void processChunk(const QByteArray &chunk);
+   /**
+    * @brief Returns the answers that are complete, in the order of the queries, and removes them from the parser.
+    */
+   QVector<CommitFiles> takeCommits();
+
+private:
+   QByteArray mPendingData;
+   QString mCurrentSha;
+   QVector<CommitFiles> mCommits;
+   RevisionFiles mFiles;
+   int mAnswerSize = 0;
+   bool mAnswerEnded = false;
+
+   const char *parseRecord(const char *record, const char *end);
+   void startCommit(const char *sha, int size);
+   void completeCommit();
+   void appendFile(const char *path, int size);
+   void appendCopy(const char *status, int statusSize, const char *orig, int origSize, const char *dest, int destSize);
+};
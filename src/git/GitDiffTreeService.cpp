@@ -0,0 +1,343 @@
+#include "GitDiffTreeService.h"
+
+#include <CommitInfo.h>
+#include <GitCommandTrace.h>
+
+#include <QProcess>
+#include <QProcessEnvironment>
+#include <QThread>
+
+#include <QLogger.h>
+
+#include <algorithm>
+
+using namespace QLogger;
+
+namespace
+{
+const auto TIMEOUT_MS = 10000;
+
+// Queries written to git at a time. The rest wait in the queue, where they can still be discarded.
+const auto MAX_IN_FLIGHT = 16;
+
+// --always makes git write the SHA of the commits without changes, so their answer is not taken as a failed one. --root
+// compares the commits without parents to an empty tree.
+const QStringList ARGUMENTS { "diff-tree", "--stdin", "-r", "-z", "-C", "--always", "--root", "--no-color" };
+
+/**
+ * @brief Tells if the SHA can be written in a query, that is a line of SHAs separated by spaces.
+ */
+bool isValidSha(const QString &sha)
+{
+   return sha != CommitInfo::ZERO_SHA && !sha.contains(' ') && !sha.contains('\n');
+}
+}
+
+GitDiffTreeService::GitDiffTreeService(const QString &workingDir, QObject *parent)
+   : QObject(parent)
+   , mWorkingDir(workingDir)
+{
+}
+
+GitDiffTreeService::~GitDiffTreeService()
+{
+   close();
+}
+
+void GitDiffTreeService::request(const QString &sha, const QString &parentSha, QObject *context,
+                                 const Callback &callback)
+{
+   if (!context || sha.isEmpty() || !isValidSha(sha) || !isValidSha(parentSha))
+      return;
+
+   if (const auto pending = findRequest(sha, parentSha))
+      pending->requesters.append({ context, callback });
+   else
+   {
+      Request newRequest;
+      newRequest.sha = sha;
+      newRequest.parentSha = parentSha;
+      newRequest.requesters.append({ context, callback });
+      newRequest.subsystem = GitCommandTrace::currentSubsystem();
+
+      mQueue.append(newRequest);
+   }
+
+   writeRequests();
+}
+
+void GitDiffTreeService::cancel(QObject *context)
+{
+   for (auto iter = mQueue.begin(); iter != mQueue.end();)
+   {
+      auto &requesters = iter->requesters;
+      const auto end = std::remove_if(requesters.begin(), requesters.end(), [context](const Requester &requester) {
+         return !requester.context || requester.context == context;
+      });
+
+      requesters.erase(end, requesters.end());
+
+      if (requesters.isEmpty())
+         iter = mQueue.erase(iter);
+      else
+         ++iter;
+   }
+}
+
+bool GitDiffTreeService::files(const QString &sha, const QString &parentSha, RevisionFiles &files)
+{
+   if (sha.isEmpty() || !isValidSha(sha) || !isValidSha(parentSha))
+      return false;
+
+   // The waiter is destroyed when the method returns, so the callback is never called after that.
+   QObject waiter;
+   auto answered = false;
+
+   request(sha, parentSha, &waiter, [&answered, &files](const RevisionFiles &revisionFiles) {
+      answered = true;
+      files = revisionFiles;
+   });
+
+   // The query goes before the ones that are waiting in the queue.
+   const auto queuePosition = std::find_if(mQueue.begin(), mQueue.end(), [&sha, &parentSha](const Request &request) {
+      return request.sha == sha && request.parentSha == parentSha;
+   });
+
+   if (queuePosition != mQueue.end())
+   {
+      mQueue.move(static_cast<int>(queuePosition - mQueue.begin()), 0);
+      writeRequests();
+   }
+
+   while (!answered && findRequest(sha, parentSha))
+   {
+      if (!mProcess || !mProcess->waitForReadyRead(TIMEOUT_MS))
+      {
+         if (!answered)
+         {
+            // The answers would be out of sync with the queries, so the process is discarded.
+            QLog_Warning("Git", QString("The git diff-tree helper in {%1} stopped answering.").arg(mWorkingDir));
+            stop();
+            writeRequests();
+         }
+
+         break;
+      }
+   }
+
+   cancel(&waiter);
+
+   return answered;
+}
+
+void GitDiffTreeService::close()
+{
+   stop();
+   mQueue.clear();
+}
+
+GitDiffTreeService::Request *GitDiffTreeService::findRequest(const QString &sha, const QString &parentSha)
+{
+   for (auto list : { &mInFlight, &mQueue })
+   {
+      for (auto &request : *list)
+      {
+         if (request.sha == sha && request.parentSha == parentSha)
+            return &request;
+      }
+   }
+
+   return nullptr;
+}
+
+bool GitDiffTreeService::start()
+{
+   if (mProcess)
+      return true;
+
+   // Every answer must be written as soon as it's ready, not when the output buffer of git is full.
+   auto environment = QProcessEnvironment::systemEnvironment();
+   environment.insert("GIT_FLUSH", "1");
+
+   mProcess = new QProcess(this);
+   mProcess->setWorkingDirectory(mWorkingDir);
+   mProcess->setProcessEnvironment(environment);
+
+   connect(mProcess, &QProcess::readyReadStandardOutput, this, &GitDiffTreeService::readOutput);
+   connect(mProcess, &QProcess::readyReadStandardError, this, [this]() {
+      QLog_Warning("Git", QString("git diff-tree: %1").arg(QString::fromUtf8(mProcess->readAllStandardError())));
+   });
+   connect(mProcess, static_cast<void (QProcess::*)(int, QProcess::ExitStatus)>(&QProcess::finished), this,
+           &GitDiffTreeService::onFinished);
+
+   const auto startTime = GitCommandTrace::now();
+
+   mProcess->start("git", ARGUMENTS);
+
+   const auto started = mProcess->waitForStarted(TIMEOUT_MS);
+
+   // It's attributed to the first query written to the new process.
+   mSpawnTime = GitCommandTrace::now() - startTime;
+
+   if (!started)
+   {
+      QLog_Warning("Git", QString("Unable to start {git diff-tree --stdin} in {%1}.").arg(mWorkingDir));
+      stop();
+      return false;
+   }
+
+   QLog_Debug("Git", QString("Started {git diff-tree --stdin} in {%1}.").arg(mWorkingDir));
+
+   mParser.reset();
+
+   return true;
+}
+
+void GitDiffTreeService::stop()
+{
+   if (mProcess)
+   {
+      mProcess->disconnect(this);
+      mProcess->closeWriteChannel();
+
+      if (!mProcess->waitForFinished(1000))
+      {
+         mProcess->kill();
+         mProcess->waitForFinished();
+      }
+
+      mProcess->deleteLater();
+      mProcess = nullptr;
+   }
+
+   discardInFlight();
+   mParser.reset();
+}
+
+void GitDiffTreeService::writeRequests()
+{
+   if (mQueue.isEmpty() || mInFlight.count() >= MAX_IN_FLIGHT)
+      return;
+
+   if (!start())
+   {
+      mQueue.clear();
+      return;
+   }
+
+   QByteArray input;
+
+   while (mInFlight.count() < MAX_IN_FLIGHT && !mQueue.isEmpty())
+   {
+      const auto request = mQueue.takeFirst();
+
+      // Nobody waits for it anymore.
+      const auto waited = std::any_of(request.requesters.cbegin(), request.requesters.cend(),
+                                      [](const Requester &requester) { return !requester.context.isNull(); });
+
+      if (!waited)
+         continue;
+
+      // "<sha> <parent>" lists the files and the line that is not an object name is written back after them.
+      auto query = request.sha;
+
+      if (!request.parentSha.isEmpty())
+         query.append(' ').append(request.parentSha);
+
+      input.append(query.toUtf8()).append('\n').append(GitDiffTreeParser::ANSWER_END);
+      mInFlight.append(request);
+      mInFlight.last().startTime = GitCommandTrace::now();
+      mInFlight.last().spawnTime = mSpawnTime;
+      mSpawnTime = 0;
+   }
+
+   mProcess->write(input);
+}
+
+void GitDiffTreeService::readOutput()
+{
+   mParser.processChunk(mProcess->readAllStandardOutput());
+
+   dispatchCommits();
+   writeRequests();
+}
+
+void GitDiffTreeService::dispatchCommits()
+{
+   const auto commits = mParser.takeCommits();
+   QVector<QPair<Request, RevisionFiles>> answers;
+
+   // The requests are matched before calling anyone, since the callbacks can send more queries.
+   // Every query has its answer, in the same order. The ones git couldn't answer have no SHA.
+   for (const auto &commit : commits)
+   {
+      if (mInFlight.isEmpty())
+         break;
+
+      const auto request = mInFlight.takeFirst();
+      const auto answered = commit.sha == request.sha;
+
+      recordTrace(request, commit.size, answered, false);
+
+      if (answered)
+         answers.append(qMakePair(request, commit.files));
+      else
+         QLog_Warning("Git", QString("The files of the commit {%1} couldn't be listed.").arg(request.sha));
+   }
+
+   for (const auto &answer : qAsConst(answers))
+   {
+      for (const auto &requester : answer.first.requesters)
+      {
+         if (requester.context)
+            requester.callback(answer.second);
+      }
+   }
+}
+
+void GitDiffTreeService::onFinished()
+{
+   QLog_Warning("Git", QString("The git diff-tree helper in {%1} finished unexpectedly.").arg(mWorkingDir));
+
+   const auto process = mProcess;
+   mProcess = nullptr;
+
+   process->disconnect(this);
+   process->deleteLater();
+
+   // Only the answers that were closed are complete.
+   mParser.processChunk(process->readAllStandardOutput());
+
+   dispatchCommits();
+
+   discardInFlight();
+   mParser.reset();
+
+   writeRequests();
+}
+
+void GitDiffTreeService::discardInFlight()
+{
+   // Git didn't finish them, so they are recorded as if their process had crashed.
+   for (const auto &request : qAsConst(mInFlight))
+      recordTrace(request, 0, false, true);
+
+   mInFlight.clear();
+}
+
+void GitDiffTreeService::recordTrace(const Request &request, int bytesRead, bool answered, bool crashed)
+{
+   GitCommandTrace::Record record;
+   record.startTime = request.startTime;
+   record.spawnTime = request.spawnTime;
+   record.wallTime = GitCommandTrace::now() - request.startTime;
+   record.bytesRead = bytesRead;
+   // There is no process that exits per query: 0 means the files were listed and 1 that they weren't.
+   record.exitCode = answered ? 0 : 1;
+   record.crashed = crashed;
+   record.threadId = reinterpret_cast<quintptr>(QThread::currentThreadId());
+   record.subsystem = request.subsystem;
+   record.command = QString("git diff-tree --stdin %1 %2").arg(request.sha, request.parentSha).trimmed().toUtf8();
+
+   GitCommandTrace::record(record);
+}
@@ -0,0 +1,132 @@
+#pragma once
+
+/****************************************************************************************
+ ** GitQlient is an application to manage and operate one or several Git repositories. With
+ ** GitQlient you will be able to add commits, branches and manage all the options Git provides.
+ ** Copyright (C) 2020  Francesc Martinez
+ **
+ ** LinkedIn: www.linkedin.com/in/cescmm/
+ ** Web: www.francescmm.com
+ **
+ ** This program is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public
+ ** License as published by the Free Software Foundation; either
+ ** version 2 of the License, or (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this library; if not, write to the Free Software
+ ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ***************************************************************************************/
+
+#include <GitDiffTreeParser.h>
+
+#include <QList>
+#include <QObject>
+#include <QPointer>
+#include <QString>
+#include <QVector>
+
+#include <functional>
+
+class QProcess;
+
+/**
+ * @brief The GitDiffTreeService class keeps git diff-tree --stdin running for a repository, so listing the files of a
+ * commit doesn't need to start a new git process each time. Each query is a line with the commit and the commit it's
+ * compared to, followed by the GitDiffTreeParser::ANSWER_END line. git writes that line back as it is, since it's not
+ * an object name, so the end of every answer is known without waiting for the next one. The output is parsed by
+ * @ref GitDiffTreeParser as it arrives.
+ *
+ * The queries are queued and only a few of them are written to git at a time, so the ones that are not needed anymore
+ * can be discarded before git works on them. The results are delivered to the callers through callbacks, in the order
+ * of the queries. The process is started with the first query and it's kept running. Every query that git works on is
+ * recorded in the @ref GitCommandTrace as if it was a git process. The class must be used from the thread that created
+ * it.
+ *
+ * @class GitDiffTreeService GitDiffTreeService.h "GitDiffTreeService.h"
+ */
+class GitDiffTreeService : public QObject
+{
+   Q_OBJECT
+
+public:
+   /**
+    * @brief The function that receives the files of a commit.
+    */
+   using Callback = std::function<void(const RevisionFiles &files)>;
+
+   explicit GitDiffTreeService(const QString &workingDir, QObject *parent = nullptr);
+   ~GitDiffTreeService() override;
+
+   /**
+    * @brief Queues the query of the files of a commit. The callback is not called if git can't list them or if the
+    * context is destroyed before the answer arrives. A commit that is already queued is only queried once.
+    *
+    * @param sha The SHA of the commit.
+    * @param parentSha The SHA of the commit to compare to. If it's empty, the commit is compared to an empty tree.
+    * @param context The object that requests the files. It can't be null.
+    * @param callback The function that receives the files.
+    */
+   void request(const QString &sha, const QString &parentSha, QObject *context, const Callback &callback);
+   /**
+    * @brief Discards the queries of @p context that were not sent to git yet. The answers of the ones that git is
+    * already listing are still delivered while the context exists.
+    */
+   void cancel(QObject *context);
+   /**
+    * @brief Lists the files of a commit synchronously. The query is sent before the ones that are waiting in the queue.
+    *
+    * @param sha The SHA of the commit.
+    * @param parentSha The SHA of the commit to compare to. If it's empty, the commit is compared to an empty tree.
+    * @param files The files of the commit.
+    * @return bool True if git listed the files.
+    */
+   bool files(const QString &sha, const QString &parentSha, RevisionFiles &files);
+   /**
+    * @brief Returns the number of queries that didn't get their answer yet.
+    */
+   int pendingCount() const { return mQueue.count() + mInFlight.count(); }
+   /**
+    * @brief Stops the git process and discards all the queries. It's started again with the next query.
+    */
+   void close();
+
+private:
+   struct Requester
+   {
+      QPointer<QObject> context;
+      Callback callback;
+   };
+
+   struct Request
+   {
+      QString sha;
+      QString parentSha;
+      QVector<Requester> requesters;
+      const char *subsystem = nullptr;
+      qint64 startTime = 0;
+      qint64 spawnTime = 0;
+   };
+
+   QString mWorkingDir;
+   QProcess *mProcess = nullptr;
+   qint64 mSpawnTime = 0;
+   GitDiffTreeParser mParser;
+   QList<Request> mQueue;
+   QList<Request> mInFlight;
+
+   Request *findRequest(const QString &sha, const QString &parentSha);
+   bool start();
+   void stop();
+   void writeRequests();
+   void readOutput();
+   void dispatchCommits();
+   void onFinished();
+   void discardInFlight();
+   static void recordTrace(const Request &request, int bytesRead, bool answered, bool crashed);
+};
@@ -0,0 +1,30 @@
+#include "GitFuture.h"
+
+GitFuture::GitFuture(const QString &command, Priority priority, QObject *parent)
+   : QObject(parent)
+   , mCommand(command)
+   , mPriority(priority)
+   , mResult(false, QString())
+{
+}
+
+void GitFuture::cancel()
+{
+   if (mFinished || mCanceled)
+      return;
+
+   mCanceled = true;
+
+   emit signalCancelRequested();
+}
+
+void GitFuture::finish(const GitExecResult &result)
+{
+   if (mFinished)
+      return;
+
+   mFinished = true;
+   mResult = result;
+
+   emit signalFinished(mResult);
+}
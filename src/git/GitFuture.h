@@ -0,0 +1,123 @@
+#pragma once
+
+#pragma once
+
+/****************************************************************************************
+ ** GitQlient is an application to manage and operate one or several Git repositories. With
+ ** GitQlient you will be able to add commits, branches and manage all the options Git provides.
+ ** Copyright (C) 2020  Francesc Martinez
+ **
+ ** LinkedIn: www.linkedin.com/in/cescmm/
+ ** Web: www.francescmm.com
+ **
+ ** This program is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public
+ ** License as published by the Free Software Foundation; either
+ ** version 2 of the License, or (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this library; if not, write to the Free Software
+ ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ***************************************************************************************/
+
+#include <GitExecResult.h>
+
+#include <QMetaObject>
+#include <QObject>
+
+/**
+ * @brief The GitFuture class is the handle of a git command that runs in the background through the @ref
+ * GitProcessPool. The result is delivered through @ref signalFinished, which is emitted exactly once: when the command
+ * finishes, fails to start or is cancelled.
+ *
+ * @class GitFuture GitFuture.h "GitFuture.h"
+ */
+class GitFuture : public QObject
+{
+   Q_OBJECT
+
+signals:
+   /**
+    * @brief Signal triggered every time the command writes data. Useful to parse long outputs as they are produced.
+    *
+    * @param chunk The raw data as it was read from the git process.
+    */
+   void signalOutputReady(const QByteArray &chunk);
+   /**
+    * @brief Signal triggered when the command has finished.
+    *
+    * @param result The result of the command. It's not successful if the command was cancelled.
+    */
+   void signalFinished(const GitExecResult &result);
+   /**
+    * @brief Signal triggered when the cancellation is requested. The pool listens to it to stop the process.
+    */
+   void signalCancelRequested();
+
+public:
+   /**
+    * @brief The priority of the command in the pool. Interactive commands are the ones the user is waiting for, like
+    * the diff of the selected file, and they always jump ahead of the rest.
+    */
+   enum class Priority
+   {
+      Interactive,
+      Normal,
+      Background
+   };
+
+   explicit GitFuture(const QString &command, Priority priority, QObject *parent = nullptr);
+
+   QString command() const { return mCommand; }
+   Priority priority() const { return mPriority; }
+   bool isFinished() const { return mFinished; }
+   bool isCanceled() const { return mCanceled; }
+   /**
+    * @brief Returns the result of the command. Only valid once it has finished.
+    */
+   GitExecResult result() const { return mResult; }
+
+   /**
+    * @brief Cancels the command: it is dropped if it didn't start yet, otherwise the process is killed.
+    */
+   void cancel();
+
+   /**
+    * @brief Calls @p callback with the result once the command has finished. If it already finished, the call is
+    * queued so the callback never runs before this method returns.
+    *
+    * @param context The object whose lifetime limits the call.
+    * @param callback The callable that receives the GitExecResult.
+    */
+   template <typename Callback>
+   void then(QObject *context, Callback callback)
+   {
+      if (mFinished)
+      {
+         const auto result = mResult;
+         QMetaObject::invokeMethod(
+             context, [callback, result]() { callback(result); }, Qt::QueuedConnection);
+      }
+      else
+         connect(this, &GitFuture::signalFinished, context, callback);
+   }
+
+   /**
+    * @brief Stores the result and notifies it. Only the first call has any effect.
+    *
+    * @param result The result of the command.
+    */
+   void finish(const GitExecResult &result);
+
+private:
+   QString mCommand;
+   Priority mPriority;
+   bool mFinished = false;
+   bool mCanceled = false;
+   GitExecResult mResult;
+};
@@ -10,11 +10,12 @@ GitHistory::GitHistory(const QSharedPointer<GitBase> &gitBase)
 {
 }
 
-GitExecResult GitHistory::blame(const QString &file, const QString &commitFrom)
+QString GitHistory::getBlameCommand(const QString &file, const QString &commitFrom) const
 {
-   QLog_Debug("Git", QString("Executing blame: {%1} from {%2}").arg(file, commitFrom));
+   // Without a commit git blames the file in the working directory.
+   const auto revision = commitFrom == CommitInfo::ZERO_SHA ? QString() : QString(" %1").arg(commitFrom);
 
-   return mGitBase->run(QString("git annotate %1 %2").arg(file, commitFrom));
+   return QString("git blame --incremental --porcelain%1 -- $%2$").arg(revision, file);
 }
 
 GitExecResult GitHistory::history(const QString &file)
@@ -35,21 +36,7 @@ GitExecResult GitHistory::getCommitDiff(const QString &sha, const QString &diffT
    {
       QLog_Debug("Git", QString("Executing getCommitDiff: {%1} to {%2}").arg(sha, diffToSha));
 
-      QString runCmd = QString("git diff-tree --no-color -r --patch-with-stat -m");
-
-      if (sha != CommitInfo::ZERO_SHA)
-      {
-         runCmd += " -C ";
-
-         if (diffToSha.isEmpty())
-            runCmd += " --root ";
-
-         runCmd.append(QString("%1 %2").arg(diffToSha, sha)); // diffToSha could be empty
-      }
-      else
-         runCmd = "git diff HEAD ";
-
-      return mGitBase->run(runCmd);
+      return mGitBase->run(getCommitDiffCommand(sha, diffToSha));
    }
    else
       QLog_Warning("Git", QString("Executing getCommitDiff with empty SHA"));
@@ -57,26 +44,69 @@ GitExecResult GitHistory::getCommitDiff(const QString &sha, const QString &diffT
    return qMakePair(false, QString());
 }
 
-QString GitHistory::getFileDiff(const QString &currentSha, const QString &previousSha, const QString &file)
+QString GitHistory::getCommitDiffCommand(const QString &sha, const QString &diffToSha) const
 {
-   QLog_Debug("Git", QString("Executing getFileDiff: {%1} between {%2} and {%3}").arg(file, currentSha, previousSha));
+   if (sha == CommitInfo::ZERO_SHA)
+      return QString("git diff HEAD ");
 
-   const auto ret = mGitBase->run(QString("git diff -U15000 %1 %2 %3").arg(previousSha, currentSha, file));
+   QString runCmd = QString("git diff-tree --no-color -r --patch-with-stat -m -C ");
 
-   if (ret.success)
-      return ret.output.toString();
+   if (diffToSha.isEmpty())
+      runCmd += " --root ";
 
-   return QString();
+   runCmd.append(QString("%1 %2").arg(diffToSha, sha)); // diffToSha could be empty
+
+   return runCmd;
 }
 
-GitExecResult GitHistory::getDiffFiles(const QString &sha, const QString &diffToSha)
+QString GitHistory::getCommitDiffStatsCommand(const QString &sha, const QString &diffToSha) const
 {
-   QLog_Debug("Git", QString("Executing getDiffFiles: {%1} to {%2}").arg(sha, diffToSha));
+   if (sha == CommitInfo::ZERO_SHA)
+      return QString("git diff -M --numstat -z HEAD");
+
+   QString runCmd = QString("git diff-tree --no-commit-id -r -m -C --numstat -z ");
+
+   if (diffToSha.isEmpty())
+      runCmd += " --root ";
+
+   runCmd.append(QString("%1 %2").arg(diffToSha, sha)); // diffToSha could be empty
 
-   QString runCmd = QString("git diff-tree -C --no-color -r -m ");
+   return runCmd;
+}
 
-   if (!diffToSha.isEmpty() && sha != CommitInfo::ZERO_SHA)
-      runCmd.append(diffToSha + " " + sha);
+QString GitHistory::getCommitFileDiffCommand(const QString &sha, const QString &diffToSha,
+                                             const QStringList &files) const
+{
+   QString runCmd;
 
-   return mGitBase->run(runCmd);
+   if (sha == CommitInfo::ZERO_SHA)
+      runCmd = QString("git diff --no-color -M HEAD --");
+   else
+   {
+      runCmd = QString("git diff-tree --no-commit-id --no-color -r -m -C -p ");
+
+      if (diffToSha.isEmpty())
+         runCmd += " --root ";
+
+      runCmd.append(QString("%1 %2 --").arg(diffToSha, sha)); // diffToSha could be empty
+   }
+
+   for (const auto &file : files)
+      runCmd.append(QString(" $%1$").arg(file));
+
+   return runCmd;
+}
+
+QString GitHistory::getFileDiff(const QString &currentSha, const QString &previousSha, const QString &file,
+                                int contextLines)
+{
+   QLog_Debug("Git", QString("Executing getFileDiff: {%1} between {%2} and {%3}").arg(file, currentSha, previousSha));
+
+   const auto ret = mGitBase->run(
+       QString("git diff -U%1 %2 %3 %4").arg(QString::number(contextLines), previousSha, currentSha, file));
+
+   if (ret.success)
+      return ret.output.toString();
+
+   return QString();
 }
@@ -34,11 +34,14 @@ class GitHistory
 public:
    explicit GitHistory(const QSharedPointer<GitBase> &gitBase);
 
-   GitExecResult blame(const QString &file, const QString &commitFrom);
+   QString getBlameCommand(const QString &file, const QString &commitFrom) const;
    GitExecResult history(const QString &file);
    GitExecResult getCommitDiff(const QString &sha, const QString &diffToSha);
-   QString getFileDiff(const QString &currentSha, const QString &previousSha, const QString &file);
-   GitExecResult getDiffFiles(const QString &sha, const QString &diffToSha);
+   QString getCommitDiffCommand(const QString &sha, const QString &diffToSha) const;
+   QString getCommitDiffStatsCommand(const QString &sha, const QString &diffToSha) const;
+   QString getCommitFileDiffCommand(const QString &sha, const QString &diffToSha, const QStringList &files) const;
+   QString getFileDiff(const QString &currentSha, const QString &previousSha, const QString &file,
+                       int contextLines = 3);
 
 private:
    QSharedPointer<GitBase> mGitBase;
@@ -0,0 +1,109 @@
+#include "GitLogParser.h"
+
+#include <RevisionsDiskCache.h>
+
+#include <QLogger.h>
+
+using namespace QLogger;
+
+namespace
+{
+const auto DISK_CACHE_BATCH_SIZE = 5000;
+}
+
+GitLogParser::GitLogParser(QObject *parent)
+   : QObject(parent)
+{
+}
+
+void GitLogParser::reset(const QSharedPointer<RevisionsDiskCache> &diskCache)
+{
+   mPendingData.clear();
+   mValidHistory = true;
+   mDiskCache = diskCache;
+   mStringsPool.clear();
+}
+
+void GitLogParser::processChunk(const QByteArray &chunk)
+{
+   mPendingData.append(chunk);
+
+   const auto lastSeparator = mPendingData.lastIndexOf('\000');
+
+   if (lastSeparator == -1)
+      return;
+
+   QVector<CommitInfo> commits;
+   auto recordStart = 0;
+
+   while (recordStart <= lastSeparator)
+   {
+      const auto recordEnd = mPendingData.indexOf('\000', recordStart);
+
+      appendRevision(QByteArray::fromRawData(mPendingData.constData() + recordStart, recordEnd - recordStart), commits);
+
+      recordStart = recordEnd + 1;
+   }
+
+   mPendingData.remove(0, lastSeparator + 1);
+
+   if (!commits.isEmpty())
+      emit signalCommitsParsed(commits);
+}
+
+void GitLogParser::finish()
+{
+   // The last record of git log -z is not followed by the separator.
+   if (!mPendingData.isEmpty())
+   {
+      QVector<CommitInfo> commits;
+
+      appendRevision(mPendingData, commits);
+      mPendingData.clear();
+
+      if (!commits.isEmpty())
+         emit signalCommitsParsed(commits);
+   }
+
+   if (mDiskCache)
+   {
+      const auto ok = mDiskCache->read(
+          [this](const QVector<CommitInfo> &commits) { emit signalCommitsParsed(commits); }, DISK_CACHE_BATCH_SIZE,
+          &mStringsPool);
+
+      if (!ok)
+         QLog_Warning("Git", "The revisions disk cache could not be read completely.");
+
+      mDiskCache.reset();
+   }
+
+   mStringsPool.clear();
+
+   emit signalParsingFinished();
+}
+
+void GitLogParser::writeDiskCache(const QSharedPointer<RevisionsDiskCache> &diskCache,
+                                  const QStringList &previousTips, const QStringList &tips,
+                                  const QVector<CommitInfo> &commits)
+{
+   if (previousTips.isEmpty())
+      diskCache->write(tips, commits);
+   else if (!diskCache->writeOnTop(previousTips, tips, commits))
+      QLog_Warning("Git", "The new commits could not be stored in the revisions disk cache.");
+}
+
+void GitLogParser::appendRevision(const QByteArray &commitInfo, QVector<CommitInfo> &commits)
+{
+   if (!mValidHistory)
+      return;
+
+   CommitInfo revision(commitInfo);
+
+   if (revision.isValid())
+   {
+      revision.shareStrings(mStringsPool);
+      commits.append(std::move(revision));
+   }
+   else
+      mValidHistory = false;
+}
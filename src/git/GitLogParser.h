@@ -0,0 +1,100 @@
+#pragma once
+
+/****************************************************************************************
+ ** GitQlient is an application to manage and operate one or several Git repositories. With
+ ** GitQlient you will be able to add commits, branches and manage all the options Git provides.
+ ** Copyright (C) 2020  Francesc Martinez
+ **
+ ** LinkedIn: www.linkedin.com/in/cescmm/
+ ** Web: www.francescmm.com
+ **
+ ** This program is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public
+ ** License as published by the Free Software Foundation; either
+ ** version 2 of the License, or (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this library; if not, write to the Free Software
+ ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ***************************************************************************************/
+
+#include <CommitInfo.h>
+
+#include <QObject>
+#include <QSharedPointer>
+#include <QVector>
+
+class RevisionsDiskCache;
+
+/**
+ * @brief The GitLogParser class is the second stage of the repository loading pipeline. It lives in its own thread and
+ * receives the raw output of git log as it is produced by the process. It splits it into NUL-delimited records and
+ * builds the CommitInfo objects that are forwarded in batches to the LanesBuilder.
+ *
+ * @class GitLogParser GitLogParser.h "GitLogParser.h"
+ */
+class GitLogParser : public QObject
+{
+   Q_OBJECT
+
+signals:
+   /**
+    * @brief Signal triggered when all the complete records of a chunk have been parsed.
+    *
+    * @param commits The parsed commits in the same order git log produced them.
+    */
+   void signalCommitsParsed(const QVector<CommitInfo> &commits);
+   /**
+    * @brief Signal triggered when the last record has been parsed.
+    */
+   void signalParsingFinished();
+
+public:
+   explicit GitLogParser(QObject *parent = nullptr);
+
+   /**
+    * @brief Discards any data from a previous load.
+    *
+    * @param diskCache If set, the commits stored in the disk cache are appended after the ones git produces. They are
+    * older than any new commit so the topological order is kept.
+    */
+   void reset(const QSharedPointer<RevisionsDiskCache> &diskCache = QSharedPointer<RevisionsDiskCache>());
+   /**
+    * @brief Parses all the complete records of a chunk. The incomplete tail is kept until the next chunk arrives.
+    *
+    * @param chunk The raw data as it was read from the git process.
+    */
+   void processChunk(const QByteArray &chunk);
+   /**
+    * @brief Parses the remaining data once the git process has finished and reads the disk cache, if any.
+    */
+   void finish();
+   /**
+    * @brief Stores the commits in the disk cache.
+    *
+    * @param diskCache The disk cache where to write.
+    * @param previousTips If set, the commits are new and they are stored on top of the ones loaded from these tips.
+    * Otherwise they replace the content of the disk cache.
+    * @param tips The tips of the references that the commits belong to.
+    * @param commits The commits to store.
+    */
+   void writeDiskCache(const QSharedPointer<RevisionsDiskCache> &diskCache, const QStringList &previousTips,
+                       const QStringList &tips, const QVector<CommitInfo> &commits);
+   /**
+    * @brief Returns false if a record couldn't be parsed. The records after it are discarded.
+    */
+   bool isValidHistory() const { return mValidHistory; }
+
+private:
+   QByteArray mPendingData;
+   bool mValidHistory = true;
+   QSharedPointer<RevisionsDiskCache> mDiskCache;
+   CommitStringsPool mStringsPool;
+
+   void appendRevision(const QByteArray &commitInfo, QVector<CommitInfo> &commits);
+};
@@ -0,0 +1,168 @@
+#include "GitProcessPool.h"
+
+#include <GitAsyncProcess.h>
+#include <GitCommandTrace.h>
+
+#include <QLogger.h>
+
+#include <QCoreApplication>
+#include <QPointer>
+#include <QThread>
+
+using namespace QLogger;
+
+namespace
+{
+// One process for each priority.
+const auto MIN_PROCESSES = 3;
+const auto MAX_PROCESSES = 8;
+}
+
+GitProcessPool::GitProcessPool(QObject *parent)
+   : QObject(parent)
+   , mMaxProcesses(qBound(MIN_PROCESSES, QThread::idealThreadCount(), MAX_PROCESSES))
+   , mPendingTasks(static_cast<int>(GitFuture::Priority::Background) + 1)
+{
+}
+
+GitProcessPool *GitProcessPool::instance()
+{
+   static QPointer<GitProcessPool> pool;
+
+   // The application owns the pool, so no process outlives it.
+   if (!pool)
+   {
+      const auto app = QCoreApplication::instance();
+
+      pool = new GitProcessPool(app);
+
+      if (app)
+         connect(app, &QCoreApplication::aboutToQuit, pool, &GitProcessPool::shutdown);
+   }
+
+   return pool;
+}
+
+QSharedPointer<GitFuture> GitProcessPool::run(const QString &workingDir, const QString &command,
+                                              GitFuture::Priority priority, bool bufferOutput)
+{
+   QSharedPointer<GitFuture> future(new GitFuture(command, priority), &QObject::deleteLater);
+   const auto rawFuture = future.data();
+
+   if (mShutDown)
+   {
+      future->finish({ false, QString("The command {%1} was not executed.").arg(command) });
+      return future;
+   }
+
+   connect(rawFuture, &GitFuture::signalCancelRequested, this, [this, rawFuture]() { cancel(rawFuture); });
+
+   mPendingTasks[static_cast<int>(priority)].enqueue(
+       { workingDir, future, GitCommandTrace::currentSubsystem(), bufferOutput });
+
+   schedule();
+
+   return future;
+}
+
+void GitProcessPool::setMaxProcesses(int maxProcesses)
+{
+   mMaxProcesses = qMax(MIN_PROCESSES, maxProcesses);
+
+   schedule();
+}
+
+void GitProcessPool::shutdown()
+{
+   mShutDown = true;
+
+   for (auto &queue : mPendingTasks)
+   {
+      while (!queue.isEmpty())
+      {
+         const auto task = queue.dequeue();
+         task.future->finish({ false, QString("The command {%1} was not executed.").arg(task.future->command()) });
+      }
+   }
+
+   const auto processes = mRunningTasks.values();
+
+   for (const auto process : processes)
+      process->onCancel();
+}
+
+void GitProcessPool::schedule()
+{
+   if (mShutDown)
+      return;
+
+   for (auto i = 0; i < mPendingTasks.count(); ++i)
+   {
+      auto &queue = mPendingTasks[i];
+
+      while (!queue.isEmpty() && canStart(static_cast<GitFuture::Priority>(i)))
+         start(queue.dequeue());
+   }
+}
+
+bool GitProcessPool::canStart(GitFuture::Priority priority) const
+{
+   // Interactive can use all the processes, Normal all but one and Background all but two.
+   const auto limit = mMaxProcesses - static_cast<int>(priority);
+
+   return mRunningTasks.count() < limit;
+}
+
+void GitProcessPool::start(const Task &task)
+{
+   const auto future = task.future;
+   const auto process = new GitAsyncProcess(task.workingDir);
+   process->setSubsystem(task.subsystem);
+   process->setBufferOutput(task.bufferOutput);
+
+   mRunningTasks.insert(future.data(), process);
+
+   connect(process, &AGitProcess::procDataReady, future.data(), &GitFuture::signalOutputReady);
+   connect(process, &GitAsyncProcess::signalDataReady, future.data(), &GitFuture::finish);
+   // The process always deletes itself, even if it's cancelled or fails to start.
+   connect(process, &QObject::destroyed, this, [this, future]() {
+      mRunningTasks.remove(future.data());
+
+      if (!future->isFinished())
+      {
+         const auto reason = future->isCanceled() ? QString("cancelled") : QString("not executed");
+         future->finish({ false, QString("The command {%1} was %2.").arg(future->command(), reason) });
+      }
+
+      schedule();
+   });
+
+   if (!process->run(future->command()).success)
+      process->deleteLater();
+}
+
+void GitProcessPool::cancel(GitFuture *future)
+{
+   const auto process = mRunningTasks.value(future);
+
+   if (process)
+   {
+      QLog_Debug("Git", QString("Cancelling the command {%1}.").arg(future->command()));
+
+      process->onCancel();
+      return;
+   }
+
+   for (auto &queue : mPendingTasks)
+   {
+      for (auto i = 0; i < queue.count(); ++i)
+      {
+         if (queue.at(i).future.data() == future)
+         {
+            const auto task = queue.takeAt(i);
+            task.future->finish({ false, QString("The command {%1} was cancelled.").arg(future->command()) });
+            return;
+         }
+      }
+   }
+}
@@ -0,0 +1,92 @@
+#pragma once
+
+#pragma once
+
+/****************************************************************************************
+ ** GitQlient is an application to manage and operate one or several Git repositories. With
+ ** GitQlient you will be able to add commits, branches and manage all the options Git provides.
+ ** Copyright (C) 2020  Francesc Martinez
+ **
+ ** LinkedIn: www.linkedin.com/in/cescmm/
+ ** Web: www.francescmm.com
+ **
+ ** This program is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public
+ ** License as published by the Free Software Foundation; either
+ ** version 2 of the License, or (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this library; if not, write to the Free Software
+ ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ***************************************************************************************/
+
+#include <GitFuture.h>
+
+#include <QHash>
+#include <QObject>
+#include <QQueue>
+#include <QSharedPointer>
+#include <QVector>
+
+class AGitProcess;
+
+/**
+ * @brief The GitProcessPool class limits the number of git processes that run at the same time. The commands wait in
+ * one queue per priority and the most urgent one starts as soon as a process finishes. Every priority leaves one more
+ * process free than the one above it: the background work can't take the last two and the normal commands can't take
+ * the last one, so the interactive commands never wait behind the background work.
+ *
+ * The pool is shared by all the repositories and lives in the GUI thread. It belongs to the application and it's shut
+ * down when the application is about to quit: the pending commands fail and the running processes are killed.
+ *
+ * @class GitProcessPool GitProcessPool.h "GitProcessPool.h"
+ */
+class GitProcessPool : public QObject
+{
+   Q_OBJECT
+
+public:
+   static GitProcessPool *instance();
+
+   /**
+    * @brief Queues a command.
+    *
+    * @param workingDir The directory where the command runs.
+    * @param command The git command.
+    * @param priority The priority of the command.
+    * @param bufferOutput If false, the output is only delivered through GitFuture::signalOutputReady and the result
+    * doesn't include it. Meant for commands with large outputs that are processed while they are read.
+    * @return QSharedPointer<GitFuture> The handle to follow and cancel the command.
+    */
+   QSharedPointer<GitFuture> run(const QString &workingDir, const QString &command, GitFuture::Priority priority,
+                                 bool bufferOutput = true);
+
+   int maxProcesses() const { return mMaxProcesses; }
+   void setMaxProcesses(int maxProcesses);
+
+private:
+   struct Task
+   {
+      QString workingDir;
+      QSharedPointer<GitFuture> future;
+      const char *subsystem;
+      bool bufferOutput;
+   };
+
+   int mMaxProcesses;
+   QVector<QQueue<Task>> mPendingTasks;
+   QHash<GitFuture *, AGitProcess *> mRunningTasks;
+   bool mShutDown = false;
+
+   explicit GitProcessPool(QObject *parent = nullptr);
+   void shutdown();
+   void schedule();
+   bool canStart(GitFuture::Priority priority) const;
+   void start(const Task &task);
+   void cancel(GitFuture *future);
+};
@@ -1,13 +1,19 @@
 #include "GitRepoLoader.h"
 
 #include <GitBase.h>
+#include <GitCommandTrace.h>
 #include <RevisionsCache.h>
 #include <GitRequestorProcess.h>
-#include <GitBranches.h>
+#include <GitSyncProcess.h>
+#include <GitConfig.h>
+#include <GitLogParser.h>
+#include <LanesBuilder.h>
+#include <RevisionsDiskCache.h>
 
 #include <QLogger.h>
 
 #include <QDir>
+#include <QThread>
 
 using namespace QLogger;
 
@@ -20,8 +26,31 @@ GitRepoLoader::GitRepoLoader(QSharedPointer<GitBase> gitBase, QSharedPointer<Rev
 {
 }
 
+GitRepoLoader::~GitRepoLoader()
+{
+   if (mParserThread)
+   {
+      mParserThread->quit();
+      mParserThread->wait();
+   }
+
+   if (mLanesThread)
+   {
+      mLanesThread->quit();
+      mLanesThread->wait();
+   }
+
+   if (mDistancesThread)
+   {
+      mDistancesThread->quit();
+      mDistancesThread->wait();
+   }
+}
+
 bool GitRepoLoader::loadRepository()
 {
+   GitCommandTrace::Scope scope("Repository load");
+
    if (mLocked)
       QLog_Warning("Git", "Git is currently loading data.");
    else
@@ -54,6 +83,137 @@ bool GitRepoLoader::loadRepository()
    return false;
 }
 
+bool GitRepoLoader::refreshRepository()
+{
+   GitCommandTrace::Scope scope("Repository refresh");
+
+   if (mLocked)
+   {
+      QLog_Warning("Git", "Git is currently loading data.");
+      return false;
+   }
+
+   mGitBase->updateCurrentBranch();
+
+   const auto logMode = mShowAll ? QString("--all") : mGitBase->getCurrentBranch();
+
+   if (!mDiskCache || logMode != mLogMode)
+      return loadRepository();
+
+   QLog_Info("Git", "Refreshing the repository...");
+
+   const auto ret = mGitBase->getLastCommit();
+   const auto headSha = ret.success ? ret.output.toString().trimmed() : QString();
+   const auto tips = getReferencesTips(headSha);
+
+   if (tips != mReferencesTips)
+   {
+      if (!canLoadIncrementally(mReferencesTips, logMode))
+         return loadRepository();
+
+      requestNewRevisions(headSha, tips, logMode);
+
+      return true;
+   }
+
+   finishRefresh();
+
+   return true;
+}
+
+void GitRepoLoader::requestNewRevisions(const QString &headSha, const QStringList &tips, const QString &logMode)
+{
+   QLog_Debug("Git", "Loading the new revisions.");
+
+   mLocked = true;
+   mNewRevisions.clear();
+
+   // The new commits are usually a few, so they are parsed in the GUI thread while git log produces them.
+   if (!mNewRevisionsParser)
+   {
+      mNewRevisionsParser = new GitLogParser(this);
+      connect(mNewRevisionsParser, &GitLogParser::signalCommitsParsed, this,
+              [this](const QVector<CommitInfo> &commits) { mNewRevisions.append(commits); });
+   }
+
+   mNewRevisionsParser->reset();
+
+   const auto cmd = QString("git log --date-order --no-color --log-size --parents -z --pretty=format:%1%2 --not %3")
+                        .arg(GIT_LOG_FORMAT, logMode, mReferencesTips.join(' '));
+
+   const auto requestor = new GitRequestorProcess(mGitBase->getWorkingDir());
+   mNewRevisionsRequestor = requestor;
+
+   connect(requestor, &GitRequestorProcess::procDataReady, mNewRevisionsParser, &GitLogParser::processChunk);
+   connect(requestor, &GitRequestorProcess::signalProcessFinished, this, [this, requestor, headSha, tips]() {
+      const auto success = requestor->exitStatus() == QProcess::NormalExit && requestor->exitCode() == 0;
+
+      mNewRevisionsRequestor = nullptr;
+      mNewRevisionsParser->finish();
+
+      onNewRevisionsLoaded(success && mNewRevisionsParser->isValidHistory(), headSha, tips);
+   });
+   // A cancelled git log doesn't finish: the loaded history and its tips stay as they were.
+   connect(requestor, &QObject::destroyed, this, [this, requestor]() {
+      if (mNewRevisionsRequestor == requestor)
+      {
+         mNewRevisionsRequestor = nullptr;
+         mLocked = false;
+         mNewRevisions.clear();
+      }
+   });
+   connect(this, &GitRepoLoader::cancelAllProcesses, requestor, &AGitProcess::onCancel);
+
+   if (!requestor->run(cmd).success)
+      requestor->deleteLater();
+}
+
+void GitRepoLoader::onNewRevisionsLoaded(bool success, const QString &headSha, const QStringList &tips)
+{
+   mLocked = false;
+
+   const auto newCommits = std::move(mNewRevisions);
+   mNewRevisions.clear();
+
+   if (!success)
+   {
+      QLog_Warning("Git", "The new revisions couldn't be loaded, loading the whole repository.");
+      loadRepository();
+      return;
+   }
+
+   const auto updatedCommits = mRevCache->insertCommitsOnTop(newCommits, headSha);
+
+   if (updatedCommits == -1)
+   {
+      loadRepository();
+      return;
+   }
+
+   // The tips only move once all the new commits are in the cache, so the disk cache never misses any of them.
+   const auto previousTips = mReferencesTips;
+   mReferencesTips = tips;
+
+   writeDiskCache(previousTips, newCommits.count());
+
+   emit signalRevisionsInserted(newCommits.count(), updatedCommits);
+
+   finishRefresh();
+}
+
+void GitRepoLoader::finishRefresh()
+{
+   updateWipRevision();
+
+   mRevCache->clearReferences();
+
+   loadReferences();
+
+   QLog_Info("Git", "... repository refreshed");
+
+   emit signalLoadingFinished();
+}
+
 bool GitRepoLoader::configureRepoDirectory()
 {
    QLog_Debug("Git", "Configuring repository directory.");
@@ -87,6 +247,8 @@ void GitRepoLoader::loadReferences()
       QString prevRefSha;
       const auto curBranchSHA = ret.output.toString();
       const auto referencesList = ret3.output.toString().split('\n', QString::SkipEmptyParts);
+      QVector<QPair<QString, QString>> localBranchesTips;
+      QHash<QString, QString> remoteBranchesTips;
 
       for (const auto &reference : referencesList)
       {
@@ -122,127 +284,449 @@ void GitRepoLoader::loadReferences()
             mRevCache->insertReference(revSha, type, name);
 
             if (localBranches)
-            {
-               const auto git = new GitBranches(mGitBase);
-               RevisionsCache::LocalBranchDistances distances;
-
-               const auto distToMaster = git->getDistanceBetweenBranches(true, name);
-               auto toMaster = distToMaster.output.toString();
-
-               if (!toMaster.contains("fatal"))
-               {
-                  toMaster.replace('\n', "");
-                  const auto values = toMaster.split('\t');
-                  distances.behindMaster = values.first().toUInt();
-                  distances.aheadMaster = values.last().toUInt();
-               }
-
-               const auto distToOrigin = git->getDistanceBetweenBranches(false, name);
-               auto toOrigin = distToOrigin.output.toString();
-
-               if (!toOrigin.contains("fatal"))
-               {
-                  toOrigin.replace('\n', "");
-                  const auto values = toOrigin.split('\t');
-                  distances.behindOrigin = values.first().toUInt();
-                  distances.aheadOrigin = values.last().toUInt();
-               }
-
-               mRevCache->insertLocalBranchDistances(name, distances);
-            }
+               localBranchesTips.append(qMakePair(name, revSha));
+            else if (type == References::Type::RemoteBranches)
+               remoteBranchesTips.insert(name, revSha);
          }
 
          prevRefSha = revSha;
       }
+
+      calculateBranchDistances(localBranchesTips, remoteBranchesTips);
    }
 }
 
+void GitRepoLoader::calculateBranchDistances(const QVector<QPair<QString, QString>> &localBranchesTips,
+                                             const QHash<QString, QString> &remoteBranchesTips)
+{
+   GitCommandTrace::Scope scope("Branch distances");
+
+   ++mDistancesGeneration;
+
+   // The remote of every branch is read once instead of asking git for every branch.
+   QHash<QString, QString> remotes;
+   const auto config = GitConfig(mGitBase).getLocalConfig();
+
+   if (config.success)
+   {
+      for (const auto &line : config.output.toString().split('\n', QString::SkipEmptyParts))
+      {
+         const auto remoteKey = line.indexOf(".remote=");
+
+         if (line.startsWith("branch.") && remoteKey != -1)
+            remotes.insert(line.mid(7, remoteKey - 7), line.mid(remoteKey + 8));
+      }
+   }
+
+   const auto masterRemote = remotes.value("master");
+   const auto masterRef = masterRemote.isEmpty() ? QString() : QString("%1/master").arg(masterRemote);
+   const auto masterSha = remoteBranchesTips.value(masterRef);
+   const auto masterRow = masterSha.isEmpty() ? -1 : mRevCache->getCommitPos(masterSha);
+   QVector<BranchDistancesCalculator::Request> requests;
+
+   for (const auto &branchTip : localBranchesTips)
+   {
+      const auto &branch = branchTip.first;
+      const auto remote = remotes.value(branch);
+      const auto upstreamRef = remote.isEmpty() ? QString() : QString("%1/%2").arg(remote, branch);
+      const auto upstreamSha = remoteBranchesTips.value(upstreamRef);
+
+      BranchDistancesCalculator::Request request;
+      request.branch = branch;
+      request.localRow = mRevCache->getCommitPos(branchTip.second);
+      request.masterRow = masterRow;
+      request.upstreamRow = upstreamSha.isEmpty() ? -1 : mRevCache->getCommitPos(upstreamSha);
+
+      // When only the current branch is loaded, the graph doesn't have the other tips and git needs to be asked.
+      if (!masterSha.isEmpty() && (request.localRow == -1 || masterRow == -1))
+      {
+         request.masterRow = -1;
+         requestBranchDistance(branch, masterRef, true);
+      }
+
+      if (!upstreamSha.isEmpty() && (request.localRow == -1 || request.upstreamRow == -1))
+      {
+         request.upstreamRow = -1;
+         requestBranchDistance(branch, upstreamRef, false);
+      }
+
+      requests.append(request);
+   }
+
+   if (!mDistancesCalculator)
+      return;
+
+   const auto calculator = mDistancesCalculator;
+   const auto generation = mDistancesGeneration;
+   const auto graph = mRevCache->commitGraph();
+
+   QMetaObject::invokeMethod(
+       calculator, [calculator, generation, graph, requests]() { calculator->calculate(generation, graph, requests); },
+       Qt::QueuedConnection);
+}
+
+void GitRepoLoader::requestBranchDistance(const QString &branch, const QString &otherRef, bool toMaster)
+{
+   GitCommandTrace::Scope scope("Branch distances");
+
+   const auto generation = mDistancesGeneration;
+   const auto future = mGitBase->runAsync(QString("git rev-list --left-right --count %1...%2").arg(otherRef, branch),
+                                          GitFuture::Priority::Background);
+   connect(this, &GitRepoLoader::cancelAllProcesses, future.data(), &GitFuture::cancel);
+
+   future->then(this, [this, generation, branch, toMaster](const GitExecResult &result) {
+      const auto values = result.output.toString().trimmed().split('\t');
+
+      if (generation != mDistancesGeneration || !result.success || values.count() != 2)
+         return;
+
+      BranchDistancesCalculator::Result distances;
+      distances.branch = branch;
+      distances.hasMaster = toMaster;
+      distances.hasUpstream = !toMaster;
+
+      if (toMaster)
+      {
+         distances.distances.behindMaster = values.first().toInt();
+         distances.distances.aheadMaster = values.last().toInt();
+      }
+      else
+      {
+         distances.distances.behindOrigin = values.first().toInt();
+         distances.distances.aheadOrigin = values.last().toInt();
+      }
+
+      onBranchDistancesCalculated(generation, { distances });
+   });
+}
+
+void GitRepoLoader::onBranchDistancesCalculated(int generation,
+                                                const QVector<BranchDistancesCalculator::Result> &results)
+{
+   if (generation != mDistancesGeneration)
+      return;
+
+   for (const auto &result : results)
+   {
+      auto distances = mRevCache->getLocalBranchDistances(result.branch);
+
+      if (result.hasMaster)
+      {
+         distances.aheadMaster = result.distances.aheadMaster;
+         distances.behindMaster = result.distances.behindMaster;
+      }
+
+      if (result.hasUpstream)
+      {
+         distances.aheadOrigin = result.distances.aheadOrigin;
+         distances.behindOrigin = result.distances.behindOrigin;
+      }
+
+      mRevCache->insertLocalBranchDistances(result.branch, distances);
+   }
+
+   emit signalBranchDistancesUpdated();
+}
+
 void GitRepoLoader::requestRevisions()
 {
    QLog_Debug("Git", "Loading revisions.");
 
-   const auto baseCmd = QString("git log --date-order --no-color --log-size --parents --boundary -z --pretty=format:")
-                            .append(GIT_LOG_FORMAT)
-                            .append(mShowAll ? QString("--all") : mGitBase->getCurrentBranch());
+   // The first row is always reserved for the WIP commit.
+   mLoadedCommits = 1;
+   mLastNotifiedCommits = 0;
+
+   mRevCache->configure(0);
+
+   QLog_Debug("Git", QString("Adding the WIP commit."));
+
+   updateWipRevision();
+
+   const auto wipParentSha = mRevCache->getCommitInfo(CommitInfo::ZERO_SHA).parent(0);
+   const auto logMode = mShowAll ? QString("--all") : mGitBase->getCurrentBranch();
+
+   mLogMode = logMode;
+   mDiskCache.reset(new RevisionsDiskCache(mGitBase->getWorkingDir(), logMode));
+   mReferencesTips = getReferencesTips(wipParentSha);
+
+   const auto cachedTips = mDiskCache->getTips();
+
+   mDiskCacheUpToDate = !cachedTips.isEmpty() && cachedTips == mReferencesTips;
+
+   const auto incremental
+       = mDiskCacheUpToDate || (!cachedTips.isEmpty() && canLoadIncrementally(cachedTips, logMode));
+
+   // Git only lists the commits that are not in the disk cache, so those are the only ones to store later.
+   mDiskCacheTips = incremental ? cachedTips : QStringList();
+   mDiskCacheCommits = incremental ? mDiskCache->commitsCount() : 0;
+
+   createLoadingPipeline();
+
+   // The reset is queued so it's processed before any chunk of the new load.
+   const auto parser = mLogParser;
+   const auto lanesBuilder = mLanesBuilder;
+   const auto diskCache = incremental ? mDiskCache : QSharedPointer<RevisionsDiskCache>();
+   const auto wipParentId = ObjectId(wipParentSha);
+
+   mRevCache->setLanesWipParent(wipParentId);
+
+   QMetaObject::invokeMethod(parser, [parser, diskCache]() { parser->reset(diskCache); }, Qt::QueuedConnection);
+   QMetaObject::invokeMethod(
+       lanesBuilder, [lanesBuilder, wipParentId]() { lanesBuilder->reset(wipParentId); }, Qt::QueuedConnection);
+
+   if (mDiskCacheUpToDate)
+   {
+      QLog_Debug("Git", "The references didn't change, loading the revisions from the disk cache.");
+
+      QMetaObject::invokeMethod(parser, &GitLogParser::finish, Qt::QueuedConnection);
+      return;
+   }
+
+   auto baseCmd = QString("git log --date-order --no-color --log-size --parents %1 -z --pretty=format:")
+                      .arg(incremental ? QString() : QString("--boundary"))
+                      .append(GIT_LOG_FORMAT)
+                      .append(logMode);
+
+   if (incremental)
+   {
+      QLog_Debug("Git", "Loading from git only the revisions that are not in the disk cache.");
+
+      baseCmd.append(QString(" --not %1").arg(cachedTips.join(' ')));
+   }
 
    const auto requestor = new GitRequestorProcess(mGitBase->getWorkingDir());
-   connect(requestor, &GitRequestorProcess::procDataReady, this, &GitRepoLoader::processRevision);
+   connect(requestor, &GitRequestorProcess::procDataReady, mLogParser, &GitLogParser::processChunk);
+   connect(requestor, &GitRequestorProcess::signalProcessFinished, mLogParser, &GitLogParser::finish);
    connect(this, &GitRepoLoader::cancelAllProcesses, requestor, &AGitProcess::onCancel);
 
    requestor->run(baseCmd);
 }
 
-void GitRepoLoader::processRevision(const QByteArray &ba)
+QStringList GitRepoLoader::getReferencesTips(const QString &headSha) const
 {
-   QLog_Debug("Git", "Processing revisions...");
+   QStringList tips;
 
-   const auto commits = ba.split('\000');
-   const auto totalCommits = commits.count();
-   auto count = 1;
+   if (!headSha.isEmpty())
+      tips.append(headSha);
 
-   QLog_Debug("Git", QString("There are {%1} commits to process.").arg(totalCommits));
+   if (mShowAll)
+   {
+      const auto ret = mGitBase->run("git show-ref -s");
 
-   mRevCache->configure(totalCommits);
+      if (ret.success)
+         tips.append(ret.output.toString().split('\n', QString::SkipEmptyParts));
+   }
 
-   emit signalLoadingStarted(totalCommits);
+   tips.removeDuplicates();
+   tips.sort();
 
-   QLog_Debug("Git", QString("Adding the WIP commit."));
+   return tips;
+}
 
-   updateWipRevision();
+bool GitRepoLoader::canLoadIncrementally(const QStringList &cachedTips, const QString &logMode) const
+{
+   static const auto MAX_TIPS_LENGTH = 30000;
 
-   for (const auto &commitInfo : commits)
-   {
-      CommitInfo revision(commitInfo);
+   if (cachedTips.join(' ').length() > MAX_TIPS_LENGTH)
+      return false;
 
-      if (revision.isValid())
-         mRevCache->insertCommitInfo(std::move(revision), count);
-      else
-         break;
+   // All the cached commits must be still reachable, otherwise a reference was removed or rewritten.
+   const auto ret = mGitBase->run(QString("git rev-list --count %1 --not %2").arg(cachedTips.join(' '), logMode));
 
-      emit signalLoadingStep(count++);
-   }
+   return ret.success && ret.output.toString().trimmed() == "0";
+}
+
+void GitRepoLoader::createLoadingPipeline()
+{
+   if (mParserThread)
+      return;
+
+   // The reading is done by the git process in the GUI thread, the parsing and the lanes calculation is done in two
+   // different threads and the results are stored in the cache back in the GUI thread.
+   qRegisterMetaType<QVector<CommitInfo>>("QVector<CommitInfo>");
+   qRegisterMetaType<Lanes>("Lanes");
+   qRegisterMetaType<QVector<BranchDistancesCalculator::Result>>("QVector<BranchDistancesCalculator::Result>");
+
+   mParserThread = new QThread(this);
+   mLanesThread = new QThread(this);
+   mDistancesThread = new QThread(this);
+
+   mLogParser = new GitLogParser();
+   mLogParser->moveToThread(mParserThread);
+   connect(mParserThread, &QThread::finished, mLogParser, &QObject::deleteLater);
+
+   mLanesBuilder = new LanesBuilder();
+   mLanesBuilder->moveToThread(mLanesThread);
+   connect(mLanesThread, &QThread::finished, mLanesBuilder, &QObject::deleteLater);
+
+   mDistancesCalculator = new BranchDistancesCalculator();
+   mDistancesCalculator->moveToThread(mDistancesThread);
+   connect(mDistancesThread, &QThread::finished, mDistancesCalculator, &QObject::deleteLater);
+
+   connect(mLogParser, &GitLogParser::signalCommitsParsed, mLanesBuilder, &LanesBuilder::calculateLanes);
+   connect(mLogParser, &GitLogParser::signalParsingFinished, mLanesBuilder, &LanesBuilder::finish);
+   connect(mLanesBuilder, &LanesBuilder::signalLanesCheckpoint, mRevCache.get(),
+           &RevisionsCache::insertLanesCheckpoint);
+   connect(mLanesBuilder, &LanesBuilder::signalLanesReady, this, &GitRepoLoader::insertRevisions);
+   connect(mLanesBuilder, &LanesBuilder::signalFinished, this, &GitRepoLoader::onRevisionsLoaded);
+   connect(mDistancesCalculator, &BranchDistancesCalculator::signalDistancesCalculated, this,
+           &GitRepoLoader::onBranchDistancesCalculated);
+
+   mParserThread->start();
+   mLanesThread->start();
+   mDistancesThread->start();
+}
+
+void GitRepoLoader::insertRevisions(const QVector<CommitInfo> &commits)
+{
+   for (const auto &commit : commits)
+      mRevCache->insertCommitInfo(commit, mLoadedCommits++);
+
+   notifyLoadedCommits(false);
+}
+
+void GitRepoLoader::onRevisionsLoaded()
+{
+   QLog_Debug("Git", QString("There are {%1} commits loaded.").arg(mLoadedCommits));
+
+   mRevCache->truncate(mLoadedCommits);
+
+   notifyLoadedCommits(true);
 
    mLocked = false;
 
+   if (!mDiskCacheUpToDate)
+      writeDiskCache(mDiskCacheTips, mLoadedCommits - 1 - mDiskCacheCommits);
+
    loadReferences();
 
    emit signalLoadingFinished();
 }
 
+void GitRepoLoader::writeDiskCache(const QStringList &previousTips, int newCommits)
+{
+   // When only a few commits are new, they are stored on top of the ones in the disk cache without rewriting them.
+   const auto onTop = !previousTips.isEmpty() && newCommits >= 0 && mDiskCache->canWriteOnTop(newCommits);
+   const auto commitsCount = onTop ? newCommits : mRevCache->count() - 1;
+
+   QVector<CommitInfo> commits;
+   commits.reserve(commitsCount);
+
+   // The WIP is not stored since it's calculated in every load, neither are the lanes.
+   for (auto i = 1; i <= commitsCount; ++i)
+      commits.append(mRevCache->getCommitInfoByRowWithoutLanes(i));
+
+   const auto parser = mLogParser;
+   const auto diskCache = mDiskCache;
+   const auto storedTips = onTop ? previousTips : QStringList();
+   const auto tips = mReferencesTips;
+
+   QMetaObject::invokeMethod(
+       parser,
+       [parser, diskCache, storedTips, tips, commits]() {
+          parser->writeDiskCache(diskCache, storedTips, tips, commits);
+       },
+       Qt::QueuedConnection);
+}
+
+void GitRepoLoader::notifyLoadedCommits(bool force)
+{
+   static const auto BATCH_SIZE = 5000;
+
+   if (mLoadedCommits == mLastNotifiedCommits)
+      return;
+
+   if (mLastNotifiedCommits == 0)
+      emit signalLoadingStarted(mLoadedCommits);
+   else if (force || mLoadedCommits - mLastNotifiedCommits >= BATCH_SIZE)
+      emit signalLoadingStep(mLoadedCommits);
+   else
+      return;
+
+   mLastNotifiedCommits = mLoadedCommits;
+}
+
 void GitRepoLoader::updateWipRevision()
 {
    QLog_Debug("Git", QString("Executing updateWipRevision."));
 
-   mRevCache->setUntrackedFilesList(getUntrackedFiles());
+   GitCommandTrace::Scope scope("WIP status");
 
-   const auto ret = mGitBase->run("git rev-parse --revs-only HEAD");
+   // The output is full of NULs, so it's parsed from the raw chunks: the QString result stops at the first one.
+   GitStatusParser parser;
+   GitSyncProcess process(mGitBase->getWorkingDir());
+   process.setBufferOutput(false);
 
-   if (ret.success)
-   {
-      const auto parentSha = ret.output.toString().trimmed();
+   connect(&process, &AGitProcess::procDataReady, &process,
+           [&parser](const QByteArray &chunk) { parser.processChunk(chunk); });
+   connect(this, &GitRepoLoader::cancelAllProcesses, &process, &AGitProcess::onCancel);
 
-      const auto ret3 = mGitBase->run(QString("git diff-index %1").arg(parentSha));
-      const auto diffIndex = ret3.success ? ret3.output.toString() : QString();
+   if (process.run(GitStatusParser::COMMAND).success)
+   {
+      parser.finish();
 
-      const auto ret4 = mGitBase->run(QString("git diff-index --cached %1").arg(parentSha));
-      const auto diffIndexCached = ret4.success ? ret4.output.toString() : QString();
+      applyWipStatus(parser);
+   }
+   else
+      QLog_Warning("Git", "The status of the working directory couldn't be read.");
+}
 
-      mRevCache->updateWipCommit(parentSha, diffIndex, diffIndexCached);
+void GitRepoLoader::updateWipRevisionAsync()
+{
+   if (mWipStatusRunning)
+   {
+      mWipStatusPending = true;
+      return;
    }
+
+   GitCommandTrace::Scope scope("WIP status");
+
+   QLog_Debug("Git", QString("Executing updateWipRevisionAsync."));
+
+   mWipStatusRunning = true;
+   mStatusParser.reset();
+
+   const auto future = mGitBase->runAsync(GitStatusParser::COMMAND, GitFuture::Priority::Normal, false);
+   connect(future.data(), &GitFuture::signalOutputReady, this,
+           [this](const QByteArray &chunk) { mStatusParser.processChunk(chunk); });
+   connect(this, &GitRepoLoader::cancelAllProcesses, future.data(), &GitFuture::cancel);
+
+   // The future always finishes, also when it's cancelled or git can't be executed.
+   future->then(this, [this](const GitExecResult &result) {
+      if (result.success)
+      {
+         mStatusParser.finish();
+         applyWipStatus(mStatusParser);
+
+         emit signalWipRevisionUpdated();
+      }
+
+      onWipStatusFinished();
+   });
 }
 
-QVector<QString> GitRepoLoader::getUntrackedFiles() const
+void GitRepoLoader::cancelAll()
 {
-   QLog_Debug("Git", QString("Executing getUntrackedFiles."));
+   mWipStatusPending = false;
 
-   auto runCmd = QString("git ls-files --others");
-   const auto exFile = QString(".git/info/exclude");
-   const auto path = QString("%1/%2").arg(mGitBase->getWorkingDir(), exFile);
+   emit cancelAllProcesses(QPrivateSignal());
+}
 
-   if (QFile::exists(path))
-      runCmd.append(QString(" --exclude-from=$%1$").arg(exFile));
+void GitRepoLoader::applyWipStatus(const GitStatusParser &parser)
+{
+   const auto headSha = parser.headSha();
+
+   if (!headSha.isEmpty())
+      mRevCache->updateWipCommit(headSha, parser.files(), parser.untrackedFiles());
+}
 
-   runCmd.append(QString(" --exclude-per-directory=$%1$").arg(".gitignore"));
+void GitRepoLoader::onWipStatusFinished()
+{
+   mWipStatusRunning = false;
 
-   return mGitBase->run(runCmd).output.toString().split('\n', QString::SkipEmptyParts).toVector();
+   if (mWipStatusPending)
+   {
+      mWipStatusPending = false;
+      updateWipRevisionAsync();
+   }
 }
@@ -23,30 +23,79 @@
  ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
  ***************************************************************************************/
 
+#include <BranchDistancesCalculator.h>
 #include <GitExecResult.h>
+#include <GitStatusParser.h>
 
+#include <QHash>
 #include <QObject>
 #include <QSharedPointer>
 #include <QVector>
 
 class GitBase;
 class RevisionsCache;
+class GitLogParser;
+class GitRequestorProcess;
+class LanesBuilder;
+class CommitInfo;
+class RevisionsDiskCache;
+class QThread;
 
 class GitRepoLoader : public QObject
 {
    Q_OBJECT
 
 signals:
-   void signalLoadingStarted(int total);
-   void signalLoadingStep(int value);
+   /**
+    * @brief Signal triggered when the first batch of commits (including the WIP) is available in the cache.
+    * @param loadedCommits The number of rows already loaded.
+    */
+   void signalLoadingStarted(int loadedCommits);
+   /**
+    * @brief Signal triggered every time a new batch of commits has been added to the cache.
+    * @param loadedCommits The total number of rows loaded so far.
+    */
+   void signalLoadingStep(int loadedCommits);
    void signalLoadingFinished();
+   /**
+    * @brief Signal triggered when new commits have been added on top of the already loaded ones.
+    * @param insertedCommits The number of new commits, inserted after the WIP.
+    * @param updatedCommits The number of commits below the new ones whose lanes changed.
+    */
+   void signalRevisionsInserted(int insertedCommits, int updatedCommits);
+   /**
+    * @brief Signal triggered when the WIP commit has been updated by @ref updateWipRevisionAsync.
+    */
+   void signalWipRevisionUpdated();
+   /**
+    * @brief Signal triggered every time the distances of some local branches have been calculated.
+    */
+   void signalBranchDistancesUpdated();
    void cancelAllProcesses(QPrivateSignal);
 
 public:
    explicit GitRepoLoader(QSharedPointer<GitBase> gitBase, QSharedPointer<RevisionsCache> cache,
                           QObject *parent = nullptr);
+   ~GitRepoLoader();
    bool loadRepository();
+   /**
+    * @brief Adds the new commits on top of the loaded ones, or loads the whole repository if that's not possible. The
+    * new commits are loaded without blocking and @ref signalLoadingFinished is emitted once the refresh is done.
+    *
+    * @return bool True if the refresh or the load started.
+    */
+   bool refreshRepository();
+   /**
+    * @brief Updates the WIP commit and its files in the cache. The method blocks until git status has finished so the
+    * cache can be read right after it.
+    */
    void updateWipRevision();
+   /**
+    * @brief Updates the WIP commit without blocking. The output of git status is parsed while it is read and @ref
+    * signalWipRevisionUpdated is emitted once the cache is updated. Requests that arrive while one is running are
+    * coalesced into a single new run.
+    */
+   void updateWipRevisionAsync();
    void cancelAll();
    void setShowAll(bool showAll = true) { mShowAll = showAll; }
    bool showsAll() const { return mShowAll; }
@@ -56,10 +105,52 @@ private:
    bool mLocked = false;
    QSharedPointer<GitBase> mGitBase;
    QSharedPointer<RevisionsCache> mRevCache;
+   QThread *mParserThread = nullptr;
+   QThread *mLanesThread = nullptr;
+   QThread *mDistancesThread = nullptr;
+   GitLogParser *mLogParser = nullptr;
+   LanesBuilder *mLanesBuilder = nullptr;
+   BranchDistancesCalculator *mDistancesCalculator = nullptr;
+   int mDistancesGeneration = 0;
+   int mLoadedCommits = 0;
+   int mLastNotifiedCommits = 0;
+   QSharedPointer<RevisionsDiskCache> mDiskCache;
+   QStringList mReferencesTips;
+   QString mLogMode;
+   bool mDiskCacheUpToDate = false;
+   QStringList mDiskCacheTips;
+   int mDiskCacheCommits = 0;
+   GitLogParser *mNewRevisionsParser = nullptr;
+   GitRequestorProcess *mNewRevisionsRequestor = nullptr;
+   QVector<CommitInfo> mNewRevisions;
+   GitStatusParser mStatusParser;
+   bool mWipStatusRunning = false;
+   bool mWipStatusPending = false;
 
    bool configureRepoDirectory();
    void loadReferences();
+   void calculateBranchDistances(const QVector<QPair<QString, QString>> &localBranchesTips,
+                                 const QHash<QString, QString> &remoteBranchesTips);
+   void requestBranchDistance(const QString &branch, const QString &otherRef, bool toMaster);
+   void onBranchDistancesCalculated(int generation, const QVector<BranchDistancesCalculator::Result> &results);
    void requestRevisions();
-   void processRevision(const QByteArray &ba);
-   QVector<QString> getUntrackedFiles() const;
+   /**
+    * @brief Loads with git log the commits that are not reachable from the current tips and inserts them on top of the
+    * loaded ones once all of them are parsed.
+    */
+   void requestNewRevisions(const QString &headSha, const QStringList &tips, const QString &logMode);
+   void onNewRevisionsLoaded(bool success, const QString &headSha, const QStringList &tips);
+   /**
+    * @brief Updates the WIP and the references once the history is up to date.
+    */
+   void finishRefresh();
+   void createLoadingPipeline();
+   QStringList getReferencesTips(const QString &headSha) const;
+   bool canLoadIncrementally(const QStringList &cachedTips, const QString &logMode) const;
+   void writeDiskCache(const QStringList &previousTips = QStringList(), int newCommits = -1);
+   void insertRevisions(const QVector<CommitInfo> &commits);
+   void onRevisionsLoaded();
+   void notifyLoadedCommits(bool force);
+   void applyWipStatus(const GitStatusParser &parser);
+   void onWipStatusFinished();
 };
@@ -0,0 +1,383 @@
+#include "GitRepoWatcher.h"
+
+#include <GitBase.h>
+#include <GitCommandTrace.h>
+
+#include <QLogger.h>
+
+#include <QDateTime>
+#include <QDir>
+#include <QDirIterator>
+#include <QFileInfo>
+#include <QFileSystemWatcher>
+
+using namespace QLogger;
+
+namespace
+{
+const auto DEBOUNCE_MS = 300;
+const auto MAX_DELAY_MS = 2000;
+const auto CHECK_IGNORE_BATCH_SIZE = 200;
+
+qint64 lastModified(const QString &file)
+{
+   const QFileInfo info(file);
+
+   return info.exists() ? info.lastModified().toMSecsSinceEpoch() : -1;
+}
+}
+
+GitRepoWatcher::GitRepoWatcher(const QSharedPointer<GitBase> &git, QObject *parent)
+   : QObject(parent)
+   , mGit(git)
+   , mWatcher(new QFileSystemWatcher(this))
+{
+   mDebounceTimer.setSingleShot(true);
+   mDebounceTimer.setInterval(DEBOUNCE_MS);
+
+   connect(&mDebounceTimer, &QTimer::timeout, this, &GitRepoWatcher::notifyChanges);
+   connect(mWatcher, &QFileSystemWatcher::directoryChanged, this, &GitRepoWatcher::onDirectoryChanged);
+}
+
+void GitRepoWatcher::start()
+{
+   GitCommandTrace::Scope scope("Watcher");
+
+   stop();
+
+   mWorkingDir = mGit->getWorkingDir();
+
+   const auto ret = mGit->run("git rev-parse --git-dir --git-common-dir");
+   const auto gitDirs = ret.success ? ret.output.toString().split('\n', QString::SkipEmptyParts) : QStringList();
+
+   if (gitDirs.isEmpty())
+   {
+      QLog_Warning("Git", QString("Unable to find the git directory of {%1}. The repository is not watched.")
+                              .arg(mWorkingDir));
+      return;
+   }
+
+   const QDir workingDir(mWorkingDir);
+
+   mGitDir = QDir::cleanPath(workingDir.absoluteFilePath(gitDirs.first().trimmed()));
+
+   // Git versions older than 2.5 don't know the option and just print it back.
+   const auto hasCommonDir = gitDirs.count() > 1 && !gitDirs.at(1).startsWith("--");
+   mCommonDir = hasCommonDir ? QDir::cleanPath(workingDir.absoluteFilePath(gitDirs.at(1).trimmed())) : mGitDir;
+
+   watchReferences();
+   watchWorkingTree();
+
+   // The working tree directories are added as git lists them.
+   QLog_Info("Git", QString("Watching the repository {%1}.").arg(mWorkingDir));
+}
+
+void GitRepoWatcher::stop()
+{
+   // The commands of the previous repository are discarded even if they already finished.
+   ++mGeneration;
+   mPendingDirectories.clear();
+
+   for (const auto &future : { mListFuture, mCheckIgnoreFuture })
+   {
+      if (future)
+         future->cancel();
+   }
+
+   mListFuture.reset();
+   mCheckIgnoreFuture.reset();
+
+   mDebounceTimer.stop();
+   mPendingChanges = 0;
+   mChangedDirectories.clear();
+   mGitFilesModified.clear();
+
+   const auto directories = mWatcher->directories();
+
+   if (!directories.isEmpty())
+      mWatcher->removePaths(directories);
+}
+
+void GitRepoWatcher::watchReferences()
+{
+   // Git replaces these files instead of writing them, so their directories are watched instead of the files.
+   for (const auto &file : { mGitDir + "/HEAD", mGitDir + "/index", mCommonDir + "/packed-refs" })
+      mGitFilesModified.insert(file, lastModified(file));
+
+   QStringList paths { mGitDir };
+
+   if (mCommonDir != mGitDir)
+      paths.append(mCommonDir);
+
+   const auto refsDir = mCommonDir + "/refs";
+   paths.append(refsDir);
+
+   QDirIterator it(refsDir, QDir::Dirs | QDir::NoDotAndDotDot, QDirIterator::Subdirectories);
+
+   while (it.hasNext())
+      paths.append(it.next());
+
+   mWatcher->addPaths(paths);
+}
+
+void GitRepoWatcher::watchWorkingTree()
+{
+   mWatcher->addPath(mWorkingDir);
+
+   // The directories that have tracked files are never ignored.
+   mListFuture = listPaths("git ls-files -z", [this](const QStringList &files) { onTrackedFilesListed(files); });
+}
+
+void GitRepoWatcher::onTrackedFilesListed(const QStringList &files)
+{
+   auto directories = watchedDirectories();
+   QStringList paths;
+
+   for (const auto &file : files)
+   {
+      auto separator = file.lastIndexOf('/');
+
+      while (separator > 0)
+      {
+         const auto directory = mWorkingDir + '/' + file.left(separator);
+
+         if (directories.contains(directory))
+            break;
+
+         directories.insert(directory);
+         paths.append(directory);
+         separator = file.lastIndexOf('/', separator - 1);
+      }
+   }
+
+   if (!paths.isEmpty())
+      mWatcher->addPaths(paths);
+
+   // The untracked directories are collapsed by git, but they can still have ignored subdirectories.
+   const auto cmd = QString("git ls-files -z --others --exclude-standard --directory");
+
+   mListFuture = listPaths(cmd, [this](const QStringList &entries) {
+      QStringList untrackedDirs;
+
+      for (const auto &entry : entries)
+      {
+         if (entry.endsWith('/'))
+            untrackedDirs.append(entry.left(entry.size() - 1));
+      }
+
+      mListFuture.reset();
+
+      watchDirectories(untrackedDirs);
+   });
+}
+
+void GitRepoWatcher::watchDirectories(const QStringList &directories)
+{
+   mPendingDirectories.append(directories);
+
+   if (!mCheckIgnoreFuture)
+      checkPendingDirectories();
+}
+
+void GitRepoWatcher::checkPendingDirectories()
+{
+   if (mPendingDirectories.isEmpty())
+      return;
+
+   // The queue is checked in order, so the content of an ignored directory is never listed.
+   const auto directories = mPendingDirectories.mid(0, CHECK_IGNORE_BATCH_SIZE);
+   mPendingDirectories.erase(mPendingDirectories.begin(), mPendingDirectories.begin() + directories.count());
+
+   auto cmd = QString("git check-ignore -z --");
+
+   for (const auto &directory : directories)
+      cmd.append(QString(" $%1$").arg(directory));
+
+   mCheckIgnoreFuture = listPaths(cmd, [this, directories](const QStringList &ignoredDirectories) {
+      QSet<QString> ignored;
+
+      for (const auto &directory : ignoredDirectories)
+         ignored.insert(directory);
+
+      auto watched = watchedDirectories();
+      QStringList paths;
+
+      for (const auto &directory : directories)
+      {
+         const auto path = mWorkingDir + '/' + directory;
+
+         if (!ignored.contains(directory) && !watched.contains(path))
+         {
+            watched.insert(path);
+            paths.append(path);
+            mPendingDirectories.append(subdirectories(directory, watched));
+         }
+      }
+
+      if (!paths.isEmpty())
+      {
+         const auto failed = mWatcher->addPaths(paths);
+
+         if (!failed.isEmpty())
+            QLog_Warning("Git", QString("Unable to watch {%1} directories. The system limit might have been reached.")
+                                    .arg(failed.count()));
+      }
+
+      mCheckIgnoreFuture.reset();
+
+      checkPendingDirectories();
+   });
+}
+
+QSharedPointer<GitFuture> GitRepoWatcher::listPaths(const QString &cmd,
+                                                    const std::function<void(const QStringList &)> &onListed)
+{
+   GitCommandTrace::Scope scope("Watcher");
+
+   const auto generation = mGeneration;
+   const auto output = QSharedPointer<QByteArray>::create();
+   const auto future = mGit->runAsync(cmd, GitFuture::Priority::Background, false);
+
+   // The QString result stops at the first NUL, so the paths are split from the raw output.
+   connect(future.data(), &GitFuture::signalOutputReady, this,
+           [output](const QByteArray &chunk) { output->append(chunk); });
+
+   future->then(this, [this, generation, output, onListed](const GitExecResult &result) {
+      if (generation != mGeneration)
+         return;
+
+      QStringList paths;
+
+      if (result.success)
+      {
+         for (const auto &path : output->split('\0'))
+         {
+            if (!path.isEmpty())
+               paths.append(QString::fromUtf8(path));
+         }
+      }
+
+      onListed(paths);
+   });
+
+   return future;
+}
+
+QStringList GitRepoWatcher::subdirectories(const QString &directory, const QSet<QString> &watched) const
+{
+   QStringList subdirs;
+   const auto entries = QDir(mWorkingDir + '/' + directory)
+                            .entryList(QDir::Dirs | QDir::NoDotAndDotDot | QDir::Hidden | QDir::NoSymLinks);
+
+   for (const auto &entry : entries)
+   {
+      const auto subdir = directory.isEmpty() ? entry : directory + '/' + entry;
+
+      if (entry != ".git" && !watched.contains(mWorkingDir + '/' + subdir))
+         subdirs.append(subdir);
+   }
+
+   return subdirs;
+}
+
+QSet<QString> GitRepoWatcher::watchedDirectories() const
+{
+   QSet<QString> watched;
+
+   for (const auto &directory : mWatcher->directories())
+      watched.insert(directory);
+
+   return watched;
+}
+
+int GitRepoWatcher::checkGitFiles()
+{
+   auto changes = 0;
+
+   for (auto it = mGitFilesModified.begin(); it != mGitFilesModified.end(); ++it)
+   {
+      const auto modified = lastModified(it.key());
+
+      if (modified != it.value())
+      {
+         it.value() = modified;
+         changes |= it.key() == mGitDir + "/index" ? WorkingTree : References;
+      }
+   }
+
+   return changes;
+}
+
+void GitRepoWatcher::onDirectoryChanged(const QString &path)
+{
+   if (path == mGitDir || path == mCommonDir)
+   {
+      // Most of the changes here are lock and temporary files that don't need any update.
+      const auto changes = checkGitFiles();
+
+      if (changes != 0)
+         addChange(changes);
+   }
+   else if (path.startsWith(mCommonDir + "/refs"))
+   {
+      const auto watched = watchedDirectories();
+      QDirIterator it(path, QDir::Dirs | QDir::NoDotAndDotDot, QDirIterator::Subdirectories);
+
+      while (it.hasNext())
+      {
+         const auto directory = it.next();
+
+         if (!watched.contains(directory))
+            mWatcher->addPath(directory);
+      }
+
+      addChange(References);
+   }
+   else
+   {
+      mChangedDirectories.insert(path);
+      addChange(WorkingTree);
+   }
+}
+
+void GitRepoWatcher::addChange(int change)
+{
+   if (mPendingChanges == 0)
+      mPendingSince.start();
+
+   mPendingChanges |= change;
+
+   // The notification is postponed while the events keep coming, but not beyond the maximum delay.
+   if (!mDebounceTimer.isActive() || mPendingSince.elapsed() < MAX_DELAY_MS)
+      mDebounceTimer.start();
+}
+
+void GitRepoWatcher::notifyChanges()
+{
+   GitCommandTrace::Scope scope("Watcher");
+
+   const auto changes = mPendingChanges;
+   mPendingChanges = 0;
+
+   if (!mChangedDirectories.isEmpty())
+   {
+      const QDir workingDir(mWorkingDir);
+      const auto watched = watchedDirectories();
+      QStringList newDirectories;
+
+      for (const auto &path : qAsConst(mChangedDirectories))
+      {
+         const auto directory = path == mWorkingDir ? QString() : workingDir.relativeFilePath(path);
+         newDirectories.append(subdirectories(directory, watched));
+      }
+
+      mChangedDirectories.clear();
+
+      watchDirectories(newDirectories);
+   }
+
+   if (changes & References)
+      emit signalReferencesChanged();
+   else if (changes & WorkingTree)
+      emit signalWorkingTreeChanged();
+}
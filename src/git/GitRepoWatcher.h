@@ -0,0 +1,120 @@
+#pragma once
+
+#pragma once
+
+/****************************************************************************************
+ ** GitQlient is an application to manage and operate one or several Git repositories. With
+ ** GitQlient you will be able to add commits, branches and manage all the options Git provides.
+ ** Copyright (C) 2020  Francesc Martinez
+ **
+ ** LinkedIn: www.linkedin.com/in/cescmm/
+ ** Web: www.francescmm.com
+ **
+ ** This program is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public
+ ** License as published by the Free Software Foundation; either
+ ** version 2 of the License, or (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this library; if not, write to the Free Software
+ ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ***************************************************************************************/
+
+#include <QElapsedTimer>
+#include <QHash>
+#include <QObject>
+#include <QSet>
+#include <QSharedPointer>
+#include <QTimer>
+
+#include <functional>
+
+class GitBase;
+class GitFuture;
+class QFileSystemWatcher;
+
+/**
+ * @brief The GitRepoWatcher class detects the changes done to a repository from outside GitQlient. The git directory
+ * and the working tree are watched separately: HEAD, the packed references and the references directories tell that
+ * the history changed, while the index and the working tree only affect the WIP. Only the working tree directories
+ * that git doesn't ignore are watched: git lists them in the background, so watching a big tree doesn't block the
+ * GUI. The events are coalesced so a burst of changes (i.e. a build or a checkout)
+ * produces a single notification.
+ *
+ * @class GitRepoWatcher GitRepoWatcher.h "GitRepoWatcher.h"
+ */
+class GitRepoWatcher : public QObject
+{
+   Q_OBJECT
+
+signals:
+   /**
+    * @brief Signal triggered when HEAD or any reference has changed. The WIP changes, if any, are included.
+    */
+   void signalReferencesChanged();
+   /**
+    * @brief Signal triggered when only the working tree or the index have changed.
+    */
+   void signalWorkingTreeChanged();
+
+public:
+   explicit GitRepoWatcher(const QSharedPointer<GitBase> &git, QObject *parent = nullptr);
+
+   /**
+    * @brief Starts watching the repository of the current working directory. Any previous repository is discarded.
+    */
+   void start();
+   /**
+    * @brief Stops watching and discards the changes that weren't notified yet.
+    */
+   void stop();
+
+private:
+   enum Change
+   {
+      WorkingTree = 1,
+      References = 2
+   };
+
+   QSharedPointer<GitBase> mGit;
+   QFileSystemWatcher *mWatcher = nullptr;
+   QTimer mDebounceTimer;
+   QElapsedTimer mPendingSince;
+   int mPendingChanges = 0;
+   QString mWorkingDir;
+   QString mGitDir;
+   QString mCommonDir;
+   QHash<QString, qint64> mGitFilesModified;
+   QSet<QString> mChangedDirectories;
+   int mGeneration = 0;
+   QSharedPointer<GitFuture> mListFuture;
+   QSharedPointer<GitFuture> mCheckIgnoreFuture;
+   QStringList mPendingDirectories;
+
+   void watchReferences();
+   void watchWorkingTree();
+   void onTrackedFilesListed(const QStringList &files);
+   /**
+    * @brief Queues directories to be watched if git doesn't ignore them. Their subdirectories are checked after them.
+    */
+   void watchDirectories(const QStringList &directories);
+   void checkPendingDirectories();
+   /**
+    * @brief Runs a git command that lists paths separated by NULs and calls @p onListed with them. The output is
+    * split from the raw bytes. Nothing is called if the watcher is stopped before the command finishes.
+    *
+    * @return QSharedPointer<GitFuture> The running command.
+    */
+   QSharedPointer<GitFuture> listPaths(const QString &cmd, const std::function<void(const QStringList &)> &onListed);
+   QStringList subdirectories(const QString &directory, const QSet<QString> &watched) const;
+   QSet<QString> watchedDirectories() const;
+   int checkGitFiles();
+   void onDirectoryChanged(const QString &path);
+   void addChange(int change);
+   void notifyChanges();
+};
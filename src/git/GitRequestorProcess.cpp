@@ -1,6 +1,5 @@
 #include "GitRequestorProcess.h"
 
-#include <QTemporaryFile>
 GitRequestorProcess::GitRequestorProcess(const QString &workingDir)
    : AGitProcess(workingDir)
 {
@@ -8,33 +7,25 @@ GitRequestorProcess::GitRequestorProcess(const QString &workingDir)
 
 GitExecResult GitRequestorProcess::run(const QString &command)
 {
-   auto ret = false;
-
-   // Create temporary file
-   mTempFile = new QTemporaryFile(this);
-
-   if (mTempFile->open()) // to read the file name
-   {
-      setStandardOutputFile(mTempFile->fileName());
-      mTempFile->close();
+   return { execute(command), "" };
+}
 
-      ret = execute(command);
-   }
+void GitRequestorProcess::onReadyStandardOutput()
+{
+   // The output can be hundreds of MB, so it's not accumulated: the receiver is the one that owns the data.
+   const auto chunk = readAllStandardOutput();
+   mBytesRead += chunk.size();
 
-   return { ret, "" };
+   if (!mCanceling && !chunk.isEmpty())
+      emit procDataReady(chunk);
 }
 
 void GitRequestorProcess::onFinished(int, QProcess::ExitStatus)
 {
-   bool ok = mTempFile && (mTempFile->isOpen() || (mTempFile->exists() && mTempFile->open()));
-
-   if (ok)
-   {
-      const auto ba = mTempFile->readAll();
+   onReadyStandardOutput();
 
-      if (ba.size() != 0 && !mCanceling)
-         emit procDataReady(ba);
-   }
+   if (!mCanceling)
+      emit signalProcessFinished();
 
    deleteLater();
 }
@@ -25,19 +25,26 @@
 
 #include <AGitProcess.h>
 
-class QTemporaryFile;
-
+/**
+ * @brief The GitRequestorProcess runs long git commands (i.e. git log) and streams their output as it is produced. The
+ * data is emitted in raw chunks through @ref procDataReady so the receiver can start processing it before the process
+ * has finished.
+ */
 class GitRequestorProcess : public AGitProcess
 {
    Q_OBJECT
 
+signals:
+   /**
+    * @brief Signal triggered when the process has finished and all the data has been emitted.
+    */
+   void signalProcessFinished();
+
 public:
    explicit GitRequestorProcess(const QString &workingDir);
    GitExecResult run(const QString &command) override;
 
 private:
+   void onReadyStandardOutput() override;
    void onFinished(int, QProcess::ExitStatus exitStatus) override;
-
-private:
-   QTemporaryFile *mTempFile = nullptr;
 };
@@ -0,0 +1,162 @@
+#include "GitStatusParser.h"
+
+#include <cstring>
+
+namespace
+{
+const QByteArray HEAD_SHA_HEADER("# branch.oid ");
+
+/**
+ * @brief Returns the position after the @p field -th space of the record, where the next field starts, or -1.
+ */
+int fieldStart(const char *record, int size, int field)
+{
+   auto pos = 0;
+
+   for (auto spaces = 0; spaces < field; ++spaces)
+   {
+      const auto separator = static_cast<const char *>(memchr(record + pos, ' ', static_cast<size_t>(size - pos)));
+
+      if (!separator)
+         return -1;
+
+      pos = static_cast<int>(separator - record) + 1;
+   }
+
+   return pos;
+}
+}
+
+const QString GitStatusParser::COMMAND(
+    "git status --porcelain=v2 -z --branch --untracked-files=all --no-renames");
+
+void GitStatusParser::reset()
+{
+   mPendingData.clear();
+   mHeadSha.clear();
+   mFiles = RevisionFiles();
+   mUntrackedFiles.clear();
+   mSkipNextRecord = false;
+}
+
+void GitStatusParser::processChunk(const QByteArray &chunk)
+{
+   mPendingData.append(chunk);
+
+   const auto lastSeparator = mPendingData.lastIndexOf('\000');
+
+   if (lastSeparator == -1)
+      return;
+
+   const auto data = mPendingData.constData();
+   auto recordStart = 0;
+
+   while (recordStart <= lastSeparator)
+   {
+      const auto recordEnd = mPendingData.indexOf('\000', recordStart);
+
+      parseRecord(data + recordStart, recordEnd - recordStart);
+
+      recordStart = recordEnd + 1;
+   }
+
+   mPendingData.remove(0, recordStart);
+}
+
+void GitStatusParser::finish()
+{
+   if (!mPendingData.isEmpty())
+      parseRecord(mPendingData.constData(), mPendingData.size());
+
+   mPendingData.clear();
+}
+
+RevisionFiles GitStatusParser::files() const
+{
+   auto rf = mFiles;
+   rf.setOnlyModified(false);
+
+   for (const auto &file : mUntrackedFiles)
+   {
+      rf.appendFile(file);
+      rf.setStatus(RevisionFiles::UNKNOWN);
+      rf.mergeParent.append(1);
+   }
+
+   return rf;
+}
+
+void GitStatusParser::parseRecord(const char *record, int size)
+{
+   if (mSkipNextRecord)
+   {
+      // The original path of a rename or copy comes in its own record.
+      mSkipNextRecord = false;
+      return;
+   }
+
+   if (size < 2)
+      return;
+
+   switch (record[0])
+   {
+      case '#':
+         if (size > HEAD_SHA_HEADER.size()
+             && qstrncmp(record, HEAD_SHA_HEADER.constData(), static_cast<uint>(HEAD_SHA_HEADER.size())) == 0)
+         {
+            const auto sha = QString::fromLatin1(record + HEAD_SHA_HEADER.size(), size - HEAD_SHA_HEADER.size());
+
+            // A repository without commits reports "(initial)".
+            mHeadSha = sha.startsWith('(') ? QString() : sha;
+         }
+         break;
+      case '1':
+         appendChangedFile(record, size, 8);
+         break;
+      case '2':
+         appendChangedFile(record, size, 9);
+         mSkipNextRecord = true;
+         break;
+      case 'u':
+         appendChangedFile(record, size, 10);
+         break;
+      case '?':
+         mUntrackedFiles.append(QString::fromUtf8(record + 2, size - 2));
+         break;
+      default:
+         break;
+   }
+}
+
+void GitStatusParser::appendChangedFile(const char *record, int size, int pathField)
+{
+   const auto pathStart = fieldStart(record, size, pathField);
+
+   if (pathStart == -1 || size < 4)
+      return;
+
+   // The XY field holds the status of the file in the index (X) and in the working tree (Y) against HEAD.
+   const auto indexStatus = record[2];
+   const auto workTreeStatus = record[3];
+   const auto pos = mFiles.count();
+
+   mFiles.appendFile(QString::fromUtf8(record + pathStart, size - pathStart));
+   mFiles.mergeParent.append(1);
+
+   if (record[0] == 'u')
+   {
+      mFiles.setStatus(QString("U"));
+      mFiles.appendStatus(pos, RevisionFiles::IN_INDEX);
+      return;
+   }
+
+   if (indexStatus == 'A')
+      mFiles.setStatus(RevisionFiles::NEW);
+   else if (indexStatus == 'D' || workTreeStatus == 'D')
+      mFiles.setStatus(RevisionFiles::DELETED);
+   else
+      mFiles.setStatus(RevisionFiles::MODIFIED);
+
+   if (indexStatus != '.')
+      mFiles.appendStatus(pos, RevisionFiles::IN_INDEX);
+}
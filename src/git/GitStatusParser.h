@@ -0,0 +1,88 @@
+#pragma once
+
+#pragma once
+
+/****************************************************************************************
+ ** GitQlient is an application to manage and operate one or several Git repositories. With
+ ** GitQlient you will be able to add commits, branches and manage all the options Git provides.
+ ** Copyright (C) 2020  Francesc Martinez
+ **
+ ** LinkedIn: www.linkedin.com/in/cescmm/
+ ** Web: www.francescmm.com
+ **
+ ** This program is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public
+ ** License as published by the Free Software Foundation; either
+ ** version 2 of the License, or (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this library; if not, write to the Free Software
+ ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ***************************************************************************************/
+
+#include <RevisionFiles.h>
+
+#include <QByteArray>
+#include <QString>
+#include <QVector>
+
+/**
+ * @brief The GitStatusParser class reads the output of git status --porcelain=v2 -z and builds the files of the WIP
+ * commit from it. A single status run gives the HEAD SHA, the changes against HEAD, the changes in the index and the
+ * untracked files, so it replaces the several commands that were needed before. The data can be fed in chunks while the
+ * process is still running.
+ *
+ * @class GitStatusParser GitStatusParser.h "GitStatusParser.h"
+ */
+class GitStatusParser
+{
+public:
+   /**
+    * @brief The command whose output the parser understands. Renames are disabled so the files are listed the same
+    * way git diff-index does.
+    */
+   static const QString COMMAND;
+
+   /**
+    * @brief Discards any data from a previous run.
+    */
+   void reset();
+   /**
+    * @brief Parses all the complete records of a chunk. The incomplete tail is kept until the next chunk arrives.
+    *
+    * @param chunk The raw data as it was read from the git process.
+    */
+   void processChunk(const QByteArray &chunk);
+   /**
+    * @brief Parses the remaining data once the git process has finished.
+    */
+   void finish();
+
+   /**
+    * @brief Returns the SHA of HEAD. It is empty if the repository has no commits yet or git status failed.
+    */
+   QString headSha() const { return mHeadSha; }
+   /**
+    * @brief Returns the files of the WIP: first the ones that changed against HEAD and then the untracked ones.
+    */
+   RevisionFiles files() const;
+   /**
+    * @brief Returns the untracked files.
+    */
+   QVector<QString> untrackedFiles() const { return mUntrackedFiles; }
+
+private:
+   QByteArray mPendingData;
+   QString mHeadSha;
+   RevisionFiles mFiles;
+   QVector<QString> mUntrackedFiles;
+   bool mSkipNextRecord = false;
+
+   void parseRecord(const char *record, int size);
+   void appendChangedFile(const char *record, int size, int pathField);
+};
@@ -0,0 +1,81 @@
+#include "CommitFilesPrefetcher.h"
+
+#include <CommitInfo.h>
+#include <GitBase.h>
+#include <RevisionsCache.h>
+
+#include <QTimer>
+
+#include <QLogger.h>
+
+using namespace QLogger;
+
+namespace
+{
+// Time to wait for the user to stop scrolling before fetching.
+const auto PREFETCH_DELAY_MS = 150;
+}
+
+CommitFilesPrefetcher::CommitFilesPrefetcher(const QSharedPointer<RevisionsCache> &cache,
+                                             const QSharedPointer<GitBase> &git, QObject *parent)
+   : QObject(parent)
+   , mCache(cache)
+   , mGit(git)
+   , mDelayTimer(new QTimer(this))
+{
+   mDelayTimer->setSingleShot(true);
+   mDelayTimer->setInterval(PREFETCH_DELAY_MS);
+
+   connect(mDelayTimer, &QTimer::timeout, this, &CommitFilesPrefetcher::queueRequests);
+}
+
+CommitFilesPrefetcher::~CommitFilesPrefetcher()
+{
+   cancel();
+}
+
+void CommitFilesPrefetcher::prefetch(const QStringList &shas)
+{
+   mPendingShas = shas;
+   mDelayTimer->start();
+}
+
+void CommitFilesPrefetcher::cancel()
+{
+   mDelayTimer->stop();
+   mPendingShas.clear();
+   mGit->diffTree()->cancel(this);
+}
+
+void CommitFilesPrefetcher::queueRequests()
+{
+   const auto diffTree = mGit->diffTree();
+   auto queued = 0;
+
+   diffTree->cancel(this);
+
+   for (const auto &sha : qAsConst(mPendingShas))
+   {
+      if (sha.isEmpty() || sha == CommitInfo::ZERO_SHA)
+         continue;
+
+      const auto commit = mCache->getCommitInfo(sha);
+
+      if (commit.parentsCount() == 0 || mCache->containsRevisionFile(sha, commit.parent(0)))
+         continue;
+
+      const auto parentSha = commit.parent(0);
+
+      diffTree->request(sha, parentSha, this, [this, sha, parentSha](const RevisionFiles &files) {
+         if (!mCache->containsRevisionFile(sha, parentSha))
+            mCache->insertRevisionFile(sha, parentSha, files);
+      });
+
+      ++queued;
+   }
+
+   mPendingShas.clear();
+
+   if (queued > 0)
+      QLog_Debug("Git", QString("Prefetching the files of {%1} commits.").arg(queued));
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+/****************************************************************************************
+ ** GitQlient is an application to manage and operate one or several Git repositories. With
+ ** GitQlient you will be able to add commits, branches and manage all the options Git provides.
+ ** Copyright (C) 2020  Francesc Martinez
+ **
+ ** LinkedIn: www.linkedin.com/in/cescmm/
+ ** Web: www.francescmm.com
+ **
+ ** This program is free software; you can redistribute it and/or
+ ** modify it under the terms of the GNU Lesser General Public
+ ** License as published by the Free Software Foundation; either
+ ** version 2 of the License, or (at your option) any later version.
+ **
+ ** This program is distributed in the hope that it will be useful,
+ ** but WITHOUT ANY WARRANTY; without even the implied warranty of
+ ** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ ** Lesser General Public License for more details.
+ **
+ ** You should have received a copy of the GNU Lesser General Public
+ ** License along with this library; if not, write to the Free Software
+ ** Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ ***************************************************************************************/
+
+#include <QObject>
+#include <QSharedPointer>
+#include <QStringList>
+
+class GitBase;
+class RevisionsCache;
+class QTimer;
+
+/**
+ * @brief The CommitFilesPrefetcher class loads in the background the files of the commits the user is about to see in
+ * the history view, so they are already in the @ref RevisionsCache when a commit is selected and the files list
+ * doesn't need to run git. The commits that are not cached are queued in the @ref GitDiffTreeService of the
+ * repository, so moving through the history doesn't start a process per commit.
+ *
+ * The requests are delayed a bit so scrolling quickly only fetches the commits where the user stops. A new request
+ * discards the commits of the previous one that git didn't start to list yet.
+ *
+ * @class CommitFilesPrefetcher CommitFilesPrefetcher.h "CommitFilesPrefetcher.h"
+ */
+class CommitFilesPrefetcher : public QObject
+{
+   Q_OBJECT
+
+public:
+   /**
+    * @brief Default constructor.
+    *
+    * @param cache The cache where the files are stored.
+    * @param git The git object of the repository.
+    * @param parent The parent object.
+    */
+   explicit CommitFilesPrefetcher(const QSharedPointer<RevisionsCache> &cache, const QSharedPointer<GitBase> &git,
+                                  QObject *parent = nullptr);
+   /**
+    * @brief Destructor. Discards the pending requests.
+    */
+   ~CommitFilesPrefetcher() override;
+
+   /**
+    * @brief Requests the files of the given commits, compared to their first parent. It replaces the previous request.
+    *
+    * @param shas The SHAs of the commits, the most urgent first.
+    */
+   void prefetch(const QStringList &shas);
+   /**
+    * @brief Discards the pending requests.
+    */
+   void cancel();
+
+private:
+   QSharedPointer<RevisionsCache> mCache;
+   QSharedPointer<GitBase> mGit;
+   QTimer *mDelayTimer = nullptr;
+   QStringList mPendingShas;
+
+   /**
+    * @brief Queues the commits of the pending request that are not cached yet.
+    */
+   void queueRequests();
+};
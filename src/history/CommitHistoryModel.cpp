@@ -23,7 +23,7 @@ CommitHistoryModel::CommitHistoryModel(const QSharedPointer<RevisionsCache> &cac
 
 int CommitHistoryModel::rowCount(const QModelIndex &parent) const
 {
-   return !parent.isValid() ? mCache->count() : 0;
+   return !parent.isValid() ? mRowCount : 0;
 }
 
 bool CommitHistoryModel::hasChildren(const QModelIndex &parent) const
@@ -39,6 +39,7 @@ QString CommitHistoryModel::sha(int row) const
 void CommitHistoryModel::clear()
 {
    beginResetModel();
+   mRowCount = 0;
    endResetModel();
    emit headerDataChanged(Qt::Horizontal, 0, 5);
 }
@@ -46,10 +47,33 @@ void CommitHistoryModel::clear()
 void CommitHistoryModel::onNewRevisions(int totalCommits)
 {
    beginResetModel();
+   mRowCount = totalCommits;
    endResetModel();
+}
+
+void CommitHistoryModel::onRevisionsLoaded(int totalCommits)
+{
+   if (totalCommits > mRowCount)
+   {
+      beginInsertRows(QModelIndex(), mRowCount, totalCommits - 1);
+      mRowCount = totalCommits;
+      endInsertRows();
+   }
+}
+
+void CommitHistoryModel::onRevisionsInserted(int insertedCommits, int updatedCommits)
+{
+   if (insertedCommits > 0)
+   {
+      beginInsertRows(QModelIndex(), 1, insertedCommits);
+      mRowCount += insertedCommits;
+      endInsertRows();
+   }
+
+   // The WIP is always updated since its parent could be a new commit.
+   const auto lastUpdatedRow = std::min(insertedCommits + updatedCommits, mRowCount - 1);
 
-   beginInsertRows(QModelIndex(), 0, totalCommits - 2);
-   endInsertRows();
+   emit dataChanged(index(0, 0), index(lastUpdatedRow, columnCount() - 1));
 }
 
 QVariant CommitHistoryModel::headerData(int section, Qt::Orientation orientation, int role) const
@@ -62,7 +86,7 @@ QVariant CommitHistoryModel::headerData(int section, Qt::Orientation orientation
 
 QModelIndex CommitHistoryModel::index(int row, int column, const QModelIndex &) const
 {
-   return row >= 0 && row < mCache->count() ? createIndex(row, column, nullptr) : QModelIndex();
+   return row >= 0 && row < mRowCount ? createIndex(row, column, nullptr) : QModelIndex();
 }
 
 QModelIndex CommitHistoryModel::parent(const QModelIndex &) const
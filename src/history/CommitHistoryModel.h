@@ -124,6 +124,20 @@ public:
     * @param totalCommits The total of new revisions.
     */
    void onNewRevisions(int totalCommits);
+   /**
+    * @brief Appends the rows of a new batch of revisions that has been loaded in the cache without resetting the model.
+    *
+    * @param totalCommits The total of revisions loaded so far.
+    */
+   void onRevisionsLoaded(int totalCommits);
+   /**
+    * @brief Inserts the rows of the commits added on top of the history (after the WIP) and updates the rows whose
+    * graph changed.
+    *
+    * @param insertedCommits The number of new commits.
+    * @param updatedCommits The number of commits below the new ones whose lanes changed.
+    */
+   void onRevisionsInserted(int insertedCommits, int updatedCommits);
    /*!
     * \brief Gets the number of columns in the model.
     * \return The number of columns.
@@ -133,6 +147,7 @@ public:
 private:
    QSharedPointer<RevisionsCache> mCache;
    QSharedPointer<GitBase> mGit;
+   int mRowCount = 0;
 
    /**
     * @brief Returns the tool tip data.
@@ -3,22 +3,31 @@
 #include <CommitHistoryModel.h>
 #include <CommitHistoryColumns.h>
 #include <CommitHistoryContextMenu.h>
+#include <CommitFilesPrefetcher.h>
 #include <ShaFilterProxyModel.h>
 #include <CommitInfo.h>
 #include <RevisionsCache.h>
 
 #include <QHeaderView>
+#include <QScrollBar>
 #include <QSettings>
 #include <QDateTime>
 
 #include <QLogger.h>
 using namespace QLogger;
 
+namespace
+{
+// Number of commits before and after the selected one whose files are prefetched.
+const auto PREFETCH_DISTANCE = 10;
+}
+
 CommitHistoryView::CommitHistoryView(const QSharedPointer<RevisionsCache> &cache, const QSharedPointer<GitBase> &git,
                                      QWidget *parent)
    : QTreeView(parent)
    , mCache(cache)
    , mGit(git)
+   , mFilesPrefetcher(new CommitFilesPrefetcher(cache, git, this))
 {
    setEnabled(false);
    setContextMenuPolicy(Qt::CustomContextMenu);
@@ -30,6 +39,7 @@ CommitHistoryView::CommitHistoryView(const QSharedPointer<RevisionsCache> &cache
    header()->setSortIndicatorShown(false);
 
    connect(header(), &QHeaderView::sectionResized, this, &CommitHistoryView::saveHeaderState);
+   connect(verticalScrollBar(), &QScrollBar::valueChanged, this, &CommitHistoryView::prefetchFiles);
 }
 
 void CommitHistoryView::setModel(QAbstractItemModel *model)
@@ -107,10 +117,50 @@ void CommitHistoryView::setupGeometry()
 void CommitHistoryView::currentChanged(const QModelIndex &index, const QModelIndex &)
 {
    mCurrentSha = model()->index(index.row(), static_cast<int>(CommitHistoryColumns::SHA)).data().toString();
+
+   prefetchFiles();
+}
+
+void CommitHistoryView::prefetchFiles()
+{
+   if (!model() || model()->rowCount() == 0)
+      return;
+
+   const auto rowCount = model()->rowCount();
+   const auto currentRow = currentIndex().isValid() ? currentIndex().row() : -1;
+   const auto firstVisible = indexAt(viewport()->rect().topLeft()).row();
+   const auto lastVisible = indexAt(viewport()->rect().bottomLeft()).row();
+   QStringList shas;
+
+   const auto appendRow = [this, rowCount, &shas](int row) {
+      if (row >= 0 && row < rowCount)
+         shas.append(model()->index(row, static_cast<int>(CommitHistoryColumns::SHA)).data().toString());
+   };
+
+   // The commits next to the selected one go first since the user usually moves with the arrow keys.
+   if (currentRow != -1)
+   {
+      for (auto distance = 1; distance <= PREFETCH_DISTANCE; ++distance)
+      {
+         appendRow(currentRow + distance);
+         appendRow(currentRow - distance);
+      }
+   }
+
+   if (firstVisible != -1)
+   {
+      const auto last = lastVisible != -1 ? lastVisible : rowCount - 1;
+
+      for (auto row = firstVisible; row <= last; ++row)
+         appendRow(row);
+   }
+
+   mFilesPrefetcher->prefetch(shas);
 }
 
 void CommitHistoryView::clear()
 {
+   mFilesPrefetcher->cancel();
    mCommitHistoryModel->clear();
 }
 
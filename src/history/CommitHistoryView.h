@@ -29,6 +29,7 @@ class RevisionsCache;
 class GitBase;
 class CommitHistoryModel;
 class ShaFilterProxyModel;
+class CommitFilesPrefetcher;
 
 /**
  * @brief The CommitHistoryView is the class that represents the View in a MVC pattern. It shows the data provided by
@@ -157,6 +158,7 @@ private:
    ShaFilterProxyModel *mProxyModel = nullptr;
    bool mIsFiltering = false;
    QString mCurrentSha;
+   CommitFilesPrefetcher *mFilesPrefetcher = nullptr;
 
    /**
     * @brief Shows the context menu for the CommitHistoryView.
@@ -182,4 +184,9 @@ private:
     * @param parent The parent of the index. Not used.
     */
    void currentChanged(const QModelIndex &index, const QModelIndex &parent) override;
+   /**
+    * @brief Requests the files of the commits around the selected one and the ones that are visible, so they are
+    * already loaded when the user moves to them.
+    */
+   void prefetchFiles();
 };
@@ -1,6 +1,7 @@
 INCLUDEPATH += $$PWD
 
 HEADERS += \
+    $$PWD/CommitFilesPrefetcher.h \
     $$PWD/CommitHistoryColumns.h \
     $$PWD/CommitHistoryContextMenu.h \
     $$PWD/CommitHistoryModel.h \
@@ -9,6 +10,7 @@ HEADERS += \
     $$PWD/ShaFilterProxyModel.h
 
 SOURCES += \
+    $$PWD/CommitFilesPrefetcher.cpp \
     $$PWD/CommitHistoryContextMenu.cpp \
     $$PWD/CommitHistoryModel.cpp \
     $$PWD/CommitHistoryView.cpp \
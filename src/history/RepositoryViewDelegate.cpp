@@ -339,7 +339,7 @@ void RepositoryViewDelegate::paintTagBranch(QPainter *painter, QStyleOptionViewI
 
    if ((currentBranch.isEmpty() || currentBranch == "HEAD"))
    {
-      if (const auto ret = mGit->getLastCommit(); ret.success && commit.sha() == ret.output.toString().trimmed())
+      if (const auto headSha = mGit->getLastCommitSha(); !headSha.isEmpty() && commit.sha() == headSha)
          markValues.insert("detached", GitQlientStyles::getDetachedColor());
    }
 